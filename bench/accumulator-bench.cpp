@@ -0,0 +1,136 @@
+/**
+ * @file accumulator-bench.cpp
+ *
+ * Runtime benchmark of LibUnit accumulators.
+ *
+ * Sums a vector of small powers of random magnitude using naive `operator+=`
+ * in `double` and `long double`, and using `NeumaierSum`, `PairwiseSum` and
+ * `MultiLaneSum`. Then sums a stream of interleaved powers in watts,
+ * kilowatts and megawatts using `operator+=`, which converts every value, and
+ * using `MultiUnitSum`. Reports relative error of each sum, compared with a sum
+ * computed by `NeumaierSum` in `long double`, and gigabytes of input read per
+ * second.
+ *
+ * Usage: accumulator-bench [size] [repetitions]
+ */
+
+#include "accumulator.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+namespace{
+
+using namespace LibUnit;
+
+template <typename F>
+void measure(const char* name, long size, long repetitions, long double reference, F f){
+    double sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long r=0; r<repetitions; r++)
+        sum = f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double error = std::fabs(static_cast<double>((sum - reference) / reference));
+    std::cout << std::setw(24) << name << std::setw(16) << error
+              << size * repetitions * sizeof(double) / t / 1e9 << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long size = argc > 1 ? std::atol(argv[1]) : 1 << 24;
+    long repetitions = argc > 2 ? std::atol(argv[2]) : 20;
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> mantissa(1, 10);
+    std::uniform_int_distribution<int> exponent(-6, 0);
+    QuantityVector<Watt> powers(size);
+    for (long i=0; i<size; i++)
+        powers.set(i, Quantity<Watt>(mantissa(random) * std::pow(10.0, exponent(random))));
+
+    NeumaierSum<Watt, long double> exact;
+    exact.add(powers);
+    long double reference = exact.value().value();
+
+    std::cout << std::left << std::setw(24) << "accumulator" << std::setw(16) << "relative error" << "GB/s" << std::endl;
+    measure("double +=", size, repetitions, reference, [&](){
+        Quantity<Watt> sum(0);
+        for (long i=0; i<size; i++)
+            sum += powers[i];
+        return sum.value();
+    });
+    measure("long double +=", size, repetitions, reference, [&](){
+        Quantity<Watt, long double> sum(0);
+        for (long i=0; i<size; i++)
+            sum += powers[i];
+        return static_cast<double>(sum.value());
+    });
+    measure("NeumaierSum", size, repetitions, reference, [&](){
+        NeumaierSum<Watt> sum;
+        sum.add(powers);
+        return sum.value().value();
+    });
+    measure("PairwiseSum", size, repetitions, reference, [&](){
+        PairwiseSum<Watt> sum;
+        sum.add(powers);
+        return sum.value().value();
+    });
+    measure("MultiLaneSum", size, repetitions, reference, [&](){
+        MultiLaneSum<Watt> sum;
+        sum.add(powers);
+        return sum.value().value();
+    });
+    measure("MultiLaneSum, kW", size, repetitions, reference, [&](){
+        MultiLaneSum<Kilo<Watt>> sum;
+        sum.add(powers);
+        return Quantity<Watt>(sum.value()).value();
+    });
+
+    long third = size / 3;
+    QuantityVector<Watt> watts(third);
+    QuantityVector<Kilo<Watt>> kilowatts(third);
+    QuantityVector<Mega<Watt>> megawatts(third);
+    for (long i=0; i<third; i++){
+        watts.set(i, Quantity<Watt>(mantissa(random) * 100));
+        kilowatts.set(i, Quantity<Kilo<Watt>>(mantissa(random)));
+        megawatts.set(i, Quantity<Mega<Watt>>(mantissa(random) / 100));
+    }
+    exact.reset();
+    exact.add(watts);
+    exact.add(kilowatts);
+    exact.add(megawatts);
+    reference = exact.value().value();
+
+    std::cout << std::endl << std::left << std::setw(24) << "mixed units" << std::setw(16) << "relative error" << "GB/s" << std::endl;
+    measure("double +=", 3 * third, repetitions, reference, [&](){
+        Quantity<Watt> sum(0);
+        for (long i=0; i<third; i++){
+            sum += watts[i];
+            sum += kilowatts[i];
+            sum += megawatts[i];
+        }
+        return sum.value();
+    });
+    measure("MultiUnitSum", 3 * third, repetitions, reference, [&](){
+        MultiUnitSum<Watt, double, Watt, Kilo<Watt>, Mega<Watt>> sum;
+        for (long i=0; i<third; i++){
+            sum += watts[i];
+            sum += kilowatts[i];
+            sum += megawatts[i];
+        }
+        return sum.value().value();
+    });
+    measure("MultiUnitSum, arrays", 3 * third, repetitions, reference, [&](){
+        MultiUnitSum<Watt, double, Watt, Kilo<Watt>, Mega<Watt>> sum;
+        sum.add(watts);
+        sum.add(kilowatts);
+        sum.add(megawatts);
+        return sum.value().value();
+    });
+    return 0;
+}
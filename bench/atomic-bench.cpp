@@ -0,0 +1,94 @@
+/**
+ * @file atomic-bench.cpp
+ *
+ * Runtime benchmark of LibUnit atomic and sharded quantities under
+ * contention.
+ *
+ * Threads add to a single shared total: energies in kilojoules to a total in
+ * joules stored as `double`, and integral energies in joules to a total in
+ * millijoules stored as `long long`. Each is compared with `std::atomic` of
+ * plain values, which is given already converted values, and with
+ * `ShardedQuantity`, which gives each thread its own slot. Measured with 1 to
+ * N threads, where N is the number of hardware threads; reports millions of
+ * additions per second, summed over all threads.
+ *
+ * Usage: atomic-bench [additions per thread]
+ */
+
+#include "atomicquantity.h"
+#include "units/SI.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+template <typename F>
+void measure(const char* name, unsigned int threads, long additions, F f){
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i=0; i<threads; i++)
+        workers.emplace_back([&](){
+            for (long j=0; j<additions; j++)
+                f();
+        });
+    for (std::thread& worker: workers)
+        worker.join();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(32) << name << threads * additions / t / 1e6 << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long additions = argc > 1 ? std::atol(argv[1]) : 2000000;
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int n=1;; n=std::min(2 * n, threads)){
+        std::atomic<double> joules(0);
+        AtomicQuantity<Joule> energy;
+        std::atomic<long long> millijoules(0);
+        AtomicQuantity<Mili<Joule>, long long> counter;
+        static ShardedQuantity<Joule> shardedEnergy;
+        static ShardedQuantity<Mili<Joule>, long long> shardedCounter;
+        shardedEnergy.reset();
+        shardedCounter.reset();
+        const Quantity<Kilo<Joule>> kilojoule(0.001);
+        const Quantity<Joule, int> joule(1);
+
+        std::cout << "threads: " << n << std::endl;
+        std::cout << std::left << std::setw(32) << "operation" << "Madditions/s" << std::endl;
+        measure("std::atomic<double>", n, additions, [&](){
+            joules.fetch_add(1, std::memory_order_relaxed);
+        });
+        measure("AtomicQuantity<Joule>", n, additions, [&](){
+            energy.fetch_add(kilojoule, std::memory_order_relaxed);
+        });
+        measure("ShardedQuantity<Joule>", n, additions, [&](){
+            shardedEnergy.add(kilojoule);
+        });
+        measure("std::atomic<long long>", n, additions, [&](){
+            millijoules.fetch_add(1000, std::memory_order_relaxed);
+        });
+        measure("AtomicQuantity<Mili<Joule>>", n, additions, [&](){
+            counter.fetch_add(joule, std::memory_order_relaxed);
+        });
+        measure("ShardedQuantity<Mili<Joule>>", n, additions, [&](){
+            shardedCounter.add(joule);
+        });
+        std::cerr << "totals: " << joules.load() << " " << energy.load().value() << " "
+                  << shardedEnergy.load().value() << " " << millijoules.load() << " "
+                  << counter.load().value() << " " << shardedCounter.load().value() << std::endl;
+        if (n == threads)
+            break;
+    }
+    return 0;
+}
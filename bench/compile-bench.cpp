@@ -0,0 +1,260 @@
+/**
+ * @file compile-bench.cpp
+ *
+ * Compile-time scaling benchmark for LibUnit.
+ *
+ * Generates translation units that stress unit manipulation templates on
+ * Compound types of growing length, compiles each of them and records wall
+ * time, peak RSS of the compiler and template instantiation statistics to a
+ * CSV file.
+ *
+ * Usage: compile-bench "<compiler command>" <output.csv> [work directory]
+ *
+ * Compiler command should contain all flags required to compile LibUnit
+ * headers, ie. language standard and include path. If the compiler is clang,
+ * `-ftime-trace` is used to count template instantiations. For GCC
+ * `-ftime-report` is used and only time spent on template instantiation is
+ * recorded.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace{
+
+/**
+ * @brief Results of a single compiler run.
+ */
+class Measurement{
+public:
+    double wallTime = 0;          //!< Wall time in seconds.
+    long peakRss = 0;             //!< Peak resident set size in kilobytes.
+    double instantiationTime = -1;//!< Time spent on template instantiation in seconds, or -1.
+    long instantiations = -1;     //!< Number of template instantiations, or -1.
+    bool ok = false;              //!< True if compilation succeeded.
+};
+
+/**
+ * @brief Description of one generated benchmark case.
+ */
+class BenchCase{
+public:
+    std::string name;                              //!< Name used in CSV output.
+    std::function<std::string(int)> generate;      //!< Returns TU body for given factor count.
+};
+
+const int factorCounts[] = {2, 4, 8, 16, 32, 64};
+
+const char* prelude =
+        "#include \"units/SI.h\"\n"
+        "using namespace LibUnit;\n"
+        "template <int k> class BenchDim{};\n"
+        "template <int k> class BenchUnit{\n"
+        "public:\n"
+        "    typedef BenchDim<k> Dimension;\n"
+        "    static constexpr int factor = 1;\n"
+        "};\n";
+
+const char* siUnits[] = {"Metre", "Second", "Kilo<Gram>", "Ampere", "Kelvin", "Mole", "Candela"};
+
+// Compound of n generic units, where every unit is repeated about twice, so
+// simplification has something to merge.
+std::string genericCompound(int n, bool reversed = false){
+    std::ostringstream s;
+    s << "Compound<";
+    for (int j=0; j<n; j++){
+        int i = reversed ? n-1-j : j;
+        if (j)
+            s << ", ";
+        s << "Power<BenchUnit<" << i % (n/2 + 1) << ">, " << (i%2 ? 2 : 1) << ">";
+    }
+    s << ">";
+    return s.str();
+}
+
+std::string simplifyCase(int n){
+    return "using Result = Simplify<" + genericCompound(n) + ">;\n"
+           "Result* sink = nullptr;\n";
+}
+
+std::string isEqualCase(int n){
+    return "static_assert(IsEqual<" + genericCompound(n) + ", " + genericCompound(n, true) + ">::value);\n";
+}
+
+std::string dimensionOfCase(int n){
+    return "using Result = Simplify<DimensionOf<" + genericCompound(n) + ">>;\n"
+           "Result* sink = nullptr;\n";
+}
+
+std::string factorOfCase(int n){
+    std::ostringstream s;
+    s << "constexpr auto factor = FactorOf<Compound<";
+    for (int i=0; i<n; i++)
+        s << (i ? ", " : "") << (i%2 ? "Mili<Metre>" : "Kilo<Metre>");
+    s << ">>::value;\n";
+    return s.str();
+}
+
+std::string expressionCase(int n){
+    std::ostringstream s;
+    s << "double expression(){\n";
+    for (int i=0; i<n; i++)
+        s << "    Quantity<" << siUnits[i%7] << "> q" << i << "(" << i+1 << ".0);\n";
+    s << "    auto r = q0";
+    for (int i=1; i<n; i++)
+        s << (i%3 == 2 ? " / " : " * ") << "q" << i;
+    s << ";\n"
+         "    auto s = r + r;\n"
+         "    return (s - r).value();\n"
+         "}\n";
+    return s.str();
+}
+
+bool contains(const std::string& haystack, const std::string& needle){
+    return haystack.find(needle) != std::string::npos;
+}
+
+std::string readFile(const std::string& path){
+    std::ifstream in(path);
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// Sums "count" arguments of clang -ftime-trace "Total Instantiate*" events.
+long clangInstantiations(const std::string& trace){
+    long total = 0;
+    bool found = false;
+    for (const char* event: {"\"Total InstantiateClass\"", "\"Total InstantiateFunction\""}){
+        std::size_t pos = trace.find(event);
+        if (pos == std::string::npos)
+            continue;
+        std::size_t count = trace.find("\"count\":", pos);
+        if (count == std::string::npos)
+            continue;
+        total += std::atol(trace.c_str() + count + 8);
+        found = true;
+    }
+    return found ? total : -1;
+}
+
+// Extracts wall time of "template instantiation" phase from GCC -ftime-report.
+double gccInstantiationTime(const std::string& report){
+    std::istringstream in(report);
+    std::string line;
+    while (std::getline(in, line)){
+        if (!contains(line, "template instantiation"))
+            continue;
+        // Columns: usr, sys, wall; each as "time ( pct%)".
+        std::size_t colon = line.find(':');
+        double times[3] = {-1, -1, -1};
+        std::size_t pos = colon;
+        for (int i=0; i<3 && pos != std::string::npos; i++){
+            times[i] = std::atof(line.c_str() + pos + 1);
+            pos = line.find(')', pos + 1);
+        }
+        return times[2];
+    }
+    return -1;
+}
+
+Measurement compile(const std::string& compiler, bool clang, const std::string& source, const std::string& base){
+    Measurement result;
+    std::string object = base + ".o";
+    std::string log = base + ".log";
+    std::string command = compiler + " -c " + source + " -o " + object;
+    if (clang)
+        command += " -ftime-trace -ftime-trace-granularity=0";
+    else
+        command += " -ftime-report";
+    command += " 2> " + log;
+
+    auto start = std::chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid == 0){
+        execl("/bin/sh", "sh", "-c", command.c_str(), static_cast<char*>(nullptr));
+        _exit(127);
+    }
+    int status = 0;
+    rusage usage{};
+    if (pid < 0 || wait4(pid, &status, 0, &usage) < 0)
+        return result;
+    auto end = std::chrono::steady_clock::now();
+
+    result.ok = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    result.wallTime = std::chrono::duration<double>(end - start).count();
+    result.peakRss = usage.ru_maxrss;
+    if (clang)
+        result.instantiations = clangInstantiations(readFile(base + ".json"));
+    else
+        result.instantiationTime = gccInstantiationTime(readFile(log));
+    return result;
+}
+
+}
+
+int main(int argc, char** argv){
+    if (argc < 3){
+        std::cerr << "Usage: " << argv[0] << " \"<compiler command>\" <output.csv> [work directory]" << std::endl;
+        return 2;
+    }
+    std::string compiler = argv[1];
+    std::string output = argv[2];
+    std::string workDir = argc > 3 ? argv[3] : "bench-compile.d";
+    mkdir(workDir.c_str(), 0755);
+
+    bool clang = false;
+    {
+        std::string probe = workDir + "/version.txt";
+        if (std::system((compiler + " --version > " + probe + " 2>&1").c_str()) == 0)
+            clang = contains(readFile(probe), "clang");
+    }
+
+    const BenchCase cases[] = {
+        {"simplify", simplifyCase},
+        {"isequal", isEqualCase},
+        {"dimensionof", dimensionOfCase},
+        {"factorof", factorOfCase},
+        {"expression", expressionCase},
+    };
+
+    std::ofstream csv(output);
+    csv << "case,factors,status,wall_s,peak_rss_kb,instantiation_s,instantiations\n";
+
+    int failures = 0;
+    for (const BenchCase& c: cases){
+        for (int n: factorCounts){
+            std::string base = workDir + "/" + c.name + "-" + std::to_string(n);
+            std::string source = base + ".cpp";
+            std::ofstream(source) << prelude << c.generate(n);
+
+            Measurement m = compile(compiler, clang, source, base);
+            failures += !m.ok;
+            csv << c.name << ',' << n << ',' << (m.ok ? "ok" : "failed") << ','
+                << m.wallTime << ',' << m.peakRss << ',';
+            if (m.instantiationTime >= 0)
+                csv << m.instantiationTime;
+            csv << ',';
+            if (m.instantiations >= 0)
+                csv << m.instantiations;
+            csv << '\n';
+            csv.flush();
+
+            std::cout << c.name << " [" << n << " factors]: " << (m.ok ? "" : "FAILED, ")
+                      << m.wallTime << " s, " << m.peakRss << " kB" << std::endl;
+        }
+    }
+    return failures ? 1 : 0;
+}
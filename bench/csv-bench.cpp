@@ -0,0 +1,92 @@
+/**
+ * @file csv-bench.cpp
+ *
+ * Runtime benchmark of LibUnit CSV reader.
+ *
+ * Writes a CSV file of speeds in km/h, temperatures in kelvins and pressures
+ * in bars, then reads it with `QuantityCsvReader` into columns in the same
+ * units, where values are only parsed, and into metres per second, kelvins
+ * and pascals, where two columns are converted. For comparison reads the
+ * same file line by line with `std::getline` and `std::strtod`. Reports MB/s
+ * of CSV read.
+ *
+ * Usage: csv-bench [rows] [directory]
+ */
+
+#include "quantitycsv.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+using KilometrePerHour = Compound<Power<Kilo<Metre>, 1>, Power<Hour, -1>>;
+using MetrePerSecond = Compound<Power<Metre, 1>, Power<Second, -1>>;
+
+template <typename F>
+void measure(const char* name, const std::string& path, double bytes, F f){
+    std::ifstream in(path, std::ios::binary);
+    auto start = std::chrono::steady_clock::now();
+    double checksum = f(in);
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(24) << name << bytes / t / 1e6 << " MB/s" << std::endl;
+    std::cerr << name << " checksum: " << checksum << std::endl;
+}
+
+template <typename Speed, typename Pressure>
+double readColumns(std::istream& in){
+    QuantityCsvReader<Quantity<Speed>, Quantity<Kelvin>, Quantity<Pressure>> reader(in);
+    double checksum = 0;
+    while (std::size_t n = reader.read())
+        checksum += reader.template column<0>()[n - 1].value() + reader.template column<1>()[n - 1].value() +
+                    reader.template column<2>()[n - 1].value();
+    return checksum;
+}
+
+}
+
+int main(int argc, char** argv){
+    long rows = argc > 1 ? std::atol(argv[1]) : 1 << 23;
+    std::string directory = argc > 2 ? argv[2] : ".";
+    std::string path = directory + "/csv-bench.csv";
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "speed[km/h],temp[K],pressure[bar]\n";
+        char line[64];
+        for (long i=0; i<rows; i++){
+            int n = std::snprintf(line, sizeof(line), "%.3f,%.2f,%.5f\n", (i % 3000) * 0.041, 250 + (i % 9000) * 0.01, 1 + (i % 777) * 1e-4);
+            out.write(line, n);
+        }
+    }
+    std::ifstream size(path, std::ios::binary | std::ios::ate);
+    double bytes = double(size.tellg());
+
+    std::cout << std::left;
+    measure("read", path, bytes, readColumns<KilometrePerHour, Bar>);
+    measure("read converted", path, bytes, readColumns<MetrePerSecond, Pascal>);
+    measure("getline and strtod", path, bytes, [](std::istream& in){
+        std::string line;
+        std::getline(in, line);
+        double checksum = 0;
+        while (std::getline(in, line)){
+            char* p = line.data();
+            double speed = std::strtod(p, &p);
+            double temp = std::strtod(p + 1, &p);
+            double pressure = std::strtod(p + 1, &p);
+            checksum = speed / 3.6 + temp + pressure * 1e5;
+        }
+        return checksum;
+    });
+
+    std::remove(path.c_str());
+    return 0;
+}
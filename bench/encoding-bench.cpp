@@ -0,0 +1,71 @@
+/**
+ * @file encoding-bench.cpp
+ *
+ * Runtime benchmark of LibUnit binary encoding of quantities.
+ *
+ * Encodes an array of times in milliseconds into a reused buffer, and decodes
+ * it into a reused vector of times in milliseconds, where values are copied,
+ * and in microseconds, where values are converted. For comparison copies the
+ * same values with `std::memcpy`. Reports GB/s of values processed.
+ *
+ * Usage: encoding-bench [size] [repetitions]
+ */
+
+#include "quantityencoding.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+template <typename F>
+void measure(const char* name, long size, long repetitions, F f){
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long r=0; r<repetitions; r++)
+        checksum += f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(24) << name << size * sizeof(double) * repetitions / t / 1e9 << std::endl;
+    std::cerr << name << " checksum: " << checksum << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long size = argc > 1 ? std::atol(argv[1]) : 1 << 20;
+    long repetitions = argc > 2 ? std::atol(argv[2]) : 200;
+
+    QuantityVector<Mili<Second>> times(size);
+    for (long i=0; i<size; i++)
+        times.set(i, Quantity<Mili<Second>>(i % 1000));
+    std::vector<std::byte> buffer(encodedSize(size));
+    QuantityVector<Mili<Second>> milliseconds(size);
+    QuantityVector<Micro<Second>> microseconds(size);
+    std::vector<double> copy(size);
+
+    std::cout << std::left << std::setw(24) << "operation" << "GB/s" << std::endl;
+    measure("memcpy", size, repetitions, [&](){
+        std::memcpy(copy.data(), times.data(), size * sizeof(double));
+        return copy[size - 1];
+    });
+    measure("encode", size, repetitions, [&](){
+        encode(times, buffer.data());
+        return double(buffer.back());
+    });
+    measure("decode", size, repetitions, [&](){
+        decode(buffer.data(), buffer.size(), QuantitySpan<Mili<Second>>(milliseconds));
+        return milliseconds[size - 1].value();
+    });
+    measure("decode converted", size, repetitions, [&](){
+        decode(buffer.data(), buffer.size(), QuantitySpan<Micro<Second>>(microseconds));
+        return microseconds[size - 1].value();
+    });
+    return 0;
+}
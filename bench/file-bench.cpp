@@ -0,0 +1,105 @@
+/**
+ * @file file-bench.cpp
+ *
+ * Runtime benchmark of LibUnit quantity files.
+ *
+ * Writes a file of two columns, times in milliseconds and distances in
+ * metres, appending arrays in seconds and kilometres, and for comparison a
+ * text file of the same values written with `operator<<`. Then opens the
+ * quantity file repeatedly, sums its columns once, and reads them converted
+ * to microseconds and kilometres. Reports GB/s of values written, summed and
+ * converted, and microseconds per open.
+ *
+ * Usage: file-bench [rows] [directory]
+ */
+
+#include "quantityfile.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+double seconds(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void report(const char* name, double value, const char* unit){
+    std::cout << std::setw(24) << name << value << ' ' << unit << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long rows = argc > 1 ? std::atol(argv[1]) : 1 << 24;
+    std::string directory = argc > 2 ? argv[2] : ".";
+    std::string path = directory + "/file-bench.luq";
+    std::string textPath = directory + "/file-bench.txt";
+    const long chunk = 1 << 16;
+    double bytes = 2.0 * sizeof(double) * rows;
+
+    QuantityVector<Second> times(chunk);
+    QuantityVector<Kilo<Metre>> distances(chunk);
+    for (long i=0; i<chunk; i++){
+        times.set(i, Quantity<Second>(i * 0.001));
+        distances.set(i, Quantity<Kilo<Metre>>(i % 1000));
+    }
+
+    std::cout << std::left;
+    auto start = std::chrono::steady_clock::now();
+    {
+        QuantityFileWriter<Quantity<Mili<Second>>, Quantity<Metre>> writer(path);
+        for (long i=0; i<rows; i+=chunk){
+            long n = std::min(chunk, rows - i);
+            writer.append(QuantitySpan<Second, const double>(times.data(), n),
+                          QuantitySpan<Kilo<Metre>, const double>(distances.data(), n));
+        }
+    }
+    report("write", bytes / seconds(start) / 1e9, "GB/s");
+
+    start = std::chrono::steady_clock::now();
+    {
+        std::ofstream text(textPath);
+        for (long i=0; i<rows; i++)
+            text << Quantity<Mili<Second>>(times[i % chunk]) << ',' << Quantity<Metre>(distances[i % chunk]) << '\n';
+    }
+    report("write text", bytes / seconds(start) / 1e9, "GB/s");
+
+    const int opens = 1000;
+    start = std::chrono::steady_clock::now();
+    for (int i=0; i<opens; i++){
+        QuantityFile file(path);
+        if (file.column<Mili<Second>>(0).size() != std::size_t(rows))
+            return 1;
+    }
+    report("open", seconds(start) / opens * 1e6, "us");
+
+    QuantityFile file(path);
+    start = std::chrono::steady_clock::now();
+    auto t = file.column<Mili<Second>>(0);
+    auto d = file.column<Metre>(1);
+    double sumT = 0, sumD = 0;
+    for (long i=0; i<rows; i++){
+        sumT += t[i].value();
+        sumD += d[i].value();
+    }
+    report("read", bytes / seconds(start) / 1e9, "GB/s");
+
+    start = std::chrono::steady_clock::now();
+    auto us = file.column<Micro<Second>>(0);
+    auto km = file.column<Kilo<Metre>>(1);
+    report("read converted", bytes / seconds(start) / 1e9, "GB/s");
+    std::cerr << "checksum: " << sumT << ' ' << sumD << ' ' << us[rows - 1].value() << ' ' << km[rows - 1].value() << std::endl;
+
+    std::remove(path.c_str());
+    std::remove(textPath.c_str());
+    return 0;
+}
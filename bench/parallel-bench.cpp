@@ -0,0 +1,108 @@
+/**
+ * @file parallel-bench.cpp
+ *
+ * Runtime benchmark of parallel algorithms over quantity arrays.
+ *
+ * Sums energies, computes work as sum of products of forces and distances,
+ * converts energies to kilojoules and computes their running sums, using
+ * `std::execution::par_unseq`. Each operation is measured with 1 to N worker
+ * threads, where N is the number of hardware threads, and for comparison
+ * with `std::reduce` over plain `double` values. Reports millions of elements
+ * processed per second.
+ *
+ * Number of threads is limited using `tbb::global_control`, if TBB is the
+ * backend of the standard library; otherwise operations are measured once,
+ * with default parallelism.
+ *
+ * Usage: parallel-bench [size] [repetitions]
+ */
+
+#include "quantityalgorithm.h"
+#include "units/SI.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <execution>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <thread>
+
+#if __has_include(<tbb/global_control.h>)
+#include <tbb/global_control.h>
+#define HAVE_TBB_GLOBAL_CONTROL
+#endif
+
+namespace{
+
+using namespace LibUnit;
+
+template <typename F>
+void measure(const char* name, long size, long repetitions, F f){
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long r=0; r<repetitions; r++)
+        checksum += f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(24) << name << size * repetitions / t / 1e6 << std::endl;
+    std::cerr << name << " checksum: " << checksum << std::endl;
+}
+
+void run(long size, long repetitions, const QuantityVector<Joule>& energies,
+         const QuantityVector<Newton>& forces, const QuantityVector<Metre>& distances){
+    using std::execution::par_unseq;
+    QuantityVector<Kilo<Joule>> kilojoules(size);
+    QuantityVector<Joule> sums(size);
+
+    measure("double reduce", size, repetitions, [&](){
+        return std::reduce(par_unseq, energies.data(), energies.data() + size, 0.0);
+    });
+    measure("reduce", size, repetitions, [&](){
+        return reduce(par_unseq, energies).value();
+    });
+    measure("transformReduce", size, repetitions, [&](){
+        Quantity<Joule> work = transformReduce(par_unseq, forces, distances);
+        return work.value();
+    });
+    measure("transform", size, repetitions, [&](){
+        transform(par_unseq, energies, kilojoules, [](Quantity<Joule> e){ return e; });
+        return kilojoules[size - 1].value();
+    });
+    measure("inclusiveScan", size, repetitions, [&](){
+        inclusiveScan(par_unseq, energies, sums);
+        return sums[size - 1].value();
+    });
+}
+
+}
+
+int main(int argc, char** argv){
+    long size = argc > 1 ? std::atol(argv[1]) : 1 << 22;
+    long repetitions = argc > 2 ? std::atol(argv[2]) : 50;
+
+    QuantityVector<Joule> energies(size);
+    QuantityVector<Newton> forces(size);
+    QuantityVector<Metre> distances(size);
+    for (long i=0; i<size; i++){
+        energies.set(i, Quantity<Joule>(1 + i % 13));
+        forces.set(i, Quantity<Newton>(1 + i % 7));
+        distances.set(i, Quantity<Metre>(1 + i % 5));
+    }
+
+#ifdef HAVE_TBB_GLOBAL_CONTROL
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int n=1;; n=std::min(2 * n, threads)){
+        tbb::global_control control(tbb::global_control::max_allowed_parallelism, n);
+        std::cout << "threads: " << n << std::endl;
+        std::cout << std::left << std::setw(24) << "operation" << "Melements/s" << std::endl;
+        run(size, repetitions, energies, forces, distances);
+        if (n == threads)
+            break;
+    }
+#else
+    std::cout << std::left << std::setw(24) << "operation" << "Melements/s" << std::endl;
+    run(size, repetitions, energies, forces, distances);
+#endif
+    return 0;
+}
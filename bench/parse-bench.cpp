@@ -0,0 +1,60 @@
+/**
+ * @file parse-bench.cpp
+ *
+ * Runtime benchmark of LibUnit unit expression parser.
+ *
+ * Parses a set of realistic unit strings in a loop and reports number of
+ * parses per second, for every string and for the whole set.
+ *
+ * Usage: parse-bench [iterations]
+ */
+
+#include "unitparser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+namespace{
+
+const std::string_view unitStrings[] = {
+    "m", "kg", "km/h", "m/s^2", "kg*m/s^2", "µA", "kW*h", "N·m", "g/cm^3",
+    "mmHg", "hPa", "MHz", "mol/(L*s)", "m·s⁻²", "ft/s", "lb", "mi/gal", "J/(kg*K)",
+};
+
+// Parses string `iterations` times and returns elapsed time in seconds.
+double measure(std::string_view s, long iterations, double& checksum){
+    auto start = std::chrono::steady_clock::now();
+    for (long i=0; i<iterations; i++){
+        LibUnit::DynamicUnit unit;
+        auto result = LibUnit::parseUnit(s, unit);
+        if (result.ec != std::errc()){
+            std::cerr << "Failed to parse \"" << s << '"' << std::endl;
+            std::exit(1);
+        }
+        checksum += unit.factor;
+        // Keeps the compiler from hoisting parsing out of the loop.
+        asm volatile("" : : "g"(&unit) : "memory");
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char** argv){
+    long iterations = argc > 1 ? std::atol(argv[1]) : 1000000;
+    double checksum = 0;
+    double total = 0;
+
+    std::cout << std::left << std::setw(16) << "unit" << "parses/s" << std::endl;
+    for (std::string_view s: unitStrings){
+        double t = measure(s, iterations, checksum);
+        total += t;
+        std::cout << std::setw(16) << s << iterations / t << std::endl;
+    }
+    std::cout << std::setw(16) << "all" << iterations * (sizeof(unitStrings) / sizeof(unitStrings[0])) / total << std::endl;
+    std::cerr << "checksum: " << checksum << std::endl;
+    return 0;
+}
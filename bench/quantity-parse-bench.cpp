@@ -0,0 +1,118 @@
+/**
+ * @file quantity-parse-bench.cpp
+ *
+ * Runtime benchmark of LibUnit quantity parser.
+ *
+ * Generates text of lengths written in several units, one per line, and
+ * parses it into `Quantity<Metre, double>` using `fromChars()`. For
+ * comparison, the same text is parsed using `strtod` followed by a manual
+ * lookup of the unit suffix and scaling. Reports values and megabytes parsed
+ * per second.
+ *
+ * Usage: quantity-parse-bench [lines]
+ */
+
+#include "unitparser.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace{
+
+const char* const suffixes[] = {" m", " km", "mm", " cm", " mi", " ft"};
+
+std::string generate(long lines){
+    std::string text;
+    std::srand(1);
+    char buffer[32];
+    for (long i=0; i<lines; i++){
+        double value = std::rand() / 1000.0;
+        std::to_chars_result r = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        text.append(buffer, r.ptr);
+        text += suffixes[i % 6];
+        text += '\n';
+    }
+    return text;
+}
+
+// Parses text using fromChars(); returns number of parsed values.
+long parseLibUnit(const std::string& text, double& checksum){
+    const char* pos = text.data();
+    const char* last = pos + text.size();
+    long count = 0;
+    while (pos != last){
+        LibUnit::Quantity<LibUnit::Metre, double> q;
+        std::from_chars_result r = LibUnit::fromChars(pos, last, q);
+        if (r.ec != std::errc()){
+            std::cerr << "Failed to parse line " << count << std::endl;
+            std::exit(1);
+        }
+        checksum += q.value();
+        count++;
+        pos = r.ptr + 1;
+    }
+    return count;
+}
+
+// Parses text using strtod and a hand-written table of suffixes.
+long parseStrtod(const std::string& text, double& checksum){
+    const char* pos = text.data();
+    long count = 0;
+    while (*pos){
+        char* end;
+        double value = std::strtod(pos, &end);
+        while (*end == ' ')
+            end++;
+        const char* unit = end;
+        while (*end != '\n')
+            end++;
+        std::size_t length = end - unit;
+        double factor;
+        if (length == 1 && unit[0] == 'm')
+            factor = 1;
+        else if (length == 2 && std::memcmp(unit, "km", 2) == 0)
+            factor = 1000;
+        else if (length == 2 && std::memcmp(unit, "mm", 2) == 0)
+            factor = 0.001;
+        else if (length == 2 && std::memcmp(unit, "cm", 2) == 0)
+            factor = 0.01;
+        else if (length == 2 && std::memcmp(unit, "mi", 2) == 0)
+            factor = 1609.344;
+        else if (length == 2 && std::memcmp(unit, "ft", 2) == 0)
+            factor = 0.3048;
+        else {
+            std::cerr << "Failed to parse line " << count << std::endl;
+            std::exit(1);
+        }
+        checksum += value * factor;
+        count++;
+        pos = end + 1;
+    }
+    return count;
+}
+
+template <typename F>
+void measure(const char* name, F f, const std::string& text){
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    long count = f(text, checksum);
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(16) << name << std::setw(16) << count / t << text.size() / t / 1e6 << std::endl;
+    std::cerr << name << " checksum: " << checksum << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long lines = argc > 1 ? std::atol(argv[1]) : 2000000;
+    std::string text = generate(lines);
+
+    std::cout << std::left << std::setw(16) << "parser" << std::setw(16) << "values/s" << "MB/s" << std::endl;
+    measure("fromChars", parseLibUnit, text);
+    measure("strtod", parseStrtod, text);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file ring-bench.cpp
+ *
+ * Runtime benchmark of LibUnit shared memory quantity rings.
+ *
+ * A producer process pushes voltages in millivolts to a ring of voltages in
+ * volts, which converts them, and the consumer process sums them. Measured
+ * with single pushes and pops, with arrays of 1024 values consumed in place,
+ * and with two producer processes pushing single values to a multi-producer
+ * ring. Reports millions of values passed per second.
+ *
+ * Usage: ring-bench [values per producer]
+ */
+
+#include "quantityring.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace{
+
+using namespace LibUnit;
+
+const std::size_t batch = 1024;
+
+template <bool multiProducer, typename Produce>
+void measure(const char* name, long values, int producers, bool batches, Produce produce){
+    typedef QuantityRing<Volt, double, multiProducer> Ring;
+    std::string ringName = "/libunit-ring-bench-" + std::to_string(getpid());
+    Ring::remove(ringName);
+    Ring ring(ringName, 1 << 16);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int p=0; p<producers; p++)
+        if (fork() == 0){
+            Ring producer(ringName);
+            produce(producer, values);
+            _exit(0);
+        }
+
+    double sum = 0;
+    long total = values * producers;
+    for (long received = 0; received < total;){
+        if (batches){
+            std::size_t n = ring.consume([&](QuantitySpan<Volt, const double> values){
+                for (double v: values.values())
+                    sum += v;
+            });
+            if (n == 0)
+                std::this_thread::yield();
+            received += n;
+        } else if (auto q = ring.tryPop()){
+            sum += q->value();
+            received++;
+        } else
+            std::this_thread::yield();
+    }
+    while (wait(nullptr) > 0);
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Ring::remove(ringName);
+    std::cout << std::setw(24) << name << total / t / 1e6 << std::endl;
+    std::cerr << name << " checksum: " << sum << std::endl;
+}
+
+template <typename Ring>
+void pushSingle(Ring& ring, long values){
+    for (long i=0; i<values; i++)
+        while (!ring.tryPush(Quantity<Mili<Volt>>(i % 1000)))
+            std::this_thread::yield();
+}
+
+}
+
+int main(int argc, char** argv){
+    long values = argc > 1 ? std::atol(argv[1]) : 20000000;
+
+    std::cout << std::left << std::setw(24) << "operation" << "Mvalues/s" << std::endl;
+    measure<false>("single", values, 1, false, pushSingle<QuantityRing<Volt>>);
+    measure<false>("array", values, 1, true, [](QuantityRing<Volt>& ring, long values){
+        QuantityVector<Mili<Volt>> in(batch);
+        for (std::size_t i=0; i<batch; i++)
+            in.set(i, Quantity<Mili<Volt>>(i % 1000));
+        for (long i=0; i<values;){
+            std::size_t n = std::min<long>(batch, values - i);
+            std::size_t pushed = ring.push(QuantitySpan<Mili<Volt>, const double>(in.data(), n));
+            if (pushed == 0)
+                std::this_thread::yield();
+            i += pushed;
+        }
+    });
+    measure<true>("two producers", values / 2, 2, false, pushSingle<QuantityRing<Volt, double, true>>);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file vector-bench.cpp
+ *
+ * Runtime benchmark of LibUnit quantity vectors.
+ *
+ * Computes speeds from vectors of distances and times, converts distances to
+ * kilometres and evaluates mechanical energy `0.5*m*v*v + m*g*h`, both for
+ * `std::vector` of quantities processed in scalar loops and for
+ * `QuantityVector` expressions. Reports millions of elements processed per
+ * second.
+ *
+ * Usage: vector-bench [size] [repetitions]
+ */
+
+#include "quantityvector.h"
+#include "units/SI.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Metre, Power<Second, -1>> Speed;
+typedef Compound<Metre, Power<Second, -2>> Acceleration;
+
+template <typename F>
+void measure(const char* name, long size, long repetitions, F f){
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long r=0; r<repetitions; r++)
+        checksum += f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(24) << name << size * repetitions / t / 1e6 << std::endl;
+    std::cerr << name << " checksum: " << checksum << std::endl;
+}
+
+}
+
+int main(int argc, char** argv){
+    long size = argc > 1 ? std::atol(argv[1]) : 4096;
+    long repetitions = argc > 2 ? std::atol(argv[2]) : 100000;
+
+    std::vector<Quantity<Metre>> distances;
+    std::vector<Quantity<Second>> times;
+    QuantityVector<Metre> distanceVector;
+    QuantityVector<Second> timeVector;
+    for (long i=0; i<size; i++){
+        distances.push_back(Quantity<Metre>(100 + i));
+        times.push_back(Quantity<Second>(1 + i % 7));
+        distanceVector.push_back(distances.back());
+        timeVector.push_back(times.back());
+    }
+    std::vector<Quantity<Kilo<Gram>>> masses;
+    QuantityVector<Kilo<Gram>> massVector;
+    for (long i=0; i<size; i++){
+        masses.push_back(Quantity<Kilo<Gram>>(1 + i % 3));
+        massVector.push_back(masses.back());
+    }
+    const Quantity<Acceleration> g(9.81);
+    std::vector<Quantity<Speed>> speeds(size);
+    std::vector<Quantity<Kilo<Metre>>> kilometres(size);
+    QuantityVector<Speed> speedVector(size);
+    QuantityVector<Kilo<Metre>> kilometreVector(size);
+    std::vector<Quantity<Joule>> energies(size);
+    QuantityVector<Joule> energyVector(size);
+
+    std::cout << std::left << std::setw(24) << "operation" << "Melements/s" << std::endl;
+    measure("std::vector divide", size, repetitions, [&](){
+        for (long i=0; i<size; i++)
+            speeds[i] = distances[i] / times[i];
+        return speeds[size - 1].value();
+    });
+    measure("QuantityVector divide", size, repetitions, [&](){
+        speedVector = distanceVector / timeVector;
+        return speedVector[size - 1].value();
+    });
+    measure("std::vector convert", size, repetitions, [&](){
+        for (long i=0; i<size; i++)
+            kilometres[i] = distances[i];
+        return kilometres[size - 1].value();
+    });
+    measure("QuantityVector convert", size, repetitions, [&](){
+        kilometreVector = distanceVector;
+        return kilometreVector[size - 1].value();
+    });
+    measure("std::vector energy", size, repetitions, [&](){
+        for (long i=0; i<size; i++)
+            energies[i] = 0.5*masses[i]*speeds[i]*speeds[i] + masses[i]*g*distances[i];
+        return energies[size - 1].value();
+    });
+    measure("QuantityVector energy", size, repetitions, [&](){
+        energyVector = 0.5*massVector*speedVector*speedVector + massVector*g*distanceVector;
+        return energyVector[size - 1].value();
+    });
+    return 0;
+}
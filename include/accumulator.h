@@ -0,0 +1,476 @@
+#ifndef ACCUMULATOR_H
+#define ACCUMULATOR_H
+
+#include "quantityvector.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file accumulator.h
+ *
+ * Accumulators summing many quantities with smaller rounding error than
+ * repeated `operator+=`.
+ *
+ * All accumulators have the same interface: quantities are added one at a
+ * time using `operator+=`, or whole arrays at once using `add()`, and the sum
+ * is read using `value()`. Added quantities may be of any unit of the same
+ * dimension as unit of the accumulator; they are converted to it using
+ * `Convert`. If dimensions are different, compilation error is generated.
+ *
+ *  - `NeumaierSum` keeps a single compensated sum. Its error does not depend
+ *    on number of values, but every value is added sequentially.
+ *  - `PairwiseSum` sums values in blocks and adds partial sums of equal size
+ *    pairwise. Its error grows with logarithm of number of values, and it is
+ *    nearly as fast as naive summation.
+ *  - `MultiLaneSum` keeps compensated sums in several independent lanes,
+ *    which are updated by vector instructions. Its error is close to error of
+ *    `NeumaierSum`, at speed close to memory bandwidth.
+ *
+ * `MultiUnitSum` is different: it sums quantities of a fixed set of units
+ * separately, without conversion, and converts the sums only when they are
+ * read.
+ *
+ * @remark
+ * Compensated summation relies on exact order of floating point operations;
+ * it is defeated by `-ffast-math` and similar options.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Adds value to a compensated sum, using Neumaier's variant of Kahan's
+ * algorithm.
+ */
+template <typename T>
+inline constexpr void addCompensated(T& sum, T& compensation, T x) noexcept{
+    T t = sum + x;
+    if ((sum < 0 ? -sum : sum) >= (x < 0 ? -x : x))
+        compensation += (sum - t) + x;
+    else
+        compensation += (x - t) + sum;
+    sum = t;
+}
+
+/**
+ * @brief Sum of `n` values converted from unit `From` to unit `To` and type
+ * `T`.
+ *
+ * Values are summed in independent lanes, which compilers vectorize, and
+ * lanes are added pairwise at the end.
+ */
+template <typename From, typename To, typename T, typename T2>
+inline T sumValues(const T2* values, std::size_t n) noexcept{
+    T lanes[vectorBlock] = {};
+    std::size_t full = n - n % vectorBlock;
+    for (std::size_t i=0; i<full; i += vectorBlock){
+#pragma GCC unroll 8
+        for (std::size_t j=0; j<vectorBlock; j++)
+            lanes[j] += convertValue<From, To, T>(values[i + j]);
+    }
+    for (std::size_t i=full; i<n; i++)
+        lanes[0] += convertValue<From, To, T>(values[i]);
+    for (std::size_t width = vectorBlock / 2; width; width /= 2)
+        for (std::size_t j=0; j<width; j++)
+            lanes[j] += lanes[j + width];
+    return lanes[0];
+}
+
+/**
+ * @brief Index of the first of units `Sources` equal to `U`, ie. of the same
+ * dimension and factor; number of `Sources` if there is none.
+ */
+template <typename U, typename ...Sources>
+inline constexpr std::size_t sourceIndex() noexcept{
+    constexpr bool equal[] = {(IsEqualDimension<U, Sources>::value && RatioFactorOf<U, Sources>::identity)...};
+    std::size_t i = 0;
+    while (i < sizeof...(Sources) && !equal[i])
+        i++;
+    return i;
+}
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Compensated sum of quantities.
+ *
+ * @tparam Unit Unit of the sum.
+ * @tparam T Floating point type of the sum.
+ *
+ * Uses Neumaier's variant of Kahan's algorithm: rounding error of every
+ * addition is accumulated in a separate compensation term, so error of the
+ * sum is bounded independently of number of values.
+ */
+template <typename Unit, typename T = double>
+class NeumaierSum{
+private:
+    static_assert(std::is_floating_point<T>::value, "Compensated sum of non-floating point values.");
+
+    T sum = 0;
+    T compensation = 0;
+
+public:
+    typedef Unit UnitType;  //!< Unit of the sum.
+    typedef T ValueType;    //!< Underlying type of the sum.
+
+    NeumaierSum() = default;
+
+    /**
+     * @brief Adds a quantity.
+     */
+    template <typename U, typename T2>
+    inline constexpr NeumaierSum& operator+=(const Quantity<U, T2>& q) noexcept{
+        Helper::addCompensated(sum, compensation, Helper::convertValue<U, Unit, T>(q.value()));
+        return *this;
+    }
+
+    /**
+     * @brief Adds all quantities of a `QuantitySpan` or `QuantityVector`.
+     */
+    template <typename A>
+    inline NeumaierSum& add(const A& array) noexcept{
+        auto s = Helper::viewOf(array);
+        typedef typename decltype(s)::UnitType From;
+        for (std::size_t i=0; i<s.size(); i++)
+            Helper::addCompensated(sum, compensation, Helper::convertValue<From, Unit, T>(s.data()[i]));
+        return *this;
+    }
+
+    /**
+     * @brief Sum of added quantities.
+     */
+    inline constexpr Quantity<Unit, T> value() const noexcept{
+        return Quantity<Unit, T>(sum + compensation);
+    }
+
+    /**
+     * @brief Sets the sum to zero.
+     */
+    inline constexpr void reset() noexcept{
+        sum = 0;
+        compensation = 0;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Pairwise sum of quantities.
+ *
+ * @tparam Unit Unit of the sum.
+ * @tparam T Underlying type of the sum.
+ *
+ * Values are buffered in blocks of `blockSize`, and each block is summed in
+ * independent lanes, which compilers vectorize. Sums of blocks are combined
+ * like in a binary counter: two partial sums of the same number of blocks are
+ * added together, so every value takes part in a logarithmic number of
+ * additions.
+ */
+template <typename Unit, typename T = double>
+class PairwiseSum{
+public:
+    static constexpr std::size_t blockSize = 128;  //!< Number of values summed directly.
+
+private:
+    T block[blockSize];
+    std::size_t count = 0;     // Number of values in block.
+    T partials[64];
+    std::uint64_t blocks = 0;  // Partial sum of 2^k blocks is valid if k-th bit is set.
+
+    inline void merge(T s) noexcept{
+        int level = 0;
+        for (std::uint64_t b = blocks; b & 1; b >>= 1, level++)
+            s = partials[level] + s;
+        partials[level] = s;
+        blocks++;
+    }
+
+public:
+    typedef Unit UnitType;  //!< Unit of the sum.
+    typedef T ValueType;    //!< Underlying type of the sum.
+
+    PairwiseSum() = default;
+
+    /**
+     * @brief Adds a quantity.
+     */
+    template <typename U, typename T2>
+    inline PairwiseSum& operator+=(const Quantity<U, T2>& q) noexcept{
+        block[count++] = Helper::convertValue<U, Unit, T>(q.value());
+        if (count == blockSize){
+            merge(Helper::sumValues<Unit, Unit, T>(block, blockSize));
+            count = 0;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Adds all quantities of a `QuantitySpan` or `QuantityVector`.
+     *
+     * Full blocks are summed directly from the array, without buffering.
+     */
+    template <typename A>
+    inline PairwiseSum& add(const A& array) noexcept{
+        auto s = Helper::viewOf(array);
+        typedef typename decltype(s)::UnitType From;
+        std::size_t i = 0;
+        for (; count && i<s.size(); i++)
+            *this += Quantity<From, typename decltype(s)::ValueType>(s.data()[i]);
+        for (; i + blockSize <= s.size(); i += blockSize)
+            merge(Helper::sumValues<From, Unit, T>(s.data() + i, blockSize));
+        for (; i<s.size(); i++)
+            block[count++] = Helper::convertValue<From, Unit, T>(s.data()[i]);
+        return *this;
+    }
+
+    /**
+     * @brief Sum of added quantities.
+     */
+    inline Quantity<Unit, T> value() const noexcept{
+        T result = Helper::sumValues<Unit, Unit, T>(block, count);
+        int level = 0;
+        for (std::uint64_t b = blocks; b; b >>= 1, level++)
+            if (b & 1)
+                result += partials[level];
+        return Quantity<Unit, T>(result);
+    }
+
+    /**
+     * @brief Sets the sum to zero.
+     */
+    inline void reset() noexcept{
+        count = 0;
+        blocks = 0;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Compensated sum of quantities, computed in independent lanes.
+ *
+ * @tparam Unit Unit of the sum.
+ * @tparam T Floating point type of the sum.
+ *
+ * Keeps `lanes` compensated sums using Kahan's algorithm, which has no
+ * branches. Consecutive values of arrays are added to consecutive lanes, so
+ * all lanes are updated at once by vector instructions. Lanes are combined
+ * using Neumaier's algorithm when the sum is read.
+ */
+template <typename Unit, typename T = double>
+class MultiLaneSum{
+public:
+    static constexpr std::size_t lanes = Helper::vectorBlock;  //!< Number of lanes.
+
+private:
+    static_assert(std::is_floating_point<T>::value, "Compensated sum of non-floating point values.");
+
+    T sums[lanes] = {};
+    T compensations[lanes] = {};
+    std::size_t next = 0;  // Lane of the next quantity added by operator+=.
+
+    static inline constexpr void addKahan(T& sum, T& compensation, T x) noexcept{
+        T y = x - compensation;
+        T t = sum + y;
+        compensation = (t - sum) - y;
+        sum = t;
+    }
+
+public:
+    typedef Unit UnitType;  //!< Unit of the sum.
+    typedef T ValueType;    //!< Underlying type of the sum.
+
+    MultiLaneSum() = default;
+
+    /**
+     * @brief Adds a quantity.
+     */
+    template <typename U, typename T2>
+    inline constexpr MultiLaneSum& operator+=(const Quantity<U, T2>& q) noexcept{
+        addKahan(sums[next], compensations[next], Helper::convertValue<U, Unit, T>(q.value()));
+        next = (next + 1) % lanes;
+        return *this;
+    }
+
+    /**
+     * @brief Adds all quantities of a `QuantitySpan` or `QuantityVector`.
+     */
+    template <typename A>
+    inline MultiLaneSum& add(const A& array) noexcept{
+        auto s = Helper::viewOf(array);
+        typedef typename decltype(s)::UnitType From;
+        const auto* values = s.data();
+        T sum[lanes];
+        T compensation[lanes];
+        for (std::size_t j=0; j<lanes; j++){
+            sum[j] = sums[j];
+            compensation[j] = compensations[j];
+        }
+        std::size_t i = 0;
+        for (; i + lanes <= s.size(); i += lanes){
+#pragma GCC unroll 8
+            for (std::size_t j=0; j<lanes; j++)
+                addKahan(sum[j], compensation[j], Helper::convertValue<From, Unit, T>(values[i + j]));
+        }
+        for (std::size_t j=0; j<lanes; j++){
+            sums[j] = sum[j];
+            compensations[j] = compensation[j];
+        }
+        for (; i<s.size(); i++)
+            *this += Quantity<From, typename decltype(s)::ValueType>(values[i]);
+        return *this;
+    }
+
+    /**
+     * @brief Sum of added quantities.
+     */
+    inline constexpr Quantity<Unit, T> value() const noexcept{
+        T sum = 0;
+        T compensation = 0;
+        for (std::size_t j=0; j<lanes; j++){
+            Helper::addCompensated(sum, compensation, sums[j]);
+            Helper::addCompensated(sum, compensation, -compensations[j]);
+        }
+        return Quantity<Unit, T>(sum + compensation);
+    }
+
+    /**
+     * @brief Sets the sum to zero.
+     */
+    inline constexpr void reset() noexcept{
+        for (std::size_t j=0; j<lanes; j++){
+            sums[j] = 0;
+            compensations[j] = 0;
+        }
+        next = 0;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Sum of quantities of several units, converted when it is read.
+ *
+ * @tparam Unit Unit of the sum.
+ * @tparam T Underlying type of the sum.
+ * @tparam Sources Units of added quantities.
+ *
+ * Keeps a separate sum, or lane, for each unit of `Sources`. Quantities are
+ * added to the lane of their unit without conversion, so adding is a single
+ * addition; lanes are converted to `Unit` only by `value()`. Summing values
+ * of similar magnitude in their own units also avoids rounding errors of
+ * conversions.
+ *
+ * Added quantities must be of one of `Sources`, or of a unit equal to one of
+ * them, otherwise compilation error is generated.
+ *
+ * Accumulators of the same `Sources` are merged lane by lane, also without
+ * conversion. To sum in many threads, give each thread its own accumulator and
+ * merge them when threads are finished.
+ *
+ * Examples
+ * ------------------------
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * MultiUnitSum<Watt, double, Watt, Kilo<Watt>, Mega<Watt>> sum;
+ * sum += Quantity<Kilo<Watt>>(2);
+ * sum += Quantity<Watt>(500);
+ * sum.value(); // 2500 W
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename Unit, typename T, typename ...Sources>
+class MultiUnitSum{
+private:
+    static_assert(sizeof...(Sources) > 0, "Accumulator without source units.");
+
+    template <typename, typename, typename ...>
+    friend class MultiUnitSum;
+
+    T lanes[sizeof...(Sources)] = {};
+
+    template <typename U>
+    static inline constexpr std::size_t laneOf() noexcept{
+        constexpr std::size_t lane = Helper::sourceIndex<U, Sources...>();
+        static_assert(lane < sizeof...(Sources), "Unit is not one of source units of accumulator.");
+        return lane;
+    }
+
+public:
+    typedef Unit UnitType;  //!< Unit of the sum.
+    typedef T ValueType;    //!< Underlying type of the sum.
+
+    inline constexpr MultiUnitSum() noexcept{
+        (checkConvertible<Sources, Unit>(), ...);
+    }
+
+    /**
+     * @brief Adds a quantity to the lane of its unit.
+     */
+    template <typename U, typename T2>
+    inline constexpr MultiUnitSum& operator+=(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value){
+        lanes[laneOf<U>()] += q.value();
+        return *this;
+    }
+
+    /**
+     * @brief Adds all quantities of a `QuantitySpan` or `QuantityVector` to
+     * the lane of their unit.
+     */
+    template <typename A>
+    inline MultiUnitSum& add(const A& array) noexcept{
+        auto s = Helper::viewOf(array);
+        typedef typename decltype(s)::UnitType From;
+        lanes[laneOf<From>()] += Helper::sumValues<From, From, T>(s.data(), s.size());
+        return *this;
+    }
+
+    /**
+     * @brief Merges other accumulator of the same source units.
+     */
+    template <typename U>
+    inline constexpr MultiUnitSum& operator+=(const MultiUnitSum<U, T, Sources...>& other) noexcept(Helper::IsNothrow<T>::value){
+        for (std::size_t i=0; i<sizeof...(Sources); i++)
+            lanes[i] += other.lanes[i];
+        return *this;
+    }
+
+    /**
+     * @brief Sum of quantities added to lane of unit `U`, in that unit.
+     */
+    template <typename U>
+    inline constexpr Quantity<U, T> lane() const noexcept(Helper::IsNothrow<T>::value){
+        return Quantity<U, T>(lanes[laneOf<U>()]);
+    }
+
+    /**
+     * @brief Sum of all added quantities.
+     *
+     * Each lane is converted to `Unit` once, like by converting constructor of
+     * `Quantity`.
+     */
+    inline constexpr Quantity<Unit, T> value() const noexcept(Helper::IsNothrow<T>::value){
+        T result = 0;
+        std::size_t i = 0;
+        ((result += Helper::convertValue<Sources, Unit, T>(lanes[i++])), ...);
+        return Quantity<Unit, T>(result);
+    }
+
+    /**
+     * @brief Sets all lanes to zero.
+     */
+    inline constexpr void reset() noexcept{
+        for (std::size_t i=0; i<sizeof...(Sources); i++)
+            lanes[i] = 0;
+    }
+};
+
+}
+
+#endif // ACCUMULATOR_H
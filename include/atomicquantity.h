@@ -0,0 +1,342 @@
+#ifndef ATOMICQUANTITY_H
+#define ATOMICQUANTITY_H
+
+#include "quantityexpression.h"
+#include <atomic>
+#include <type_traits>
+
+/**
+ * @file atomicquantity.h
+ *
+ * Quantities shared by many threads: `AtomicQuantity`, a single atomic value,
+ * and `ShardedQuantity`, a counter split into per-thread slots.
+ */
+
+namespace LibUnit{
+
+/**
+ * @brief Quantity which may be modified by many threads at once.
+ *
+ * @tparam Unit Unit of the quantity.
+ * @tparam T Underlying type; integral or floating point.
+ *
+ * Wraps `std::atomic<T>`, so it is lock-free whenever `std::atomic<T>` is.
+ * All modifying operations accept quantities of any unit of the same
+ * dimension; they are converted to `Unit` before the atomic operation, like by
+ * converting constructor of `Quantity`, so the conversion is never repeated
+ * when the operation is retried. If dimensions are different, compilation
+ * error is generated.
+ *
+ * `fetch_add` and `fetch_sub` are hardware atomic additions for integral
+ * types; for floating point types they are compare-and-exchange loops of the
+ * standard library.
+ *
+ * `std::atomic<Quantity<Unit, T>>` is specialized as `AtomicQuantity<Unit, T>`.
+ */
+template <typename Unit, typename T = double>
+class AtomicQuantity{
+private:
+    static_assert(std::is_integral<T>::value || std::is_floating_point<T>::value,
+                  "Atomic quantity of non-arithmetic type.");
+
+    std::atomic<T> t;
+
+    template <typename U, typename T2>
+    static inline constexpr T convert(const Quantity<U, T2>& q) noexcept{
+        return Helper::convertValue<U, Unit, T>(q.value());
+    }
+
+public:
+    typedef Quantity<Unit, T> value_type;  //!< Type of stored quantities.
+
+    static constexpr bool is_always_lock_free = std::atomic<T>::is_always_lock_free;
+
+    /**
+     * @brief Constructs a quantity of zero value.
+     */
+    inline constexpr AtomicQuantity() noexcept
+        :t(0)
+    {}
+
+    /**
+     * @brief Constructs a quantity of value of `q`, scaled to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline constexpr AtomicQuantity(const Quantity<U, T2>& q) noexcept
+        :t(convert(q))
+    {}
+
+    AtomicQuantity(const AtomicQuantity&) = delete;
+    AtomicQuantity& operator=(const AtomicQuantity&) = delete;
+
+    /**
+     * @brief Checks if operations are lock-free.
+     */
+    inline bool is_lock_free() const noexcept{
+        return t.is_lock_free();
+    }
+
+    /**
+     * @brief Atomically reads the quantity.
+     */
+    inline Quantity<Unit, T> load(std::memory_order order = std::memory_order_seq_cst) const noexcept{
+        return Quantity<Unit, T>(t.load(order));
+    }
+
+    inline operator Quantity<Unit, T>() const noexcept{
+        return load();
+    }
+
+    /**
+     * @brief Atomically replaces the quantity.
+     */
+    template <typename U, typename T2>
+    inline void store(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_seq_cst) noexcept{
+        t.store(convert(q), order);
+    }
+
+    template <typename U, typename T2>
+    inline AtomicQuantity& operator=(const Quantity<U, T2>& q) noexcept{
+        store(q);
+        return *this;
+    }
+
+    /**
+     * @brief Atomically replaces the quantity.
+     * @return previous quantity.
+     */
+    template <typename U, typename T2>
+    inline Quantity<Unit, T> exchange(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_seq_cst) noexcept{
+        return Quantity<Unit, T>(t.exchange(convert(q), order));
+    }
+
+    /**
+     * @name Compare-and-exchange operations.
+     *
+     * If the quantity equals `expected`, it is replaced by `desired`;
+     * otherwise `expected` is set to the current quantity. `desired` is
+     * converted to `Unit` once, before the operation.
+     *
+     * @return true if the quantity was replaced.
+     */
+    //@{
+    template <typename U, typename T2>
+    inline bool compare_exchange_weak(Quantity<Unit, T>& expected, const Quantity<U, T2>& desired,
+                                      std::memory_order order = std::memory_order_seq_cst) noexcept{
+        return t.compare_exchange_weak(expected.ref(), convert(desired), order);
+    }
+
+    template <typename U, typename T2>
+    inline bool compare_exchange_weak(Quantity<Unit, T>& expected, const Quantity<U, T2>& desired,
+                                      std::memory_order success, std::memory_order failure) noexcept{
+        return t.compare_exchange_weak(expected.ref(), convert(desired), success, failure);
+    }
+
+    template <typename U, typename T2>
+    inline bool compare_exchange_strong(Quantity<Unit, T>& expected, const Quantity<U, T2>& desired,
+                                        std::memory_order order = std::memory_order_seq_cst) noexcept{
+        return t.compare_exchange_strong(expected.ref(), convert(desired), order);
+    }
+
+    template <typename U, typename T2>
+    inline bool compare_exchange_strong(Quantity<Unit, T>& expected, const Quantity<U, T2>& desired,
+                                        std::memory_order success, std::memory_order failure) noexcept{
+        return t.compare_exchange_strong(expected.ref(), convert(desired), success, failure);
+    }
+    //@}
+
+    /**
+     * @brief Atomically adds a quantity.
+     * @return previous quantity.
+     */
+    template <typename U, typename T2>
+    inline Quantity<Unit, T> fetch_add(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_seq_cst) noexcept{
+        return Quantity<Unit, T>(t.fetch_add(convert(q), order));
+    }
+
+    /**
+     * @brief Atomically subtracts a quantity.
+     * @return previous quantity.
+     */
+    template <typename U, typename T2>
+    inline Quantity<Unit, T> fetch_sub(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_seq_cst) noexcept{
+        return Quantity<Unit, T>(t.fetch_sub(convert(q), order));
+    }
+
+    /**
+     * @brief Atomically adds a quantity.
+     * @return new quantity.
+     */
+    template <typename U, typename T2>
+    inline Quantity<Unit, T> operator+=(const Quantity<U, T2>& q) noexcept{
+        T v = convert(q);
+        return Quantity<Unit, T>(t.fetch_add(v) + v);
+    }
+
+    /**
+     * @brief Atomically subtracts a quantity.
+     * @return new quantity.
+     */
+    template <typename U, typename T2>
+    inline Quantity<Unit, T> operator-=(const Quantity<U, T2>& q) noexcept{
+        T v = convert(q);
+        return Quantity<Unit, T>(t.fetch_sub(v) - v);
+    }
+
+    /**
+     * @brief Blocks until the quantity is no longer equal to `old`.
+     *
+     * `old` is converted to `Unit` once, before waiting; see
+     * `std::atomic::wait()`.
+     */
+    template <typename U, typename T2>
+    inline void wait(const Quantity<U, T2>& old, std::memory_order order = std::memory_order_seq_cst) const noexcept{
+        t.wait(convert(old), order);
+    }
+
+    /**
+     * @brief Unblocks one thread waiting in `wait()`.
+     */
+    inline void notify_one() noexcept{
+        t.notify_one();
+    }
+
+    /**
+     * @brief Unblocks all threads waiting in `wait()`.
+     */
+    inline void notify_all() noexcept{
+        t.notify_all();
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Number of the calling thread; threads are numbered in order of their
+ * first call.
+ */
+inline unsigned int threadNumber() noexcept{
+    static std::atomic<unsigned int> next{0};
+    thread_local unsigned int number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+}
+
+}
+
+/** @endcond */
+
+/**
+ * @brief Counter of a quantity updated by many threads, split into
+ * per-thread slots.
+ *
+ * @tparam Unit Unit of the counter.
+ * @tparam T Underlying type; integral or floating point.
+ * @tparam shards Number of slots.
+ *
+ * Each slot is an `AtomicQuantity` on its own cache line. Threads add to slot
+ * of their thread number modulo `shards`, so with enough slots threads never
+ * write to the same cache line, and updates do not wait for other threads.
+ * For integral `T` updates are wait-free; for floating point `T` they are
+ * compare-and-exchange loops, which only repeat if threads share a slot.
+ *
+ * `load()` sums all slots. Sum includes all updates completed before the call,
+ * but it is not a snapshot: updates made during the call may or may not be
+ * included.
+ *
+ * Counter is large; make it a static or a long-lived heap object.
+ */
+template <typename Unit, typename T = double, int shards = 64>
+class ShardedQuantity{
+private:
+    static_assert(shards > 0, "Sharded quantity without slots.");
+
+    class alignas(64) Slot{
+    public:
+        AtomicQuantity<Unit, T> q;
+    };
+
+    Slot slots[shards];
+
+    inline AtomicQuantity<Unit, T>& slot() noexcept{
+        return slots[Helper::threadNumber() % shards].q;
+    }
+
+public:
+    typedef Quantity<Unit, T> value_type;  //!< Type of counted quantities.
+
+    ShardedQuantity() = default;
+    ShardedQuantity(const ShardedQuantity&) = delete;
+    ShardedQuantity& operator=(const ShardedQuantity&) = delete;
+
+    /**
+     * @brief Adds a quantity to slot of the calling thread.
+     *
+     * Quantity is converted to `Unit`, like by `AtomicQuantity::fetch_add()`.
+     */
+    template <typename U, typename T2>
+    inline void add(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_relaxed) noexcept{
+        slot().fetch_add(q, order);
+    }
+
+    /**
+     * @brief Subtracts a quantity from slot of the calling thread.
+     */
+    template <typename U, typename T2>
+    inline void sub(const Quantity<U, T2>& q, std::memory_order order = std::memory_order_relaxed) noexcept{
+        slot().fetch_sub(q, order);
+    }
+
+    template <typename U, typename T2>
+    inline ShardedQuantity& operator+=(const Quantity<U, T2>& q) noexcept{
+        add(q);
+        return *this;
+    }
+
+    template <typename U, typename T2>
+    inline ShardedQuantity& operator-=(const Quantity<U, T2>& q) noexcept{
+        sub(q);
+        return *this;
+    }
+
+    /**
+     * @brief Sum of all slots.
+     */
+    inline Quantity<Unit, T> load(std::memory_order order = std::memory_order_relaxed) const noexcept{
+        Quantity<Unit, T> sum(0);
+        for (const Slot& s: slots)
+            sum += s.q.load(order);
+        return sum;
+    }
+
+    inline operator Quantity<Unit, T>() const noexcept{
+        return load();
+    }
+
+    /**
+     * @brief Sets all slots to zero.
+     *
+     * Updates made by other threads during the call may be lost.
+     */
+    inline void reset() noexcept{
+        for (Slot& s: slots)
+            s.q.store(Quantity<Unit, T>(0), std::memory_order_relaxed);
+    }
+};
+
+}
+
+/**
+ * @brief Atomic quantities; see `LibUnit::AtomicQuantity`.
+ */
+template <typename Unit, typename T>
+class std::atomic<LibUnit::Quantity<Unit, T>>: public LibUnit::AtomicQuantity<Unit, T>{
+public:
+    using LibUnit::AtomicQuantity<Unit, T>::AtomicQuantity;
+    using LibUnit::AtomicQuantity<Unit, T>::operator=;
+};
+
+#endif // ATOMICQUANTITY_H
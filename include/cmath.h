@@ -6,233 +6,281 @@
 
 /**
  * @file cmath.h
+ *
+ * Overloads of `<cmath>` functions for quantities. Quantities of different
+ * units are converted to the unit of the first argument before the call.
+ *
+ * All overloads are declared `constexpr`, so they can be used in constant
+ * expressions whenever the underlying function of the standard library can.
+ *
+ * Underlying functions are found by argument-dependent lookup, besides
+ * functions of namespace `std`, so quantities of vector types (see simd.h)
+ * are dispatched to vector math of their own namespaces. Classification and
+ * comparison functions then return masks instead of `bool`.
  */
 
 namespace LibUnit{
 
 template <typename Unit, typename T>
-inline auto  modf(Quantity<Unit, T> q, T* intpart){
-    return Quantity<Unit, decltype(std::modf(q.t, intpart))>
-            (std::modf(q.t, intpart));
+inline constexpr auto modf(Quantity<Unit, T> q, T* intpart) noexcept(Helper::IsNothrow<T>::value){
+    using std::modf;
+    auto val = modf(q.value(), intpart);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto modf(Quantity<Unit, T> q, Quantity<U, T2>* intpart){
-    Quantity<Unit, T> intu;
-    Quantity<Unit, decltype(std::modf(q.value(), &intu.ref()))> result
-            (std::modf(q.value(), &intu.ref()));
+inline constexpr auto modf(Quantity<Unit, T> q, Quantity<U, T2>* intpart) noexcept(Helper::IsNothrow<T, T2>::value){
+    using std::modf;
+    Quantity<Unit, T> intu(0);
+    auto val = modf(q.value(), &intu.ref());
+    Quantity<Unit, decltype(val)> result(val);
 
     *intpart = intu;
     return result;
 }
 
 template <typename Unit, typename T>
-inline auto  ceil(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::ceil(q.value()))>
-            (std::ceil(q.value()));
+inline constexpr auto ceil(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::ceil;
+    auto val = ceil(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto  floor(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::floor(q.value()))>
-            (std::floor(q.value()));
+inline constexpr auto floor(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::floor;
+    auto val = floor(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto  fmod(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::fmod(q.value(), qp))>
-            (std::fmod(q.value(), qp.value()));
+inline constexpr auto fmod(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::fmod;
+    auto val = fmod(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto  trunc(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::trunc(q.value()))>
-            (std::trunc(q.value()));
+inline constexpr auto trunc(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::trunc;
+    auto val = trunc(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto  round(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::round(q.value()))>
-            (std::round(q.value()));
+inline constexpr auto round(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::round;
+    auto val = round(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto lround(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::lround(q.value()))>
-            (std::lround(q.value()));
+inline constexpr auto lround(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::lround;
+    auto val = lround(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto llround(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::llround(q.value()))>
-            (std::llround(q.value()));
+inline constexpr auto llround(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::llround;
+    auto val = llround(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto rint(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::rint(q.value()))>
-            (std::rint(q.value()));
+inline constexpr auto rint(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::rint;
+    auto val = rint(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto lrint(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::lrint(q.value()))>
-            (std::lrint(q.value()));
+inline constexpr auto lrint(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::lrint;
+    auto val = lrint(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto llrint(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::llrint(q.value()))>
-            (std::llrint(q.value()));
+inline constexpr auto llrint(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::llrint;
+    auto val = llrint(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto nearbyint(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::nearbyint(q.value()))>
-            (std::nearbyint(q.value()));
+inline constexpr auto nearbyint(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::nearbyint;
+    auto val = nearbyint(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
-template <typename Unit, typename T>
-inline auto remainder(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::remainder(q.value()))>
-            (std::remainder(q.value()));
+template <typename Unit, typename T, typename U, typename T2>
+inline constexpr auto remainder(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::remainder;
+    auto val = remainder(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
-template <typename Unit, typename T, typename U, typename T2>
-inline auto remquo(Quantity<Unit, T> q, Quantity<U, T2> p, Quantity<Unit, int>* quot){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::remquo(q.value(), qp, &quot->ref()))>(
-            (std::remquo(q.value(), qp, &quot->ref())));
+template <typename Unit, typename T, typename U, typename T2, typename Q>
+inline constexpr auto remquo(Quantity<Unit, T> q, Quantity<U, T2> p, Quantity<Unit, Q>* quot) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::remquo;
+    auto val = remquo(q.value(), qp, &quot->ref());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto copysign(Quantity<Unit, T> q, Quantity<U, T2> p){
-    return Quantity<Unit, decltype(std::copysign(q.value(), p.value()))>
-            (std::copysign(q.value(), p.value()));
+inline constexpr auto copysign(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    using std::copysign;
+    auto val = copysign(q.value(), p.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 // ToDo: figure out possibilites for different NAN-s for different types.
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto nextafter(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::nextafter(q.value(), qp))>
-            (std::nextafter(q.value(), qp));
+inline constexpr auto nextafter(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::nextafter;
+    auto val = nextafter(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U>
-inline auto nexttoward(Quantity<Unit, T> q, Quantity<U, long double> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::nexttoward(q.value(), qp))>
-            (std::nexttoward(q.value(), qp));
+inline constexpr auto nexttoward(Quantity<Unit, T> q, Quantity<U, long double> p) noexcept(Helper::IsNothrow<T>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::nexttoward;
+    auto val = nexttoward(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
-template <typename Unit, typename T, typename U>
-inline auto fdim(Quantity<Unit, T> q, Quantity<U, long double> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::fdim(q.value(), qp))>
-            (std::fdim(q.value(), qp));
+template <typename Unit, typename T, typename U, typename T2>
+inline constexpr auto fdim(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::fdim;
+    auto val = fdim(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto fmin(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::fmin(q.value(), qp))>
-            (std::fmin(q.value(), qp));
+inline constexpr auto fmin(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::fmin;
+    auto val = fmin(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline auto fmax(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return Quantity<Unit, decltype(std::fmax(q.value(), qp))>
-            (std::fmax(q.value(), qp));
+inline constexpr auto fmax(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::fmax;
+    auto val = fmax(q.value(), qp);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto fabs(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::fabs(q.value()))>
-            (std::fabs(q.value()));
+inline constexpr auto fabs(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::fabs;
+    auto val = fabs(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline auto abs(Quantity<Unit, T> q){
-    return Quantity<Unit, decltype(std::abs(q.value()))>
-            (std::abs(q.value()));
+inline constexpr auto abs(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::abs;
+    auto val = abs(q.value());
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T, typename U, typename T2, typename V, typename T3>
-inline auto fma(Quantity<Unit, T> q, Quantity<U, T2> p, Quantity<V, T3> r){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    auto qr = Quantity<Unit, T>::template convert<V>(r.value());
-    return Quantity<Unit, decltype(std::fma(q.value(), qp, qr))>
-            (std::fma(q.value(), qp, qr));
+inline constexpr auto fma(Quantity<Unit, T> q, Quantity<U, T2> p, Quantity<V, T3> r) noexcept(Helper::IsNothrow<T, T2, T3>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    auto qr = Convert<V, Unit>::value(r.value());
+    using std::fma;
+    auto val = fma(q.value(), qp, qr);
+    return Quantity<Unit, decltype(val)>(val);
 }
 
 template <typename Unit, typename T>
-inline int fpclassify(Quantity<Unit, T> q){
-    return std::fpclassify(q.value());
+inline constexpr auto fpclassify(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::fpclassify;
+    return fpclassify(q.value());
 }
 
 template <typename Unit, typename T>
-inline bool isfinite(Quantity<Unit, T> q){
-    return std::isfinite(q.value());
+inline constexpr auto isfinite(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::isfinite;
+    return isfinite(q.value());
 }
 
 template <typename Unit, typename T>
-inline bool isinf(Quantity<Unit, T> q){
-    return std::isinf(q.value());
+inline constexpr auto isinf(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::isinf;
+    return isinf(q.value());
 }
 
 template <typename Unit, typename T>
-inline bool isnan(Quantity<Unit, T> q){
-    return std::isnan(q.value());
+inline constexpr auto isnan(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::isnan;
+    return isnan(q.value());
 }
 
 template <typename Unit, typename T>
-inline bool isnormal(Quantity<Unit, T> q){
-    return std::isnormal(q.value());
+inline constexpr auto isnormal(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::isnormal;
+    return isnormal(q.value());
 }
 
 template <typename Unit, typename T>
-inline bool signbit(Quantity<Unit, T> q){
-    return std::signbit(q.value());
+inline constexpr auto signbit(Quantity<Unit, T> q) noexcept(Helper::IsNothrow<T>::value){
+    using std::signbit;
+    return signbit(q.value());
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool isgreater(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::isgreater(q.value(), qp);
+inline constexpr auto isgreater(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::isgreater;
+    return isgreater(q.value(), qp);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool isgreaterequal(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::isgreaterequal(q.value(), qp);
+inline constexpr auto isgreaterequal(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::isgreaterequal;
+    return isgreaterequal(q.value(), qp);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool isless(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::isless(q.value(), qp);
+inline constexpr auto isless(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::isless;
+    return isless(q.value(), qp);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool islessequal(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::islessequal(q.value(), qp);
+inline constexpr auto islessequal(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::islessequal;
+    return islessequal(q.value(), qp);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool islessgreater(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::islessgreater(q.value(), qp);
+inline constexpr auto islessgreater(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::islessgreater;
+    return islessgreater(q.value(), qp);
 }
 
 template <typename Unit, typename T, typename U, typename T2>
-inline bool isunordered(Quantity<Unit, T> q, Quantity<U, T2> p){
-    auto qp = Quantity<Unit, T>::template convert<U>(p.value());
-    return std::isunordered(q.value(), qp);
+inline constexpr auto isunordered(Quantity<Unit, T> q, Quantity<U, T2> p) noexcept(Helper::IsNothrow<T, T2>::value){
+    auto qp = Convert<U, Unit>::value(p.value());
+    using std::isunordered;
+    return isunordered(q.value(), qp);
 }
 
 
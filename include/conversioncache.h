@@ -0,0 +1,263 @@
+#ifndef CONVERSIONCACHE_H
+#define CONVERSIONCACHE_H
+
+#include "dynamicquantity.h"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+
+/**
+ * @file conversioncache.h
+ */
+
+namespace LibUnit{
+
+/**
+ * @brief Precomputed conversion between two units.
+ *
+ * Runtime counterpart of `Convert`: value expressed in source unit is
+ * converted to target unit as `value*factor + offset`. For units defined by
+ * LibUnit `offset` is always zero, and `factor` equals `RatioFactorOf` of
+ * both units. Plans are small and trivially copyable, so batch converters can
+ * keep them in registers.
+ */
+class ConversionPlan{
+public:
+    double factor = 1;  //!< Factor by which values are multiplied.
+    double offset = 0;  //!< Offset added after multiplication.
+
+    /**
+     * @brief Plan of conversion between static units `From` and `To`.
+     */
+    template <typename From, typename To>
+    static constexpr ConversionPlan of() noexcept{
+        checkConvertible<From, To>();
+        return ConversionPlan{static_cast<double>(RatioFactorOf<From, To>::value), 0};
+    }
+
+    /**
+     * @brief Plan of conversion between dynamic units.
+     *
+     * If dimensions of units are different, `DimensionError` is thrown.
+     */
+    static constexpr ConversionPlan between(const DynamicUnit& from, const DynamicUnit& to){
+        if (from.dimension != to.dimension)
+            throw DimensionError("Attempt to convert value between non-convertible units.");
+        return ConversionPlan{from.ratioTo(to), 0};
+    }
+
+    /**
+     * @brief Checks if plan leaves values unchanged.
+     */
+    constexpr bool isIdentity() const noexcept{
+        return factor == 1 && offset == 0;
+    }
+
+    /**
+     * @brief Converts a single value.
+     */
+    template <typename T>
+    constexpr auto apply(T t) const noexcept(Helper::IsNothrow<T>::value){
+        return t * factor + offset;
+    }
+
+    /**
+     * @brief Converts values in range `[first, last)` and stores them in
+     * range starting at `out`.
+     * @return end of output range.
+     */
+    template <typename InputIt, typename OutputIt>
+    constexpr OutputIt apply(InputIt first, InputIt last, OutputIt out) const{
+        double f = factor;
+        double o = offset;
+        for (; first != last; ++first, ++out)
+            *out = *first * f + o;
+        return out;
+    }
+
+    constexpr bool operator==(const ConversionPlan&) const noexcept = default;
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Identifier of a unit interned in `ConversionCache`. Zero is not a
+ * valid identifier.
+ */
+typedef std::uint32_t UnitId;
+
+/**
+ * @brief Concurrent cache of conversion plans between dynamic units.
+ *
+ * @tparam unitCapacity Maximal number of distinct interned units.
+ * @tparam planCapacity Maximal number of cached unit pairs.
+ *
+ * Units are first interned using `intern()`, which gives them small integer
+ * identifiers. Plans are then looked up by pairs of identifiers using
+ * `plan()`. The first lookup of a pair computes the plan and publishes it in
+ * the cache; following lookups only read it.
+ *
+ * Both tables are open addressing hash tables of fixed capacity, so cache
+ * never allocates after construction. Plan lookups are lock-free: they never
+ * wait for other threads. If a plan is being published by other thread, or
+ * plan table is full, plan is computed without caching and counted as a
+ * miss. Interning is not lock-free: it waits while other thread copies a
+ * unit into a slot it probes, so that the same unit never gets two
+ * identifiers. Intern units up front to keep it off hot paths.
+ *
+ * Cache is large, and meant to be shared by all threads of a process; make it
+ * a static or a long-lived heap object.
+ */
+template <int unitCapacity = 1024, int planCapacity = 4096>
+class ConversionCache{
+private:
+    static_assert(std::has_single_bit(unsigned(unitCapacity)) && std::has_single_bit(unsigned(planCapacity)),
+                  "Capacities must be powers of two.");
+    static_assert(unitCapacity < (1 << 30), "Too large unit capacity.");
+
+    static constexpr std::uint64_t empty = 0;
+    static constexpr std::uint64_t busy = std::uint64_t(1) << 63;
+
+    class UnitSlot{
+    public:
+        std::atomic<std::uint32_t> state{0}; // 0: empty, 1: being written, 2: ready.
+        DynamicUnit unit;
+    };
+
+    class PlanSlot{
+    public:
+        std::atomic<std::uint64_t> key{empty};
+        ConversionPlan plan;
+    };
+
+    UnitSlot units[unitCapacity];
+    PlanSlot plans[planCapacity];
+
+    alignas(64) std::atomic<std::uint64_t> hitCount{0};
+    alignas(64) std::atomic<std::uint64_t> missCount{0};
+
+    static constexpr std::uint64_t mix(std::uint64_t h) noexcept{
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        return h ^ (h >> 31);
+    }
+
+    static std::uint64_t hash(const DynamicUnit& u) noexcept{
+        return mix(u.dimension.packed() ^ mix(std::bit_cast<std::uint64_t>(u.factor)));
+    }
+
+    static bool sameUnit(const DynamicUnit& a, const DynamicUnit& b) noexcept{
+        return a.dimension == b.dimension
+            && std::bit_cast<std::uint64_t>(a.factor) == std::bit_cast<std::uint64_t>(b.factor);
+    }
+
+public:
+    ConversionCache() = default;
+    ConversionCache(const ConversionCache&) = delete;
+    ConversionCache& operator=(const ConversionCache&) = delete;
+
+    /**
+     * @brief Interns a unit.
+     * @return identifier of the unit; the same unit always gets the same
+     * identifier.
+     *
+     * May block while other thread interns a unit into a probed slot. Throws
+     * `std::length_error` if unit table is full.
+     */
+    UnitId intern(const DynamicUnit& unit){
+        std::uint64_t h = hash(unit);
+        for (int i=0; i<unitCapacity; i++){
+            int index = (h + i) & (unitCapacity - 1);
+            UnitSlot& slot = units[index];
+            std::uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (state == 0){
+                if (slot.state.compare_exchange_strong(state, 1, std::memory_order_acquire)){
+                    slot.unit = unit;
+                    slot.state.store(2, std::memory_order_release);
+                    slot.state.notify_all();
+                    return index + 1;
+                }
+            }
+            // Slot is claimed by other thread; block until its unit is visible.
+            while (state != 2){
+                slot.state.wait(state, std::memory_order_acquire);
+                state = slot.state.load(std::memory_order_acquire);
+            }
+            if (sameUnit(slot.unit, unit))
+                return index + 1;
+        }
+        throw std::length_error("Unit table of ConversionCache is full.");
+    }
+
+    /**
+     * @brief Interns static unit `Unit`.
+     */
+    template <typename Unit>
+    UnitId intern(){
+        return intern(DynamicUnit::of<Unit>());
+    }
+
+    /**
+     * @brief Unit with given identifier.
+     */
+    const DynamicUnit& unit(UnitId id) const noexcept{
+        return units[id - 1].unit;
+    }
+
+    /**
+     * @brief Conversion plan between units with given identifiers.
+     *
+     * If dimensions of units are different, `DimensionError` is thrown.
+     */
+    ConversionPlan plan(UnitId from, UnitId to){
+        std::uint64_t key = (std::uint64_t(from) << 32) | to;
+        std::uint64_t h = mix(key);
+        for (int i=0; i<planCapacity; i++){
+            PlanSlot& slot = plans[(h + i) & (planCapacity - 1)];
+            std::uint64_t current = slot.key.load(std::memory_order_acquire);
+            if (current == key){
+                hitCount.fetch_add(1, std::memory_order_relaxed);
+                return slot.plan;
+            }
+            if (current == empty){
+                ConversionPlan result = ConversionPlan::between(unit(from), unit(to));
+                missCount.fetch_add(1, std::memory_order_relaxed);
+                if (slot.key.compare_exchange_strong(current, key | busy, std::memory_order_acquire)){
+                    slot.plan = result;
+                    slot.key.store(key, std::memory_order_release);
+                }
+                return result;
+            }
+            if (current == (key | busy))
+                break;
+        }
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        return ConversionPlan::between(unit(from), unit(to));
+    }
+
+    /**
+     * @brief Conversion plan between two units; interns both of them.
+     */
+    ConversionPlan plan(const DynamicUnit& from, const DynamicUnit& to){
+        return plan(intern(from), intern(to));
+    }
+
+    /**
+     * @brief Number of plan lookups served from the cache.
+     */
+    std::uint64_t hits() const noexcept{
+        return hitCount.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of plan lookups that required computing a plan.
+     */
+    std::uint64_t misses() const noexcept{
+        return missCount.load(std::memory_order_relaxed);
+    }
+};
+
+}
+
+#endif // CONVERSIONCACHE_H
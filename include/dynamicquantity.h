@@ -0,0 +1,741 @@
+#ifndef DYNAMICQUANTITY_H
+#define DYNAMICQUANTITY_H
+
+#include "quantity.h"
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @file dynamicquantity.h
+ */
+
+namespace LibUnit{
+
+/**
+ * @brief Exception thrown when dimensions of dynamic quantities do not match.
+ */
+class DimensionError: public std::domain_error{
+public:
+    using std::domain_error::domain_error;
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Class representing a dimension known only at runtime.
+ *
+ * Exponents of base dimensions (see `DimensionVector`) are packed into a
+ * single 64-bit word, one signed 8-bit exponent per byte. Slot `i` of
+ * `DimensionVector` is stored in `i`-th least significant byte. Dimensions
+ * are compared by comparing their words, and multiplied or divided by adding
+ * or subtracting all exponents at once, without carries between bytes.
+ *
+ * Exponents must be in range `[-128, 127]`. Operations producing exponents
+ * out of this range throw `DimensionError`.
+ */
+class DynamicDimension{
+private:
+    static constexpr std::uint64_t low = 0x7f7f7f7f7f7f7f7full;
+    static constexpr std::uint64_t high = 0x8080808080808080ull;
+
+    std::uint64_t word = 0;
+
+    constexpr explicit DynamicDimension(std::uint64_t w) noexcept
+        :word(w)
+    {}
+
+public:
+    /**
+     * @brief Constructs dimensionless dimension.
+     */
+    constexpr DynamicDimension() noexcept = default;
+
+    /**
+     * @brief Constructs dimension from a vector of exponents.
+     */
+    constexpr DynamicDimension(const DimensionVector& v) noexcept{
+        for (int i=0; i<DimensionVector::size; i++)
+            word |= std::uint64_t(std::uint8_t(v.exponents[i])) << (8*i);
+    }
+
+    /**
+     * @brief Constructs dimension from its packed representation.
+     */
+    static constexpr DynamicDimension fromWord(std::uint64_t w) noexcept{
+        return DynamicDimension(w);
+    }
+
+    /**
+     * @brief Packed representation of the dimension.
+     */
+    constexpr std::uint64_t packed() const noexcept{
+        return word;
+    }
+
+    /**
+     * @brief Exponent of base dimension in slot `index`.
+     */
+    constexpr int exponent(int index) const noexcept{
+        return std::int8_t(std::uint8_t(word >> (8*index)));
+    }
+
+    /**
+     * @brief Vector of exponents of the dimension.
+     */
+    constexpr DimensionVector vector() const noexcept{
+        DimensionVector result;
+        for (int i=0; i<DimensionVector::size; i++)
+            result.exponents[i] = exponent(i);
+        return result;
+    }
+
+    /**
+     * @brief Checks if all exponents are equal to zero.
+     */
+    constexpr bool isDimensionless() const noexcept{
+        return word == 0;
+    }
+
+    constexpr bool operator==(const DynamicDimension&) const noexcept = default;
+
+    /**
+     * @brief Dimension of a product; adds exponents.
+     *
+     * Exponent overflows if both operands have the same sign and the sum has
+     * a different one.
+     */
+    constexpr DynamicDimension operator*(const DynamicDimension& d) const{
+        std::uint64_t result = ((word & low) + (d.word & low)) ^ ((word ^ d.word) & high);
+        if (~(word ^ d.word) & (word ^ result) & high)
+            throw DimensionError("Dimension exponent out of range.");
+        return DynamicDimension(result);
+    }
+
+    /**
+     * @brief Dimension of a quotient; subtracts exponents.
+     *
+     * Exponent overflows if operands have different signs and the difference
+     * has a different sign than the first operand.
+     */
+    constexpr DynamicDimension operator/(const DynamicDimension& d) const{
+        std::uint64_t result = ((word | high) - (d.word & low)) ^ ((word ^ ~d.word) & high);
+        if ((word ^ d.word) & (word ^ result) & high)
+            throw DimensionError("Dimension exponent out of range.");
+        return DynamicDimension(result);
+    }
+
+    /**
+     * @brief Dimension raised to an integral power; multiplies exponents.
+     */
+    constexpr DynamicDimension pow(int power) const{
+        DimensionVector result;
+        for (int i=0; i<DimensionVector::size; i++){
+            long long e = static_cast<long long>(exponent(i)) * power;
+            if (e < std::numeric_limits<std::int8_t>::min() || e > std::numeric_limits<std::int8_t>::max())
+                throw DimensionError("Dimension exponent out of range.");
+            result.exponents[i] = static_cast<int>(e);
+        }
+        return DynamicDimension(result);
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Class representing a unit known only at runtime.
+ *
+ * Dynamic unit consists of its dimension and a factor, which has the same
+ * meaning as `FactorOf` of static units. Dynamic units can be created from
+ * static ones using `DynamicUnit::of()`.
+ */
+class DynamicUnit{
+public:
+    DynamicDimension dimension; //!< Dimension of the unit.
+    double factor = 1;          //!< Factor of the unit.
+
+    /**
+     * @brief Constructs dimensionless unit of factor one.
+     */
+    constexpr DynamicUnit() noexcept = default;
+
+    /**
+     * @brief Constructs unit of given dimension and factor.
+     */
+    constexpr DynamicUnit(DynamicDimension d, double f = 1) noexcept
+        :dimension(d), factor(f)
+    {}
+
+    /**
+     * @brief Dynamic unit equivalent to static unit `Unit`.
+     *
+     * All base dimensions of `Unit` must have slots assigned by
+     * `BaseDimensionIndex`, otherwise compilation error is generated.
+     */
+    template <typename Unit>
+    static constexpr DynamicUnit of() noexcept{
+        static_assert(DimensionVectorOf<Unit>::representable, "Unit dimension has no DimensionVector representation.");
+        constexpr DimensionVector v = DimensionVectorOf<Unit>::value;
+        static_assert(DynamicDimension(v).vector() == v, "Unit dimension exponents out of range.");
+        return DynamicUnit(v, FactorOf<Unit>::value.template as<double>());
+    }
+
+    /**
+     * @brief Factor by which values in this unit are multiplied to express
+     * them in unit `u`.
+     */
+    constexpr double ratioTo(const DynamicUnit& u) const noexcept{
+        return factor / u.factor;
+    }
+
+    constexpr bool operator==(const DynamicUnit&) const noexcept = default;
+
+    /**
+     * @brief Product of units.
+     *
+     * If exponents of resulting dimension are out of range, `DimensionError`
+     * is thrown.
+     */
+    constexpr DynamicUnit operator*(const DynamicUnit& u) const{
+        return DynamicUnit(dimension * u.dimension, factor * u.factor);
+    }
+
+    /**
+     * @brief Quotient of units.
+     *
+     * If exponents of resulting dimension are out of range, `DimensionError`
+     * is thrown.
+     */
+    constexpr DynamicUnit operator/(const DynamicUnit& u) const{
+        return DynamicUnit(dimension / u.dimension, factor / u.factor);
+    }
+};
+
+/**
+ * @brief Exact description of a unit, stored with values in files or shared
+ * memory.
+ *
+ * Signature consists of packed dimension (see `DynamicDimension`) and exact
+ * factor (see `ExactFactor`), so signatures of two units are equal only if
+ * values in both units are the same, and ratio of their factors can be
+ * computed exactly. Signature is trivially copyable and has fixed size and
+ * layout on all platforms of the same byte order.
+ */
+class UnitSignature{
+public:
+    std::uint64_t dimension = 0;    //!< Packed dimension of the unit.
+    std::int64_t numerator = 1;     //!< Numerator of rational part of the factor.
+    std::int64_t denominator = 1;   //!< Denominator of rational part of the factor.
+    std::int32_t exponent = 0;      //!< Power of ten of the factor.
+    std::int32_t piExponent = 0;    //!< Power of π of the factor.
+    double inexact = 1;             //!< Inexact part of the factor.
+
+    /**
+     * @brief Signature of static unit `Unit`.
+     *
+     * All base dimensions of `Unit` must have slots assigned by
+     * `BaseDimensionIndex`, otherwise compilation error is generated.
+     */
+    template <typename Unit>
+    static constexpr UnitSignature of() noexcept{
+        constexpr DynamicUnit unit = DynamicUnit::of<Unit>();
+        constexpr ExactFactor f = FactorOf<Unit>::value;
+        UnitSignature result;
+        result.dimension = unit.dimension.packed();
+        result.numerator = f.numerator;
+        result.denominator = f.denominator;
+        result.exponent = f.exponent;
+        result.piExponent = f.piExponent;
+        result.inexact = f.inexact;
+        return result;
+    }
+
+    /**
+     * @brief Dimension of the unit.
+     */
+    constexpr DynamicDimension dynamicDimension() const noexcept{
+        return DynamicDimension::fromWord(dimension);
+    }
+
+    /**
+     * @brief Exact factor of the unit.
+     */
+    constexpr ExactFactor factor() const noexcept{
+        ExactFactor result;
+        result.numerator = numerator;
+        result.denominator = denominator;
+        result.exponent = exponent;
+        result.piExponent = piExponent;
+        result.inexact = inexact;
+        return result;
+    }
+
+    /**
+     * @brief Dynamic unit described by the signature.
+     */
+    constexpr DynamicUnit unit() const noexcept{
+        return DynamicUnit(dynamicDimension(), factor().as<double>());
+    }
+
+    /**
+     * @brief Checks if signature describes a valid factor.
+     *
+     * Rational part must be positive and normalized like by `ExactFactor`,
+     * and inexact part positive and finite. Exponents are limited, so that
+     * the factor is computed in bounded time; it must be a finite, nonzero
+     * `double`. Signatures read from files should be checked before use.
+     */
+    constexpr bool isValid() const noexcept{
+        constexpr std::int32_t maxExponent = 4096;
+        if (numerator <= 0 || denominator <= 0 || !(inexact > 0 && inexact <= std::numeric_limits<double>::max())
+                || exponent < -maxExponent || exponent > maxExponent || piExponent < -maxExponent || piExponent > maxExponent)
+            return false;
+        ExactFactor normalized(numerator, denominator, exponent, piExponent);
+        normalized.inexact = inexact;
+        if (normalized != factor())
+            return false;
+        double value = normalized.as<double>();
+        return value > 0 && value <= std::numeric_limits<double>::max();
+    }
+
+    constexpr bool operator==(const UnitSignature&) const noexcept = default;
+};
+
+static_assert(sizeof(UnitSignature) == 40, "Unexpected layout of UnitSignature.");
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Code of underlying type of stored values: its kind and size.
+ */
+template <typename T>
+inline constexpr std::uint32_t valueTypeCode() noexcept{
+    static_assert(std::is_arithmetic<T>::value, "Stored quantities must have arithmetic underlying type.");
+    return (std::is_floating_point<T>::value ? 0x100 : std::is_signed<T>::value ? 0x200 : 0x300) | sizeof(T);
+}
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief DynamicQuantity class represents a variable of type T coupled with a
+ * unit known only at runtime.
+ *
+ * Template parameters:
+ *  - T: Underlying type that is used to store the value.
+ *
+ * DynamicQuantity is meant to be used where units depend on runtime data, ie.
+ * when values are read from a source that reports their units. Dimensions are
+ * checked at runtime; each check is a single comparison of 64-bit words. If
+ * dimensions of quantities used in an operation differ, `DimensionError` is
+ * thrown.
+ *
+ * Any `Quantity` can be implicitly converted to DynamicQuantity; its unit is
+ * computed at compile time. Arithmetic and comparison operators also accept
+ * a `Quantity` as either operand, converting it the same way; result of
+ * such an operation is a DynamicQuantity. DynamicQuantity can be converted to `Quantity` of
+ * any unit of the same dimension using `to()` or explicit conversion. This
+ * way dimension is checked once, and further computation can use static
+ * quantities.
+ */
+template <typename T = double>
+class DynamicQuantity{
+private:
+    T t;
+    DynamicUnit u;
+
+    inline constexpr void checkCompatible(const DynamicUnit& unit) const{
+        if (unit.dimension != u.dimension)
+            throw DimensionError("Quantities of unequal dimensions!!!");
+    }
+
+    template <typename T2>
+    inline constexpr auto convert(const DynamicQuantity<T2>& q) const{
+        checkCompatible(q.unit());
+        return q.unit().factor == u.factor ? q.value() : q.value() * q.unit().ratioTo(u);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr auto convert(const Quantity<Unit, T2>& q) const{
+        return convert(DynamicQuantity<T2>(q));
+    }
+
+public:
+    /**
+     * @brief Constructs a dimensionless quantity with default-initialized value.
+     */
+    DynamicQuantity() = default;
+
+    /**
+     * @brief Constructs a quantity with a given value and unit.
+     */
+    inline constexpr DynamicQuantity(T value, const DynamicUnit& unit) noexcept(Helper::IsNothrow<T>::value)
+        :t(value), u(unit)
+    {}
+
+    /**
+     * @brief Constructs a quantity from a static quantity.
+     *
+     * Unit of constructed quantity is computed at compile time, and no
+     * conversion of value is performed.
+     */
+    template <typename Unit, typename T2>
+    inline constexpr DynamicQuantity(const Quantity<Unit, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
+        :t(q.value()), u(DynamicUnit::of<Unit>())
+    {}
+
+    /**
+     * @brief Converts to a static quantity of unit `Unit`.
+     *
+     * Value is scaled from unit of this quantity to `Unit`. If dimensions are
+     * different, `DimensionError` is thrown.
+     */
+    template <typename Unit, typename T2 = T>
+    inline constexpr Quantity<Unit, T2> to() const{
+        constexpr DynamicUnit unit = DynamicUnit::of<Unit>();
+        checkCompatible(unit);
+        if (u.factor == unit.factor)
+            return Quantity<Unit, T2>(t);
+        return Quantity<Unit, T2>(t * u.ratioTo(unit));
+    }
+
+    /**
+     * @brief Explicit conversion to a static quantity; same as `to()`.
+     */
+    template <typename Unit, typename T2>
+    inline constexpr explicit operator Quantity<Unit, T2>() const{
+        return to<Unit, T2>();
+    }
+
+    /**
+     * @brief Quantity expressed in a different unit of the same dimension.
+     *
+     * If dimensions are different, `DimensionError` is thrown.
+     */
+    inline constexpr auto in(const DynamicUnit& unit) const{
+        checkCompatible(unit);
+        auto val = t * u.ratioTo(unit);
+        return DynamicQuantity<decltype(val)>(val, unit);
+    }
+
+    //-----------------------------------------------------------------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Adds a quantity of the same dimension.
+     * @return quantity instance of the same unit as leftside quantity.
+     *
+     * Scaling between different units is performed before addition. If
+     * dimensions are different, `DimensionError` is thrown.
+     */
+    template <typename T2>
+    inline constexpr auto operator+(const DynamicQuantity<T2>& q) const{
+        auto val = t + convert(q);
+        return DynamicQuantity<decltype(val)>(val, u);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr auto operator+(const Quantity<Unit, T2>& q) const{
+        auto val = t + convert(q);
+        return DynamicQuantity<decltype(val)>(val, u);
+    }
+
+    /**
+     * @brief Subtracts a quantity of the same dimension.
+     * @return quantity instance of the same unit as leftside quantity.
+     *
+     * Scaling between different units is performed before subtraction. If
+     * dimensions are different, `DimensionError` is thrown.
+     */
+    template <typename T2>
+    inline constexpr auto operator-(const DynamicQuantity<T2>& q) const{
+        auto val = t - convert(q);
+        return DynamicQuantity<decltype(val)>(val, u);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr auto operator-(const Quantity<Unit, T2>& q) const{
+        auto val = t - convert(q);
+        return DynamicQuantity<decltype(val)>(val, u);
+    }
+
+    /**
+     * @brief Additive inverse operator.
+     */
+    inline constexpr auto operator-() const noexcept(Helper::IsNothrow<T>::value){
+        auto val = -t;
+        return DynamicQuantity<decltype(val)>(val, u);
+    }
+
+    template <typename T2>
+    inline constexpr DynamicQuantity& operator+=(const DynamicQuantity<T2>& q){
+        t += convert(q);
+        return *this;
+    }
+
+    template <typename T2>
+    inline constexpr DynamicQuantity& operator-=(const DynamicQuantity<T2>& q){
+        t -= convert(q);
+        return *this;
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr DynamicQuantity& operator+=(const Quantity<Unit, T2>& q){
+        t += convert(q);
+        return *this;
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr DynamicQuantity& operator-=(const Quantity<Unit, T2>& q){
+        t -= convert(q);
+        return *this;
+    }
+
+    //-----------------------------------------------------------------------------------------------------------------------------------------------------
+
+    /**
+     * @name Comparison operators.
+     *
+     * Perform comparison between quantities of the same dimension and possibly
+     * different units; other quantity can be dynamic or static. If dimensions
+     * are different, `DimensionError` is thrown.
+     */
+    //@{
+    template <typename T2>
+    inline constexpr bool operator==(const DynamicQuantity<T2>& q) const{
+        return t == convert(q);
+    }
+
+    template <typename T2>
+    inline constexpr bool operator!=(const DynamicQuantity<T2>& q) const{
+        return t != convert(q);
+    }
+
+    template <typename T2>
+    inline constexpr bool operator<(const DynamicQuantity<T2>& q) const{
+        return t < convert(q);
+    }
+
+    template <typename T2>
+    inline constexpr bool operator>(const DynamicQuantity<T2>& q) const{
+        return t > convert(q);
+    }
+
+    template <typename T2>
+    inline constexpr bool operator<=(const DynamicQuantity<T2>& q) const{
+        return t <= convert(q);
+    }
+
+    template <typename T2>
+    inline constexpr bool operator>=(const DynamicQuantity<T2>& q) const{
+        return t >= convert(q);
+    }
+
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator==(const Quantity<Unit, T2>& q) const{
+        return t == convert(q);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator!=(const Quantity<Unit, T2>& q) const{
+        return t != convert(q);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator<(const Quantity<Unit, T2>& q) const{
+        return t < convert(q);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator>(const Quantity<Unit, T2>& q) const{
+        return t > convert(q);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator<=(const Quantity<Unit, T2>& q) const{
+        return t <= convert(q);
+    }
+
+    template <typename Unit, typename T2>
+    inline constexpr bool operator>=(const Quantity<Unit, T2>& q) const{
+        return t >= convert(q);
+    }
+    //@}
+
+    //-----------------------------------------------------------------------------------------------------------------------------------------------------
+
+    /**
+     * @brief Internal value of quantity.
+     */
+    inline constexpr T value() const noexcept(Helper::IsNothrow<T>::value){
+        return t;
+    }
+
+    /**
+     * @brief Unit of quantity.
+     */
+    inline constexpr const DynamicUnit& unit() const noexcept{
+        return u;
+    }
+
+    /**
+     * @brief Dimension of quantity.
+     */
+    inline constexpr DynamicDimension dimension() const noexcept{
+        return u.dimension;
+    }
+};
+
+/**
+ * @brief DynamicQuantity multiplication operator.
+ * @return Quantity of product of units and underlying type same as result of
+ * multiplication of underlying types of operands.
+ *
+ * If exponents of resulting dimension are out of range, `DimensionError` is
+ * thrown.
+ */
+template <typename T, typename T2>
+inline constexpr auto operator*(const DynamicQuantity<T>& p, const DynamicQuantity<T2>& q)
+{
+    auto val = p.value()*q.value();
+    return DynamicQuantity<decltype(val)>(val, p.unit()*q.unit());
+}
+
+/**
+ * @brief DynamicQuantity division operator.
+ * @return Quantity of quotient of units and underlying type same as result of
+ * division of underlying types of operands.
+ *
+ * If exponents of resulting dimension are out of range, `DimensionError` is
+ * thrown.
+ */
+template <typename T, typename T2>
+inline constexpr auto operator/(const DynamicQuantity<T>& p, const DynamicQuantity<T2>& q)
+{
+    auto val = p.value()/q.value();
+    return DynamicQuantity<decltype(val)>(val, p.unit()/q.unit());
+}
+
+/**
+ * @name Mixed operators.
+ *
+ * Arithmetic and comparison of a static quantity with a dynamic one. Static
+ * quantity is converted to DynamicQuantity first, and result is a
+ * DynamicQuantity. Operators taking DynamicQuantity as the left operand are
+ * members of DynamicQuantity, except multiplication and division.
+ */
+//@{
+template <typename T, typename Unit, typename T2>
+inline constexpr auto operator*(const DynamicQuantity<T>& p, const Quantity<Unit, T2>& q){
+    return p * DynamicQuantity<T2>(q);
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr auto operator*(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) * q;
+}
+
+template <typename T, typename Unit, typename T2>
+inline constexpr auto operator/(const DynamicQuantity<T>& p, const Quantity<Unit, T2>& q){
+    return p / DynamicQuantity<T2>(q);
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr auto operator/(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) / q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr auto operator+(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) + q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr auto operator-(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) - q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator==(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) == q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator!=(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) != q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator<(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) < q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator>(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) > q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator<=(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) <= q;
+}
+
+template <typename Unit, typename T, typename T2>
+inline constexpr bool operator>=(const Quantity<Unit, T>& p, const DynamicQuantity<T2>& q){
+    return DynamicQuantity<T>(p) >= q;
+}
+//@}
+
+/**
+ * @brief DynamicQuantity multiplication operator for non-quantity values.
+ */
+template <typename T, typename U>
+inline constexpr auto operator*(const DynamicQuantity<T>& p, const U& u) noexcept(noexcept(p.value()*u))
+{
+    auto val = p.value()*u;
+    return DynamicQuantity<decltype(val)>(val, p.unit());
+}
+
+/**
+ * @brief DynamicQuantity multiplication operator for non-quantity values.
+ */
+template <typename U, typename T>
+inline constexpr auto operator*(const U& u, const DynamicQuantity<T>& p) noexcept(noexcept(u*p.value()))
+{
+    auto val = u*p.value();
+    return DynamicQuantity<decltype(val)>(val, p.unit());
+}
+
+/**
+ * @brief DynamicQuantity division operator for non-quantity values.
+ */
+template <typename T, typename U>
+inline constexpr auto operator/(const DynamicQuantity<T>& p, const U& u) noexcept(noexcept(p.value()/u))
+{
+    auto val = p.value()/u;
+    return DynamicQuantity<decltype(val)>(val, p.unit());
+}
+
+/**
+ * @brief DynamicQuantity division operator for non-quantity values.
+ * @return Quantity of inverted unit of `p`.
+ *
+ * If exponents of inverted dimension are out of range, `DimensionError` is
+ * thrown.
+ */
+template <typename U, typename T>
+inline constexpr auto operator/(const U& u, const DynamicQuantity<T>& p)
+{
+    auto val = u/p.value();
+    return DynamicQuantity<decltype(val)>(val, DynamicUnit()/p.unit());
+}
+
+}
+
+#endif // DYNAMICQUANTITY_H
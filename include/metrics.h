@@ -0,0 +1,599 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "atomicquantity.h"
+#include "symbol.h"
+#include "units/SI.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @file metrics.h
+ *
+ * Metrics of quantities, and their exposition in text format of Prometheus.
+ *
+ * Counters, gauges and histograms are typed by unit of measured quantities,
+ * so they are updated with quantities of any unit of the right dimension,
+ * which are converted at compile time. Updates are atomic operations on a
+ * single value (see `AtomicQuantity`), and never take locks.
+ *
+ * When exported, every metric is converted to the coherent SI unit of its
+ * dimension (ie. seconds, kilograms, joules), and name of that unit, as
+ * spelled by Prometheus, is appended to name of the metric (see
+ * `MetricUnitOf`).
+ */
+
+namespace LibUnit{
+
+class MetricsRegistry;
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Name of a coherent SI unit in metric names, as spelled by
+ * Prometheus.
+ *
+ * Specializations define `singular` and `plural` names; units without them
+ * are not used in exported metrics.
+ */
+template <typename Unit>
+class MetricUnitName;
+
+/** @cond DOXYGEN_EXCLUDE */
+template <> class MetricUnitName<Metre>{ public: static constexpr std::string_view singular = "meter", plural = "meters"; };
+template <> class MetricUnitName<Kilo<Gram>>{ public: static constexpr std::string_view singular = "kilogram", plural = "kilograms"; };
+template <> class MetricUnitName<Second>{ public: static constexpr std::string_view singular = "second", plural = "seconds"; };
+template <> class MetricUnitName<Ampere>{ public: static constexpr std::string_view singular = "ampere", plural = "amperes"; };
+template <> class MetricUnitName<Kelvin>{ public: static constexpr std::string_view singular = "kelvin", plural = "kelvins"; };
+template <> class MetricUnitName<Mole>{ public: static constexpr std::string_view singular = "mole", plural = "moles"; };
+template <> class MetricUnitName<Candela>{ public: static constexpr std::string_view singular = "candela", plural = "candelas"; };
+
+template <> class MetricUnitName<Newton>{ public: static constexpr std::string_view singular = "newton", plural = "newtons"; };
+template <> class MetricUnitName<Pascal>{ public: static constexpr std::string_view singular = "pascal", plural = "pascals"; };
+template <> class MetricUnitName<Joule>{ public: static constexpr std::string_view singular = "joule", plural = "joules"; };
+template <> class MetricUnitName<Watt>{ public: static constexpr std::string_view singular = "watt", plural = "watts"; };
+template <> class MetricUnitName<Coulomb>{ public: static constexpr std::string_view singular = "coulomb", plural = "coulombs"; };
+template <> class MetricUnitName<Volt>{ public: static constexpr std::string_view singular = "volt", plural = "volts"; };
+template <> class MetricUnitName<Farad>{ public: static constexpr std::string_view singular = "farad", plural = "farads"; };
+template <> class MetricUnitName<Ohm>{ public: static constexpr std::string_view singular = "ohm", plural = "ohms"; };
+template <> class MetricUnitName<Siemens>{ public: static constexpr std::string_view singular = "siemens", plural = "siemens"; };
+template <> class MetricUnitName<Weber>{ public: static constexpr std::string_view singular = "weber", plural = "webers"; };
+template <> class MetricUnitName<Tesla>{ public: static constexpr std::string_view singular = "tesla", plural = "teslas"; };
+template <> class MetricUnitName<Henry>{ public: static constexpr std::string_view singular = "henry", plural = "henries"; };
+template <> class MetricUnitName<Katal>{ public: static constexpr std::string_view singular = "katal", plural = "katals"; };
+/** @endcond */
+
+/**
+ * @brief Coherent SI unit of a base dimension.
+ */
+template <typename Dimension>
+class BaseMetricUnit{
+public:
+    static_assert(sizeof(Dimension) == 0, "Base dimension has no SI unit.");
+};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <> class BaseMetricUnit<Length>{ public: typedef Metre Type; };
+template <> class BaseMetricUnit<Mass>{ public: typedef Kilo<Gram> Type; };
+template <> class BaseMetricUnit<Time>{ public: typedef Second Type; };
+template <> class BaseMetricUnit<ElectricCurrent>{ public: typedef Ampere Type; };
+template <> class BaseMetricUnit<ThermodynamicTemperature>{ public: typedef Kelvin Type; };
+template <> class BaseMetricUnit<SubstanceAmount>{ public: typedef Mole Type; };
+template <> class BaseMetricUnit<LuminousIntensity>{ public: typedef Candela Type; };
+/** @endcond */
+
+/**
+ * @brief Finds the first of named derived units of the same dimension as
+ * `Unit`, or `void`.
+ *
+ * Hertz, gray and lux are not listed, as their dimensions are shared with
+ * becquerel, sievert and luminance.
+ */
+template <typename Unit, typename ...Named>
+class NamedMetricUnit{
+public:
+    typedef void Type;
+};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename First, typename ...Rest>
+class NamedMetricUnit<Unit, First, Rest...>{
+public:
+    typedef typename std::conditional<IsEqualDimension<Unit, First>::value, First,
+                                      typename NamedMetricUnit<Unit, Rest...>::Type>::type Type;
+};
+/** @endcond */
+
+/**
+ * @brief Helper class used to build unit of exported metrics from coherent
+ * SI units of base dimensions, and to write its suffix.
+ *
+ * Units with positive powers are written first, in plural and separated by
+ * `_`, then `per_` and the ones with negative powers in singular. Powers
+ * other than one follow names, ie. `meters_per_second2`.
+ */
+template <typename Dimension>
+class BaseMetricUnits: public BaseMetricUnits<Compound<Dimension>>{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename ...Args>
+class BaseMetricUnits<Compound<Args...>>{
+public:
+    typedef Compound<Power<typename BaseMetricUnit<typename SymbolMember<Args>::Base>::Type, SymbolMember<Args>::power>...> Type;
+
+private:
+    template <typename M>
+    static constexpr void appendName(SymbolBuffer& b, bool plural){
+        typedef MetricUnitName<typename BaseMetricUnit<typename M::Base>::Type> Name;
+        b.append(plural ? Name::plural : Name::singular);
+        int power = M::power < 0 ? -M::power : M::power;
+        if (power != 1)
+            b.appendNumber(power);
+    }
+
+public:
+    static constexpr void write(SymbolBuffer& b){
+        [[maybe_unused]] bool first = true;
+        ([&](){
+            typedef SymbolMember<Args> M;
+            if constexpr (M::power > 0){
+                if (!first)
+                    b.append("_");
+                first = false;
+                appendName<M>(b, true);
+            }
+        }(), ...);
+        [[maybe_unused]] bool per = false;
+        ([&](){
+            typedef SymbolMember<Args> M;
+            if constexpr (M::power < 0){
+                if (!first)
+                    b.append("_");
+                first = false;
+                if (!per)
+                    b.append("per_");
+                per = true;
+                appendName<M>(b, false);
+            }
+        }(), ...);
+    }
+};
+/** @endcond */
+
+/**
+ * @brief Selects unit of exported metrics: a named derived unit if there is
+ * one, or a compound of base units otherwise.
+ */
+template <typename Unit, typename Named = typename NamedMetricUnit<Unit, Newton, Pascal, Joule, Watt, Coulomb, Volt, Farad,
+                                                                   Ohm, Siemens, Weber, Tesla, Henry, Katal>::Type>
+class MetricUnit{
+public:
+    typedef Named Type;
+
+    static constexpr void write(SymbolBuffer& b){
+        b.append(MetricUnitName<Named>::plural);
+    }
+};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit>
+class MetricUnit<Unit, void>: public BaseMetricUnits<LibUnit::Simplify<LibUnit::DimensionOf<Unit>>>{};
+/** @endcond */
+
+/**
+ * @brief Writes a number in shortest form that reads back exactly.
+ *
+ * Infinities and NaN are written as `+Inf`, `-Inf` and `NaN`, as required by
+ * the text format.
+ */
+inline void writeNumber(std::ostream& s, double value){
+    if (std::isnan(value)){
+        s << "NaN";
+        return;
+    }
+    if (std::isinf(value)){
+        s << (value > 0 ? "+Inf" : "-Inf");
+        return;
+    }
+    char buffer[32];
+    std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    s.write(buffer, result.ptr - buffer);
+}
+
+/**
+ * @brief Base class of metrics, which are kept by `MetricsRegistry`.
+ */
+class Metric{
+private:
+    friend class LibUnit::MetricsRegistry;
+
+    Metric* next = nullptr;
+
+protected:
+    std::string name;
+    std::string help;
+
+    Metric(std::string_view name, std::string_view help)
+        :name(name), help(help)
+    {
+        if (name.empty() || (name[0] >= '0' && name[0] <= '9')
+                || name.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_:") != std::string_view::npos)
+            throw std::invalid_argument("Invalid metric name.");
+    }
+
+    // Writes HELP and TYPE lines of a metric; backslashes and line feeds of
+    // help text are escaped.
+    void writeHeader(std::ostream& s, std::string_view fullName, const char* type) const{
+        if (!help.empty()){
+            s << "# HELP " << fullName << ' ';
+            for (char c: help){
+                if (c == '\\')
+                    s << "\\\\";
+                else if (c == '\n')
+                    s << "\\n";
+                else
+                    s << c;
+            }
+            s << '\n';
+        }
+        s << "# TYPE " << fullName << ' ' << type << '\n';
+    }
+
+public:
+    virtual ~Metric() = default;
+
+    /**
+     * @brief Writes the metric in text exposition format.
+     */
+    virtual void write(std::ostream& s) const = 0;
+};
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Unit in which metrics of quantities of unit `Unit` are exported.
+ *
+ * @tparam Unit Unit of measured quantities.
+ *
+ * `Type` is the coherent SI unit of the same dimension as `Unit`, and
+ * `suffix` is its name. Named derived units are used where one has the
+ * dimension of `Unit`, ie. `joules` for `Kilo<Joule>`; other units are
+ * composed of metres, kilograms, seconds, amperes, kelvins, moles and
+ * candelas, ie. `seconds` for `Mili<Second>` or `meters_per_second` for
+ * `Compound<Kilo<Metre>, Power<Hour, -1>>`. Dimensionless units have empty
+ * suffix.
+ *
+ * @remark
+ * Specialize this class to export metrics of a unit in other unit, ie.
+ * frequencies in `Herz` with suffix `hertz`.
+ */
+template <typename Unit>
+class MetricUnitOf{
+private:
+    static constexpr Helper::SymbolBuffer buffer = [](){
+        Helper::SymbolBuffer b;
+        Helper::MetricUnit<Unit>::write(b);
+        return b;
+    }();
+
+public:
+    typedef typename Helper::MetricUnit<Unit>::Type Type;  //!< Unit of exported values.
+
+    static constexpr std::string_view suffix = std::string_view(buffer.data, buffer.size);
+    //!< Name of `Type`, appended to metric names.
+};
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Name of metric of unit `Unit` followed by its unit suffix.
+ */
+template <typename Unit>
+inline std::string metricName(std::string_view name, std::string_view ending = {}){
+    std::string result(name);
+    if (!MetricUnitOf<Unit>::suffix.empty()){
+        result += '_';
+        result += MetricUnitOf<Unit>::suffix;
+    }
+    result += ending;
+    return result;
+}
+
+/**
+ * @brief Value of a quantity in unit in which it is exported.
+ */
+template <typename Unit, typename T>
+inline double exportedValue(const Quantity<Unit, T>& q){
+    return Quantity<typename MetricUnitOf<Unit>::Type, double>(q).value();
+}
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Metric of a quantity which only increases, ie. total energy or
+ * total time spent.
+ *
+ * @tparam Unit Unit of the counter.
+ * @tparam T Underlying type; updates are wait-free for integral types.
+ *
+ * Exported as `<name>_<unit suffix>_total`.
+ */
+template <typename Unit, typename T = double>
+class Counter: public Helper::Metric{
+private:
+    AtomicQuantity<Unit, T> total;
+
+public:
+    Counter(std::string_view name, std::string_view help = {})
+        :Metric(name, help)
+    {}
+
+    /**
+     * @brief Adds a quantity, converted to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void add(const Quantity<U, T2>& q) noexcept{
+        total.fetch_add(q, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Current value of the counter.
+     */
+    inline Quantity<Unit, T> value() const noexcept{
+        return total.load(std::memory_order_relaxed);
+    }
+
+    void write(std::ostream& s) const override{
+        std::string fullName = Helper::metricName<Unit>(name, "_total");
+        writeHeader(s, fullName, "counter");
+        s << fullName << ' ';
+        Helper::writeNumber(s, Helper::exportedValue(value()));
+        s << '\n';
+    }
+};
+
+/**
+ * @brief Metric of a quantity which may increase or decrease, ie.
+ * temperature or memory in use.
+ *
+ * @tparam Unit Unit of the gauge.
+ * @tparam T Underlying type; updates are wait-free for integral types.
+ *
+ * Exported as `<name>_<unit suffix>`.
+ */
+template <typename Unit, typename T = double>
+class Gauge: public Helper::Metric{
+private:
+    AtomicQuantity<Unit, T> current;
+
+public:
+    Gauge(std::string_view name, std::string_view help = {})
+        :Metric(name, help)
+    {}
+
+    /**
+     * @brief Sets the gauge to a quantity, converted to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void set(const Quantity<U, T2>& q) noexcept{
+        current.store(q, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Adds a quantity, converted to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void add(const Quantity<U, T2>& q) noexcept{
+        current.fetch_add(q, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Subtracts a quantity, converted to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void sub(const Quantity<U, T2>& q) noexcept{
+        current.fetch_sub(q, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Current value of the gauge.
+     */
+    inline Quantity<Unit, T> value() const noexcept{
+        return current.load(std::memory_order_relaxed);
+    }
+
+    void write(std::ostream& s) const override{
+        std::string fullName = Helper::metricName<Unit>(name);
+        writeHeader(s, fullName, "gauge");
+        s << fullName << ' ';
+        Helper::writeNumber(s, Helper::exportedValue(value()));
+        s << '\n';
+    }
+};
+
+/**
+ * @brief Metric counting observed quantities in buckets, ie. request
+ * latencies.
+ *
+ * @tparam Unit Unit of observed quantities.
+ * @tparam T Underlying type of bucket bounds and sum of observations.
+ *
+ * Bucket `i` counts observations not greater than its upper bound, and not
+ * counted by bucket `i-1`; the last bucket counts all remaining ones. Counts
+ * are updated with wait-free atomic additions; the sum of observations is
+ * updated like `Counter`.
+ *
+ * Exported as cumulative buckets `<name>_<unit suffix>_bucket`, with bounds
+ * converted to exported unit, followed by `_sum` and `_count`.
+ */
+template <typename Unit, typename T = double>
+class Histogram: public Helper::Metric{
+private:
+    std::vector<T> bounds;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> counts;
+    AtomicQuantity<Unit, T> total;
+
+public:
+    /**
+     * @brief Constructs a histogram of given upper bounds of buckets.
+     *
+     * Bounds may be given in any unit of the same dimension as `Unit`, and
+     * are converted to it; they must be increasing, otherwise
+     * `std::invalid_argument` is thrown.
+     */
+    Histogram(std::string_view name, std::string_view help, std::initializer_list<Quantity<Unit, T>> upperBounds)
+        :Metric(name, help), counts(new std::atomic<std::uint64_t>[upperBounds.size() + 1])
+    {
+        for (const Quantity<Unit, T>& bound: upperBounds)
+            bounds.push_back(bound.value());
+        if (std::adjacent_find(bounds.begin(), bounds.end(), [](T a, T b){ return !(a < b); }) != bounds.end())
+            throw std::invalid_argument("Bounds of histogram buckets are not increasing.");
+        for (std::size_t i=0; i<=bounds.size(); i++)
+            counts[i].store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Counts a quantity in its bucket.
+     */
+    template <typename U, typename T2>
+    inline void observe(const Quantity<U, T2>& q) noexcept{
+        T v = Quantity<Unit, T>(q).value();
+        std::size_t bucket = std::lower_bound(bounds.begin(), bounds.end(), v) - bounds.begin();
+        counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(q, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Number of observations in bucket `i`, not cumulative.
+     */
+    inline std::uint64_t count(std::size_t i) const noexcept{
+        return counts[i].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum of all observations.
+     */
+    inline Quantity<Unit, T> sum() const noexcept{
+        return total.load(std::memory_order_relaxed);
+    }
+
+    void write(std::ostream& s) const override{
+        std::string bucketName = Helper::metricName<Unit>(name, "_bucket");
+        writeHeader(s, Helper::metricName<Unit>(name), "histogram");
+        std::uint64_t cumulative = 0;
+        for (std::size_t i=0; i<=bounds.size(); i++){
+            cumulative += count(i);
+            s << bucketName << "{le=\"";
+            Helper::writeNumber(s, i < bounds.size() ? Helper::exportedValue(Quantity<Unit, T>(bounds[i]))
+                                                     : std::numeric_limits<double>::infinity());
+            s << "\"} " << cumulative << '\n';
+        }
+        s << Helper::metricName<Unit>(name, "_sum") << ' ';
+        Helper::writeNumber(s, Helper::exportedValue(sum()));
+        s << '\n' << Helper::metricName<Unit>(name, "_count") << ' ' << cumulative << '\n';
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Registry of metrics, which exports all of them at once.
+ *
+ * Metrics are created by the registry and live as long as it does; returned
+ * references may be kept and updated from any thread. Registration pushes a
+ * metric to a lock-free list, so it may run concurrently with other
+ * registrations and exports. Names of metrics are not checked for uniqueness.
+ */
+class MetricsRegistry{
+private:
+    std::atomic<Helper::Metric*> head{nullptr};
+
+    template <typename M>
+    M& add(M* metric) noexcept{
+        metric->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(metric->next, metric, std::memory_order_release, std::memory_order_relaxed));
+        return *metric;
+    }
+
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    ~MetricsRegistry(){
+        Helper::Metric* m = head.load(std::memory_order_acquire);
+        while (m){
+            Helper::Metric* next = m->next;
+            delete m;
+            m = next;
+        }
+    }
+
+    /**
+     * @brief Registers a counter.
+     *
+     * If name contains characters other than ASCII letters, digits, `_` and
+     * `:`, or starts with a digit, `std::invalid_argument` is thrown.
+     */
+    template <typename Unit, typename T = double>
+    Counter<Unit, T>& counter(std::string_view name, std::string_view help = {}){
+        return add(new Counter<Unit, T>(name, help));
+    }
+
+    /**
+     * @brief Registers a gauge.
+     */
+    template <typename Unit, typename T = double>
+    Gauge<Unit, T>& gauge(std::string_view name, std::string_view help = {}){
+        return add(new Gauge<Unit, T>(name, help));
+    }
+
+    /**
+     * @brief Registers a histogram of given upper bounds of buckets.
+     */
+    template <typename Unit, typename T = double>
+    Histogram<Unit, T>& histogram(std::string_view name, std::string_view help,
+                                  std::initializer_list<std::type_identity_t<Quantity<Unit, T>>> upperBounds){
+        return add(new Histogram<Unit, T>(name, help, upperBounds));
+    }
+
+    /**
+     * @brief Writes all metrics in text exposition format, in order of their
+     * registration.
+     */
+    void write(std::ostream& s) const{
+        std::vector<const Helper::Metric*> metrics;
+        for (const Helper::Metric* m = head.load(std::memory_order_acquire); m; m = m->next)
+            metrics.push_back(m);
+        for (auto i = metrics.rbegin(); i != metrics.rend(); ++i)
+            (*i)->write(s);
+    }
+};
+
+}
+
+#endif // METRICS_H
@@ -2,6 +2,7 @@
 #define QUANTITY_H
 
 #include "unitmanip.h"
+#include <type_traits>
 #include <utility>
 #include <iosfwd>
 
@@ -19,11 +20,46 @@ template <typename Unit, typename T = double>
 class Quantity;
 /** @endcond */
 
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Helper class used to compute `noexcept` specifications of Quantity
+ * operations.
+ *
+ * Operations on quantities of arithmetic underlying types, and of vectors of
+ * arithmetic types (see `VectorTraits`), never throw. For other underlying
+ * types operations are assumed to be potentially throwing.
+ */
+template <typename ...Args>
+class IsNothrow: public std::integral_constant<bool, (std::is_arithmetic<typename VectorTraits<Args>::Element>::value && ...)>{};
+
+/**
+ * @brief Base class of arrays of quantities, like `QuantityVector` (see
+ * quantityvector.h) and expressions over them.
+ *
+ * Generic operators of Quantity accept operands of any other type as
+ * dimensionless values. Arrays are excluded from them, so that elementwise
+ * operators of arrays are used instead.
+ */
+class QuantityArray{};
+
+/**
+ * @brief Checks if `T` is an array of quantities.
+ */
+template <typename T>
+class IsQuantityArray: public std::is_base_of<QuantityArray, T>{};
+
+}
+
+/** @endcond */
+
 template <typename Unit, typename T>
 inline std::ostream& operator<<(std::ostream& s, const Quantity<Unit,T>& q);
 
 template <typename Unit, typename T>
-inline std::istream& operator>>(std::istream& s, const Quantity<Unit,T>& q);
+inline std::istream& operator>>(std::istream& s, Quantity<Unit,T>& q);
 
 template <typename T>
 inline auto value(const T& t);
@@ -41,7 +77,7 @@ inline auto value(const T& t);
  * All mathematical operator avialable in C/C++ are overloaded in such a way that the results obey regular unit
  * arithmetics. If requested operation cannot be performed, compilation error is generated.
  *
- * All methods of this class are declared inline and (hopefully) a good compiler should be able to generate
+ * All methods of this class are declared inline and constexpr and (hopefully) a good compiler should be able to generate
  * identical code as when working directly on a variable of nderlying type.
  *
  * ###Standard conversions###
@@ -69,30 +105,40 @@ private:
     T t;
 
     template <typename U>
-    inline void checkComaptible() const{
-        static_assert(IsEqual<DimensionOf<U>, DimensionOf<Unit>>::value, "Quantities of unequal dimensions!!!");
+    static inline constexpr void checkComaptible() noexcept{
+        static_assert(IsEqualDimension<U, Unit>::value, "Quantities of unequal dimensions!!!");
     }
 
     template <typename U>
-    inline void checkNoUnit() const{
-        static_assert(IsEqual<DimensionOf<U>, Compound<>>::value, "Dimensionless quantity required!!!");
+    static inline constexpr void checkNoUnit() noexcept{
+        static_assert(IsEqualDimension<U, Compound<>>::value, "Dimensionless quantity required!!!");
     }
 
     template <typename T2>
-    static inline auto value(const T2& t){
+    static inline constexpr auto value(const T2& t) noexcept(Helper::IsNothrow<T2>::value){
         return t;
     }
 
     template <typename U, typename T2>
-    inline auto value(const Quantity<U, T2>& q){
+    static inline constexpr auto value(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T2>::value){
         return q.value();
     }
 
+    template <typename U, typename T2>
+    static inline constexpr auto convert(const T2& t) noexcept(Helper::IsNothrow<T, T2>::value){
+        if constexpr (std::is_integral<T>::value && std::is_integral<T2>::value)
+            return ConvertIntegral<U, Unit>::template value<T>(t);
+        else
+            return Convert<U, Unit>::value(t);
+    }
+
 public:
     /**
-     * @brief Contructs Quantity with non-initialized value.
+     * @brief Contructs Quantity with default-initialized value.
+     *
+     * Value of arithmetic underlying type is not initialized.
      */
-    inline Quantity(){}
+    Quantity() = default;
 
     /**
      * @brief Contructs a Quantity from quantity of the same unit but different underlying type.
@@ -100,7 +146,7 @@ public:
      * Standard (implicit) conversion between underlying types is performed.
      */
     template <typename T2>
-    inline Quantity(const Quantity<Unit, T2>& q)
+    inline constexpr Quantity(const Quantity<Unit, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
         :t(q.value())
     {}
 
@@ -110,11 +156,14 @@ public:
      * Standard (implicit) conversion between underlying types is performed. Scaling between different units of the same
      * dimension is performed.
      *
+     * If both underlying types are integral, value is scaled exactly in integer arithmetic and rounded toward zero
+     * (see `ConvertIntegral`).
+     *
      * If dimension of quantity q is different than dimension of constructed quantity, compilation error is generated.
      */
     template <typename U, typename T2>
-    inline Quantity(const Quantity<U, T2>& q)
-        :t(Convert<U, Unit>::value(q.value()))
+    inline constexpr Quantity(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
+        :t(convert<U>(q.value()))
     {
         checkComaptible<U>();
     }
@@ -125,7 +174,7 @@ public:
      *
      * No conversions are performed on the value.
      */
-    inline explicit Quantity(T value)
+    inline constexpr explicit Quantity(T value) noexcept(Helper::IsNothrow<T>::value)
         :t(value)
     {}
 
@@ -135,13 +184,16 @@ public:
      * Standard (implicit) conversion between underlying types is performed. Scaling between different units of the same
      * dimension is performed.
      *
+     * If both underlying types are integral, value is scaled exactly in integer arithmetic and rounded toward zero
+     * (see `ConvertIntegral`).
+     *
      * If dimension of quantity q is different than dimension of assigned quantity, compilation error is generated.
      */
     template <typename U, typename T2>
-    inline Quantity& operator=(const Quantity<U, T2>& q)
+    inline constexpr Quantity& operator=(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
     {
         checkComaptible<U>();
-        t = Convert<U, Unit>::value(q.value());
+        t = convert<U>(q.value());
         return *this;
     }
 
@@ -155,7 +207,7 @@ public:
      * If dimensions of added quantities are different, compilation error is generated.
      */
     template <typename U, typename T2>
-    inline auto operator+(const Quantity<U, T2>& q) const
+    inline constexpr auto operator+(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value)
     {
         checkComaptible<U>();
         auto val = t + Convert<U, Unit>::value(q.value());
@@ -172,7 +224,7 @@ public:
      * If dimensions of subtracted quantities are different, compilation error is generated.
      */
     template <typename U, typename T2>
-    inline auto operator-(const Quantity<U, T2>& q) const
+    inline constexpr auto operator-(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value)
     {
         checkComaptible<U>();
         auto val = t - Convert<U, Unit>::value(q.value());
@@ -188,7 +240,7 @@ public:
      * Performs integer promotion on held value and returns qunatity of the same unit and
      * apropriate underlying type.
      */
-    inline auto operator+() const
+    inline constexpr auto operator+() const noexcept(Helper::IsNothrow<T>::value)
     {
         auto val = +t;
         return Quantity<Unit, decltype(val)>(val);
@@ -202,7 +254,7 @@ public:
      * Performs additive inversion on held value and returns qunatity of the same unit and
      * apropriate underlying type.
      */
-    inline Quantity operator-() const
+    inline constexpr Quantity operator-() const noexcept(Helper::IsNothrow<T>::value)
     {
         auto val = -t;
         return Quantity<Unit, decltype(val)>(val);
@@ -218,7 +270,7 @@ public:
      * If dimensions of divided quantities are different, compilation error is generated.
      */
     template <typename U, typename T2>
-    inline auto operator%(const Quantity<U, T2>& q) const
+    inline constexpr auto operator%(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value)
     {
         checkComaptible<U>();
         auto val = t % Convert<U, Unit>::value(q.value());
@@ -233,7 +285,7 @@ public:
      * conversions is being performed.
      */
     template <typename U>
-    inline auto operator%(const U& u) const
+    inline constexpr auto operator%(const U& u) const noexcept(Helper::IsNothrow<T, U>::value)
     {
         auto val = t%u;
         return Quantity<Unit, decltype(val)>(val);
@@ -245,7 +297,7 @@ public:
      *
      * Increments stored value.
      */
-    inline Quantity& operator++(){
+    inline constexpr Quantity& operator++() noexcept(Helper::IsNothrow<T>::value){
         ++t;
         return *this;
     }
@@ -256,7 +308,7 @@ public:
      *
      * Increments stored value.
      */
-    inline Quantity operator++(int){
+    inline constexpr Quantity operator++(int) noexcept(Helper::IsNothrow<T>::value){
         T val = t;
         t++;
         return Quantity(val);
@@ -268,7 +320,7 @@ public:
      *
      * Decrements stored value.
      */
-    inline Quantity& operator--(){
+    inline constexpr Quantity& operator--() noexcept(Helper::IsNothrow<T>::value){
         --t;
         return *this;
     }
@@ -279,7 +331,7 @@ public:
      *
      * Decrements stored value.
      */
-    inline Quantity operator--(int){
+    inline constexpr Quantity operator--(int) noexcept(Helper::IsNothrow<T>::value){
         T val = t;
         t--;
         return Quantity(val);
@@ -299,40 +351,43 @@ public:
      *
      * If dimensions of compared quantities are different, compilation error is
      * generated.
+     *
+     * Results are the same as results of comparisons of underlying values:
+     * `bool` for arithmetic types, masks for vector types.
      */
     //@{
     template <typename U, typename T2>
-    inline bool operator==(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator==(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t == Convert<U, Unit>::value(q.value());
     }
 
     template <typename U, typename T2>
-    inline bool operator!=(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator!=(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t != Convert<U, Unit>::value(q.value());
     }
 
     template <typename U, typename T2>
-    inline bool operator>(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator>(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t > Convert<U, Unit>::value(q.value());
     }
 
     template <typename U, typename T2>
-    inline bool operator<(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator<(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t < Convert<U, Unit>::value(q.value());
     }
 
     template <typename U, typename T2>
-    inline bool operator>=(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator>=(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t >= Convert<U, Unit>::value(q.value());
     }
 
     template <typename U, typename T2>
-    inline bool operator<=(const Quantity<U, T2>& q) const{
+    inline constexpr auto operator<=(const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         return t <= Convert<U, Unit>::value(q.value());
     }
@@ -357,7 +412,7 @@ public:
      */
 
     template <typename U, typename T2>
-    Quantity& operator+=(const Quantity<U, T2>& q){
+    inline constexpr Quantity& operator+=(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         t += Convert<U, Unit>::value(q.value());
         return *this;
@@ -374,7 +429,7 @@ public:
      * If second operand is not dimensionless, compilation error is generated.
      */
     template <typename U, typename T2>
-    Quantity& operator-=(const Quantity<U, T2>& q){
+    inline constexpr Quantity& operator-=(const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value){
         checkComaptible<U>();
         t -= Convert<U, Unit>::value(q.value());
         return *this;
@@ -393,7 +448,7 @@ public:
      * If second operand is not dimensionless, compilation error is generated.
      */
     template <typename T2>
-    Quantity& operator*=(const T2& q){
+    inline constexpr Quantity& operator*=(const T2& q) noexcept(noexcept(std::declval<T&>() *= value(q))){
         checkNoUnit<UnitOf<T2>>();
         t *= value(q);
         return *this;
@@ -410,7 +465,7 @@ public:
      * If second operand is not dimensionless, compilation error is generated.
      */
     template <typename T2>
-    Quantity& operator/=(const T2& q){
+    inline constexpr Quantity& operator/=(const T2& q) noexcept(noexcept(std::declval<T&>() /= value(q))){
         checkNoUnit<UnitOf<T2>>();
         t /= value(q);
         return *this;
@@ -428,7 +483,7 @@ public:
      * If second operand is not dimensionless, compilation error is generated.
      */
     template <typename T2>
-    Quantity& operator%=(const T2& q){
+    inline constexpr Quantity& operator%=(const T2& q) noexcept(noexcept(std::declval<T&>() %= value(q))){
         checkNoUnit<UnitOf<T2>>();
         t %= value(q);
         return *this;
@@ -445,62 +500,62 @@ public:
      */
     //@{
     template <typename U>
-    inline auto operator[](const U& u){
+    inline constexpr auto operator[](const U& u) noexcept(noexcept(t[u])){
         return t[u];
     }
 
     template <typename U>
-    inline auto operator[](const U& u) const{
+    inline constexpr auto operator[](const U& u) const noexcept(noexcept(t[u])){
         return t[u];
     }
 
-    inline auto operator*(){
+    inline constexpr auto operator*() noexcept(noexcept(*t)){
         return *t;
     }
 
-    inline auto operator*() const{
+    inline constexpr auto operator*() const noexcept(noexcept(*t)){
         return *t;
     }
 
     // ToDo: pointers?
-    inline auto operator->(){
+    inline constexpr auto operator->() noexcept(noexcept(t.operator->())){
         return t.operator->();
     }
 
     // ToDo: pointers?
-    inline auto operator->() const{
+    inline constexpr auto operator->() const noexcept(noexcept(t.operator->())){
         return t.operator->();
     }
 
     template <typename U>
-    inline auto operator->*(const U& u){
+    inline constexpr auto operator->*(const U& u) noexcept(noexcept(t->*u)){
         return t->*u;
     }
 
     template <typename U>
-    inline auto operator->*(const U& u) const{
+    inline constexpr auto operator->*(const U& u) const noexcept(noexcept(t->*u)){
         return t->*u;
     }
 
     //-----------------------------------------------------------------------------------------------------------------------------------------------------
 
     template <typename ...Args>
-    inline auto operator()(Args&&... args){
+    inline constexpr auto operator()(Args&&... args) noexcept(noexcept(t(std::forward<Args>(args)...))){
         return t(std::forward<Args>(args)...);
     }
 
     template <typename ...Args>
-    inline auto operator()(Args&&... args) const{
+    inline constexpr auto operator()(Args&&... args) const noexcept(noexcept(t(std::forward<Args>(args)...))){
         return t(std::forward<Args>(args)...);
     }
 
     template <typename ...Args>
-    inline auto operator()(const Args&... args){
+    inline constexpr auto operator()(const Args&... args) noexcept(noexcept(t(args...))){
         return t(args...);
     }
 
     template <typename ...Args>
-    inline auto operator()(const Args&... args) const{
+    inline constexpr auto operator()(const Args&... args) const noexcept(noexcept(t(args...))){
         return t(args...);
     }
     //@}
@@ -513,7 +568,7 @@ public:
      *
      * No conversions or compiler errors are genereated by LibUnit.
      */
-    explicit operator T() const{
+    inline constexpr explicit operator T() const noexcept(Helper::IsNothrow<T>::value){
         return t;
     }
 
@@ -525,7 +580,7 @@ public:
      *
      * No conversions or compiler errors are genereated by LibUnit.
      */
-    inline T value() const{
+    inline constexpr T value() const noexcept(Helper::IsNothrow<T>::value){
         return t;
     }
 
@@ -536,7 +591,7 @@ public:
      * Can be used to change value of quantity without dimension checking.
      * Use with caution.
      */
-    inline T& ref(){
+    inline constexpr T& ref() noexcept{
         return t;
     }
 
@@ -553,7 +608,7 @@ public:
     }*/
 
     friend std::ostream& operator<< <Unit, T>(std::ostream&, const Quantity<Unit, T>&);
-    friend std::istream& operator>> <Unit, T>(std::istream&, const Quantity<Unit, T>&);
+    friend std::istream& operator>> <Unit, T>(std::istream&, Quantity<Unit, T>&);
 };
 
 /**
@@ -562,7 +617,7 @@ public:
  * multiplication of underlying types of operands.
  */
 template <typename Unit, typename T, typename U, typename T2>
-inline auto operator*(const Quantity<Unit, T>& p, const Quantity<U, T2>& q)
+inline constexpr auto operator*(const Quantity<Unit, T>& p, const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
 {
     auto val = p.value()*q.value();
     return Quantity<Simplify<Join<Unit, U>>, decltype(val)>(val);
@@ -574,8 +629,8 @@ inline auto operator*(const Quantity<Unit, T>& p, const Quantity<U, T2>& q)
  * result of multiplication of underlying type of first operand and second
  * operand.
  */
-template <typename Unit, typename T, typename U>
-inline auto operator*(const Quantity<Unit, T>& p, const U& u)
+template <typename Unit, typename T, typename U, typename = std::enable_if_t<!Helper::IsQuantityArray<U>::value>>
+inline constexpr auto operator*(const Quantity<Unit, T>& p, const U& u) noexcept(noexcept(p.value()*u))
 {
     auto val = p.value()*u;
     return Quantity<Unit, decltype(val)>(val);
@@ -587,8 +642,8 @@ inline auto operator*(const Quantity<Unit, T>& p, const U& u)
  * result of multiplication of underlying type of second operand and first
  * operand.
  */
-template <typename U, typename Unit, typename T>
-inline auto operator*(const U& u, const Quantity<Unit, T>& p)
+template <typename U, typename Unit, typename T, typename = std::enable_if_t<!Helper::IsQuantityArray<U>::value>>
+inline constexpr auto operator*(const U& u, const Quantity<Unit, T>& p) noexcept(noexcept(p.value()*u))
 {
     auto val = p.value()*u;
     return Quantity<Unit, decltype(val)>(val);
@@ -600,7 +655,7 @@ inline auto operator*(const U& u, const Quantity<Unit, T>& p)
  * division of underlying types of operands.
  */
 template <typename Unit, typename T, typename U, typename T2>
-inline auto operator/(const Quantity<Unit, T>& p, const Quantity<U, T2>& q)
+inline constexpr auto operator/(const Quantity<Unit, T>& p, const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value)
 {
     auto val = p.value()/q.value();
     return Quantity<Simplify<Join<Unit, Invert<U>>>, decltype(val)>(val);
@@ -611,8 +666,8 @@ inline auto operator/(const Quantity<Unit, T>& p, const Quantity<U, T2>& q)
  * @return Quantity of first operand's inverted unit and underlying type same as
  * result of division of underlying type of first operand and second operand.
  */
-template <typename Unit, typename T, typename U>
-inline auto operator/(const Quantity<Unit, T>& p, const U& u)
+template <typename Unit, typename T, typename U, typename = std::enable_if_t<!Helper::IsQuantityArray<U>::value>>
+inline constexpr auto operator/(const Quantity<Unit, T>& p, const U& u) noexcept(noexcept(p.value()/u))
 {
     auto val = p.value()/u;
     return Quantity<Unit, decltype(val)>(val);
@@ -623,13 +678,38 @@ inline auto operator/(const Quantity<Unit, T>& p, const U& u)
  * @return Quantity of second operand's inverted unit and underlying type same
  * as result of division of underlying type of second operand and first operand.
  */
-template <typename U, typename Unit, typename T>
-inline auto operator/(const U& u, const Quantity<Unit, T>& p)
+template <typename U, typename Unit, typename T, typename = std::enable_if_t<!Helper::IsQuantityArray<U>::value>>
+inline constexpr auto operator/(const U& u, const Quantity<Unit, T>& p) noexcept(noexcept(u/p.value()))
 {
     auto val = u/p.value();
     return Quantity<Invert<Unit>, decltype(val)>(val);
 }
 
+/**
+ * @brief Converts quantity to a different unit, keeping its underlying type.
+ *
+ * @tparam To Unit of the result.
+ * @tparam Rounding Rounding policy used if underlying type is integral:
+ * `RoundTowardZero`, `RoundToNearest` or `RoundDown`.
+ * @return Quantity of unit `To` and the same underlying type as `q`.
+ *
+ * Integral values are scaled exactly in integer arithmetic (see
+ * `ConvertIntegral`). Other values are converted using `Convert`.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * Quantity<Mili<Metre>, int64_t> q(1500);
+ * quantityCast<Metre>(q).value(); // 1
+ * quantityCast<Metre, RoundToNearest>(q).value(); // 2
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename To, typename Rounding = RoundTowardZero, typename Unit, typename T>
+inline constexpr auto quantityCast(const Quantity<Unit, T>& q) noexcept(Helper::IsNothrow<T>::value){
+    if constexpr (std::is_integral<T>::value)
+        return Quantity<To, T>(ConvertIntegral<Unit, To, Rounding>::template value<T>(q.value()));
+    else
+        return Quantity<To, T>(Convert<Unit, To>::value(q.value()));
+}
+
 /**
  * @brief Ostream output operator overload
  *
@@ -644,10 +724,11 @@ inline std::ostream& operator<<(std::ostream& s, const Quantity<Unit,T>& q){
 /**
  * @brief Istream input operator overload
  *
- * Reads internal value of quantity from istream.
+ * Reads internal value of quantity from istream. Unit symbols are not
+ * parsed; see `fromChars()` in unitparser.h.
  */
 template <typename Unit, typename T>
-inline std::istream& operator>>(std::istream& s, const Quantity<Unit,T>& q){
+inline std::istream& operator>>(std::istream& s, Quantity<Unit,T>& q){
     s >> q.t;
     return s;
 }
@@ -0,0 +1,296 @@
+#ifndef QUANTITYALGORITHM_H
+#define QUANTITYALGORITHM_H
+
+#include "quantityvector.h"
+#include <algorithm>
+#include <cstddef>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @file quantityalgorithm.h
+ *
+ * Algorithms of `<algorithm>` and `<numeric>` over arrays of quantities,
+ * which accept execution policies of `std::execution`.
+ *
+ * Arrays are `QuantitySpan` or `QuantityVector` objects. Algorithms run
+ * directly on their underlying values, so they parallelize and vectorize as
+ * well as algorithms on plain arrays, but functions passed to them receive and
+ * return quantities, so units are checked and converted at compile time.
+ * Results written to output arrays are converted to units of those arrays.
+ *
+ * Parallel policies are executed by the backend of the standard library;
+ * libstdc++ uses TBB, so programs using them must be linked with `-ltbb`.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Checks if `T` is an execution policy.
+ */
+template <typename T>
+class IsExecutionPolicy: public std::is_execution_policy<std::remove_cvref_t<T>>{};
+
+/**
+ * @brief Checks if `T` is an array of quantities which stores its values,
+ * ie. a `QuantitySpan` or `QuantityVector`.
+ */
+template <typename T, typename = void>
+class IsQuantityStorage: public std::false_type{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class IsQuantityStorage<T, std::void_t<decltype(std::declval<T&>().data())>>: public IsQuantityArray<std::remove_cvref_t<T>>{};
+/** @endcond */
+
+/**
+ * @brief Type of quantities of array `A`.
+ */
+template <typename A>
+using ElementOf = Quantity<typename std::remove_cvref_t<A>::UnitType, typename std::remove_cvref_t<A>::ValueType>;
+
+/**
+ * @brief Result of a function passed to an algorithm, as a quantity.
+ *
+ * Values of non-quantity types are dimensionless quantities.
+ */
+template <typename R>
+inline constexpr auto asQuantity(const R& r) noexcept(IsNothrow<R>::value){
+    if constexpr (IsQuantity<R>::value)
+        return r;
+    else
+        return Quantity<Compound<>, R>(r);
+}
+
+/**
+ * @brief Quantity type of results of function `F` called with arguments of
+ * types `Args`.
+ */
+template <typename F, typename ...Args>
+using ResultQuantity = decltype(asQuantity(std::declval<F&>()(std::declval<Args>()...)));
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Applies function to each quantity of an array.
+ *
+ * @param policy Execution policy.
+ * @param in Input array.
+ * @param out Output array, of the same size as `in`.
+ * @param f Function called with a `Quantity` of `in`.
+ *
+ * Results of `f` are converted to unit and underlying type of `out` before
+ * they are stored. If sizes of arrays are different, `std::invalid_argument`
+ * is thrown. If dimensions of results and `out` are different, compilation
+ * error is generated.
+ */
+template <typename Policy, typename A, typename Out, typename F,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value && Helper::IsQuantityStorage<Out>::value
+                                      && std::is_invocable<F&, Helper::ElementOf<A>>::value>>
+inline void transform(Policy&& policy, const A& in, Out&& out, F f){
+    auto i = Helper::viewOf(in);
+    auto o = Helper::viewOf(out);
+    typedef typename decltype(i)::UnitType Unit;
+    typedef typename decltype(i)::ValueType T;
+    typedef Quantity<typename decltype(o)::UnitType, typename decltype(o)::ValueType> Result;
+    Helper::checkSizes(i.size(), o.size());
+    std::transform(std::forward<Policy>(policy), i.data(), i.data() + i.size(), o.data(), [&f](const T& v){
+        return Result(Helper::asQuantity(f(Quantity<Unit, T>(v)))).value();
+    });
+}
+
+/**
+ * @brief Applies function to pairs of quantities of two arrays.
+ *
+ * @param policy Execution policy.
+ * @param a First input array.
+ * @param b Second input array.
+ * @param out Output array.
+ * @param f Function called with quantities of `a` and `b` at the same index.
+ *
+ * All arrays must have the same size, otherwise `std::invalid_argument` is
+ * thrown. Results of `f` are converted like in unary `transform()`.
+ */
+template <typename Policy, typename A, typename B, typename Out, typename F,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value && Helper::IsQuantityStorage<Out>::value>>
+inline void transform(Policy&& policy, const A& a, const B& b, Out&& out, F f){
+    auto i = Helper::viewOf(a);
+    auto j = Helper::viewOf(b);
+    auto o = Helper::viewOf(out);
+    typedef Helper::ElementOf<A> QA;
+    typedef Helper::ElementOf<B> QB;
+    typedef Quantity<typename decltype(o)::UnitType, typename decltype(o)::ValueType> Result;
+    Helper::checkSizes(i.size(), j.size());
+    Helper::checkSizes(i.size(), o.size());
+    std::transform(std::forward<Policy>(policy), i.data(), i.data() + i.size(), j.data(), o.data(),
+                   [&f](const typename decltype(i)::ValueType& x, const typename decltype(j)::ValueType& y){
+        return Result(Helper::asQuantity(f(QA(x), QB(y)))).value();
+    });
+}
+
+/**
+ * @brief Applies function to each quantity of an array.
+ * @return vector of results, in unit and of underlying type of quantities
+ * returned by `f`; ie. for `f` returning `q * q` unit of results is square
+ * of unit of `in`, like for `operator*`.
+ */
+template <typename Policy, typename A, typename F,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value && std::is_invocable<F&, Helper::ElementOf<A>>::value>>
+inline auto transform(Policy&& policy, const A& in, F f){
+    typedef Helper::ResultQuantity<F, Helper::ElementOf<A>> Result;
+    QuantityVector<UnitOf<Result>, decltype(std::declval<Result>().value())> result(Helper::viewOf(in).size());
+    transform(std::forward<Policy>(policy), in, result, f);
+    return result;
+}
+
+/**
+ * @brief Applies function to pairs of quantities of two arrays.
+ * @return vector of results, in unit and of underlying type of quantities
+ * returned by `f`.
+ */
+template <typename Policy, typename A, typename B, typename F,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value
+                                      && std::is_invocable<F&, Helper::ElementOf<A>, Helper::ElementOf<B>>::value>>
+inline auto transform(Policy&& policy, const A& a, const B& b, F f){
+    typedef Helper::ResultQuantity<F, Helper::ElementOf<A>, Helper::ElementOf<B>> Result;
+    QuantityVector<UnitOf<Result>, decltype(std::declval<Result>().value())> result(Helper::viewOf(a).size());
+    transform(std::forward<Policy>(policy), a, b, result, f);
+    return result;
+}
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Sum of all quantities of an array.
+ * @return sum in unit of `in`; zero for empty array.
+ *
+ * Values are summed in unspecified order, like by `std::reduce`.
+ */
+template <typename Policy, typename A, typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value>>
+inline auto reduce(Policy&& policy, const A& in){
+    auto i = Helper::viewOf(in);
+    typedef typename decltype(i)::ValueType T;
+    return Quantity<typename decltype(i)::UnitType, T>(std::reduce(std::forward<Policy>(policy), i.data(), i.data() + i.size(), T()));
+}
+
+/**
+ * @brief Sum of products of quantities of two arrays at the same indices.
+ * @return sum in unit of product of quantities of `a` and `b`, like for
+ * `operator*`; zero for empty arrays.
+ *
+ * If sizes of arrays are different, `std::invalid_argument` is thrown.
+ */
+template <typename Policy, typename A, typename B,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value && Helper::IsQuantityStorage<B>::value>>
+inline auto transformReduce(Policy&& policy, const A& a, const B& b){
+    auto i = Helper::viewOf(a);
+    auto j = Helper::viewOf(b);
+    typedef Helper::ElementOf<A> QA;
+    typedef Helper::ElementOf<B> QB;
+    typedef decltype(std::declval<QA>() * std::declval<QB>()) Result;
+    typedef decltype(std::declval<Result>().value()) R;
+    Helper::checkSizes(i.size(), j.size());
+    return Result(std::transform_reduce(std::forward<Policy>(policy), i.data(), i.data() + i.size(), j.data(), R(), std::plus<>(),
+                                        [](const typename decltype(i)::ValueType& x, const typename decltype(j)::ValueType& y){
+        return (QA(x) * QB(y)).value();
+    }));
+}
+
+/**
+ * @brief Applies function to each quantity of an array, and reduces results.
+ *
+ * @param policy Execution policy.
+ * @param in Input array.
+ * @param init Initial value of reduction; its type is type of the result.
+ * @param reduceOp Associative and commutative function combining two results.
+ * @param transformOp Function called with a `Quantity` of `in`.
+ * @return reduced value, like `std::transform_reduce`.
+ *
+ * Results of both functions are converted to type of `init`, so they are
+ * checked and scaled to its unit.
+ */
+template <typename Policy, typename A, typename I, typename ReduceOp, typename TransformOp,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value>>
+inline I transformReduce(Policy&& policy, const A& in, I init, ReduceOp reduceOp, TransformOp transformOp){
+    auto i = Helper::viewOf(in);
+    typedef typename decltype(i)::UnitType Unit;
+    typedef typename decltype(i)::ValueType T;
+    return std::transform_reduce(std::forward<Policy>(policy), i.data(), i.data() + i.size(), init,
+                                 [&reduceOp](const I& x, const I& y) -> I{ return reduceOp(x, y); },
+                                 [&transformOp](const T& v) -> I{ return transformOp(Quantity<Unit, T>(v)); });
+}
+
+/**
+ * @brief Running sums of quantities of an array.
+ *
+ * @param policy Execution policy.
+ * @param in Input array.
+ * @param out Output array, of the same size as `in`; may be the same as `in`.
+ *
+ * Quantities are converted to unit of `out` before they are summed. If
+ * sizes of arrays are different, `std::invalid_argument` is thrown.
+ */
+template <typename Policy, typename A, typename Out,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value>>
+inline void inclusiveScan(Policy&& policy, const A& in, Out&& out){
+    auto i = Helper::viewOf(in);
+    auto o = Helper::viewOf(out);
+    typedef typename decltype(o)::ValueType R;
+    Helper::checkSizes(i.size(), o.size());
+    std::transform_inclusive_scan(std::forward<Policy>(policy), i.data(), i.data() + i.size(), o.data(), std::plus<>(),
+                                  Helper::convertValue<typename decltype(i)::UnitType, typename decltype(o)::UnitType, R,
+                                                       typename decltype(i)::ValueType>);
+}
+
+/**
+ * @brief Running reduction of quantities of an array with an associative
+ * function.
+ *
+ * Quantities are converted to unit of `out`, and `op` is called with two
+ * quantities of that unit. Its results are converted to unit of `out` too.
+ */
+template <typename Policy, typename A, typename Out, typename Op,
+          typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value>>
+inline void inclusiveScan(Policy&& policy, const A& in, Out&& out, Op op){
+    auto i = Helper::viewOf(in);
+    auto o = Helper::viewOf(out);
+    typedef typename decltype(o)::ValueType R;
+    typedef Quantity<typename decltype(o)::UnitType, R> Result;
+    Helper::checkSizes(i.size(), o.size());
+    std::transform_inclusive_scan(std::forward<Policy>(policy), i.data(), i.data() + i.size(), o.data(),
+                                  [&op](const R& x, const R& y){ return Result(op(Result(x), Result(y))).value(); },
+                                  Helper::convertValue<typename decltype(i)::UnitType, typename decltype(o)::UnitType, R,
+                                                       typename decltype(i)::ValueType>);
+}
+
+/**
+ * @brief The smallest and the largest quantity of an array.
+ * @return pair of the smallest and the largest quantity.
+ *
+ * If array is empty, `std::invalid_argument` is thrown.
+ */
+template <typename Policy, typename A, typename = std::enable_if_t<Helper::IsExecutionPolicy<Policy>::value>>
+inline auto minmax(Policy&& policy, const A& in){
+    auto i = Helper::viewOf(in);
+    typedef Helper::ElementOf<A> Q;
+    if (i.empty())
+        throw std::invalid_argument("Quantity array is empty.");
+    auto [min, max] = std::minmax_element(std::forward<Policy>(policy), i.data(), i.data() + i.size());
+    return std::pair<Q, Q>(Q(*min), Q(*max));
+}
+
+}
+
+#endif // QUANTITYALGORITHM_H
@@ -0,0 +1,394 @@
+#ifndef QUANTITYCSV_H
+#define QUANTITYCSV_H
+
+#include "dynamicquantity.h"
+#include "quantityvector.h"
+#include "unitparser.h"
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <istream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file quantitycsv.h
+ *
+ * Streaming reader of CSV files whose columns carry units.
+ *
+ * First line of the file is a header naming columns, each optionally followed
+ * by a unit expression in brackets: `speed[km/h],temp[K],pressure[bar]`.
+ * Column without a unit is dimensionless. Units are parsed once, by
+ * `parseUnit()`, and each column read is bound to a quantity type; the ratio
+ * of the file unit to the unit of that type is computed at the same time.
+ *
+ * Values are read in chunks of rows. Each chunk is parsed with
+ * `std::from_chars` into a buffer per column, and then every column is
+ * converted to its unit in a single pass over the buffer, so the cost of
+ * conversion does not depend on how units are written in the file. Fields
+ * are separated by commas and may not be quoted.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Unit and underlying type of a column of `QuantityCsvReader`.
+ */
+template <typename Q>
+class CsvColumn;
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T>
+class CsvColumn<Quantity<Unit, T>>{
+public:
+    typedef Unit UnitType;
+    typedef T ValueType;
+};
+/** @endcond */
+
+/**
+ * @brief Converts `n` parsed values of `in` to `T`, multiplying them by
+ * `factor`; integral results are rounded toward zero, and must fit `T` (see
+ * `fitsIntegral()`).
+ */
+template <typename T>
+inline void convertValues(T* out, const double* in, std::size_t n, double factor) noexcept{
+    std::size_t full = n - n % vectorBlock;
+    for (std::size_t i=0; i<full; i+=vectorBlock){
+#pragma GCC unroll 8
+        for (std::size_t j=0; j<vectorBlock; j++)
+            out[i + j] = static_cast<T>(in[i + j] * factor);
+    }
+    for (std::size_t i=full; i<n; i++)
+        out[i] = static_cast<T>(in[i] * factor);
+}
+
+/**
+ * @brief Checks if `value` rounded toward zero fits integral type `T`.
+ */
+template <typename T>
+inline bool fitsIntegral(double value) noexcept{
+    // Valid values lie strictly between these bounds; NaN fails both checks.
+    constexpr long double low = static_cast<long double>(std::numeric_limits<T>::min()) - 1;
+    constexpr long double high = static_cast<long double>(std::numeric_limits<T>::max()) + 1;
+    return value > low && value < high;
+}
+
+/**
+ * @brief Removes leading and trailing spaces and tabs.
+ */
+inline std::string_view trimField(std::string_view s) noexcept{
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+        s.remove_suffix(1);
+    return s;
+}
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Streaming reader of columns of quantities from a CSV file.
+ *
+ * @tparam Quantities Types of columns read, ie. `Quantity<Kilo<Metre>>`.
+ *
+ * Constructor reads the header and binds columns of the file to
+ * `Quantities`, either by position or by names. Then each call of `read()`
+ * reads next chunk of rows, which is viewed with `column()`. Columns of the
+ * file that are not bound are skipped.
+ *
+ * Following errors are reported by constructor:
+ *  - if file has no header, `std::runtime_error` is thrown;
+ *  - if a bound column does not exist, or its unit is not understood,
+ *    `std::invalid_argument` is thrown;
+ *  - if unit of a bound column has different dimension than its quantity,
+ *    `DimensionError` is thrown.
+ *
+ * `read()` throws `std::runtime_error` if a bound field is not a number.
+ * Fields of integral columns stored in the unit of their column are parsed
+ * as integers of its type; other ones are parsed as `double`, and their
+ * converted values must fit the type of the column. Otherwise
+ * `std::runtime_error` is thrown as well.
+ */
+template <typename... Quantities>
+class QuantityCsvReader{
+private:
+    static_assert(sizeof...(Quantities) > 0, "CSV reader without columns.");
+    static_assert((Helper::IsQuantity<Quantities>::value && ...), "Columns of CSV reader must be quantities.");
+
+    static constexpr std::size_t columnCount = sizeof...(Quantities);
+    static constexpr std::size_t bufferSize = 1 << 20;
+
+    template <std::size_t i>
+    using ColumnType = Helper::CsvColumn<std::tuple_element_t<i, std::tuple<Quantities...>>>;
+
+    std::istream& in;
+    std::vector<char> buffer;
+    std::size_t begin = 0;          // Start of unparsed characters in buffer.
+    std::size_t end = 0;            // End of read characters in buffer.
+    bool eof = false;
+    std::size_t line = 0;           // Number of lines consumed.
+
+    std::vector<int> binding;       // Bound column of each field of a line, or -1.
+    std::size_t lastField = 0;      // Last field of a line that is bound.
+    DynamicUnit units[columnCount];
+    double factors[columnCount];
+
+    std::size_t chunk;
+    std::size_t count = 0;
+    std::tuple<QuantityVector<typename Helper::CsvColumn<Quantities>::UnitType,
+                              typename Helper::CsvColumn<Quantities>::ValueType>...> values;
+    // Columns of type double are parsed directly into values; others into
+    // their own buffer first.
+    std::vector<double> parsed[columnCount];
+    double* targets[columnCount];
+
+    // Parsers of fields of integral columns, or nullptr.
+    typedef std::from_chars_result (QuantityCsvReader::*IntegralParser)(const char* p, const char* e, std::size_t row);
+    IntegralParser integralParsers[columnCount];
+
+    // Returns end of next line in buffer, reading more input if needed, or
+    // nullptr at end of input. Last line does not need to end with newline.
+    const char* nextLine(){
+        for (std::size_t scanned = begin;;){
+            const char* nl = static_cast<const char*>(std::memchr(buffer.data() + scanned, '\n', end - scanned));
+            if (nl)
+                return nl;
+            if (eof)
+                return begin < end ? buffer.data() + end : nullptr;
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            scanned = end;
+            if (end == buffer.size())
+                buffer.resize(2 * buffer.size());
+            in.read(buffer.data() + end, buffer.size() - end);
+            end += in.gcount();
+            if (in.bad())
+                throw std::runtime_error("Cannot read CSV.");
+            eof = in.eof();
+        }
+    }
+
+    void consumeLine(const char* lineEnd) noexcept{
+        begin = lineEnd == buffer.data() + end ? end : lineEnd - buffer.data() + 1;
+        line++;
+    }
+
+    [[noreturn]] void invalidValue(std::size_t field) const{
+        throw std::runtime_error("Invalid value in CSV line " + std::to_string(line + 1) +
+                                 ", column " + std::to_string(field + 1) + ".");
+    }
+
+    // Parses bound fields of a line into row `row` of targets.
+    void parseLine(const char* p, const char* e, std::size_t row){
+        for (std::size_t field=0; field<=lastField; field++){
+            const char* fieldEnd = static_cast<const char*>(std::memchr(p, ',', e - p));
+            if (!fieldEnd){
+                if (field < lastField)
+                    invalidValue(field + 1);
+                fieldEnd = e;
+            }
+            if (int column = binding[field]; column >= 0){
+                while (p < fieldEnd && (*p == ' ' || *p == '\t'))
+                    p++;
+                std::from_chars_result r = integralParsers[column] ? (this->*integralParsers[column])(p, fieldEnd, row)
+                                                                   : std::from_chars(p, fieldEnd, targets[column][row]);
+                if (r.ec != std::errc())
+                    invalidValue(field);
+                for (p = r.ptr; p < fieldEnd && (*p == ' ' || *p == '\t' || *p == '\r'); p++);
+                if (p != fieldEnd)
+                    invalidValue(field);
+            }
+            p = fieldEnd + 1;
+        }
+    }
+
+    void readHeader(std::initializer_list<std::string_view> names){
+        const char* lineEnd = nextLine();
+        if (!lineEnd)
+            throw std::runtime_error("CSV has no header.");
+        std::string_view header(buffer.data() + begin, lineEnd - buffer.data() - begin);
+        if (header.starts_with("\xEF\xBB\xBF"))
+            header.remove_prefix(3);
+
+        std::vector<std::string_view> fields;
+        for (std::size_t start = 0;;){
+            std::size_t comma = header.find(',', start);
+            fields.push_back(Helper::trimField(header.substr(start, comma - start)));
+            if (comma == std::string_view::npos)
+                break;
+            start = comma + 1;
+        }
+
+        if (names.size() != 0 && names.size() != columnCount)
+            throw std::invalid_argument("Number of CSV column names differs from number of columns.");
+        if (names.size() == 0 && fields.size() < columnCount)
+            throw std::invalid_argument("CSV has too few columns.");
+        binding.assign(fields.size(), -1);
+        for (std::size_t i=0; i<columnCount; i++){
+            std::size_t field = i;
+            if (names.size() != 0){
+                std::string_view name = names.begin()[i];
+                for (field=0; field<fields.size(); field++)
+                    if (fields[field].substr(0, fields[field].find('[')) == name)
+                        break;
+                if (field == fields.size())
+                    throw std::invalid_argument("CSV has no column " + std::string(name) + ".");
+            }
+            if (binding[field] >= 0)
+                throw std::invalid_argument("CSV column bound twice.");
+            binding[field] = int(i);
+            lastField = std::max(lastField, field);
+
+            std::string_view f = fields[field];
+            units[i] = DynamicUnit();
+            if (std::size_t open = f.find('['); open != std::string_view::npos){
+                std::string_view unit = f.substr(open + 1);
+                if (!unit.ends_with(']'))
+                    throw std::invalid_argument("Invalid unit of CSV column " + std::string(f) + ".");
+                unit = Helper::trimField(unit.substr(0, unit.size() - 1));
+                std::from_chars_result r = parseUnit(unit, units[i]);
+                if (r.ec != std::errc() || r.ptr != unit.data() + unit.size())
+                    throw std::invalid_argument("Invalid unit of CSV column " + std::string(f) + ".");
+            }
+        }
+        consumeLine(lineEnd);
+    }
+
+    // Parses field of integral column `c`: directly as `T` if the column is
+    // stored in its unit, otherwise as double whose converted value must fit
+    // `T`.
+    template <std::size_t c>
+    std::from_chars_result parseIntegral(const char* p, const char* e, std::size_t row){
+        typedef typename ColumnType<c>::ValueType T;
+        if (factors[c] == 1)
+            return std::from_chars(p, e, std::get<c>(values).data()[row]);
+        std::from_chars_result r = std::from_chars(p, e, targets[c][row]);
+        if (r.ec == std::errc() && !Helper::fitsIntegral<T>(targets[c][row] * factors[c]))
+            r.ec = std::errc::result_out_of_range;
+        return r;
+    }
+
+    template <std::size_t... i>
+    void bindColumns(std::index_sequence<i...>){
+        auto bind = [&]<std::size_t c>(std::integral_constant<std::size_t, c>){
+            typedef typename ColumnType<c>::UnitType Unit;
+            typedef typename ColumnType<c>::ValueType T;
+            constexpr DynamicUnit unit = DynamicUnit::of<Unit>();
+            if (units[c].dimension != unit.dimension)
+                throw DimensionError("CSV column has different dimension.");
+            factors[c] = units[c].ratioTo(unit);
+            std::get<c>(values) = QuantityVector<Unit, T>(chunk);
+            integralParsers[c] = nullptr;
+            if constexpr (std::is_integral<T>::value)
+                integralParsers[c] = &QuantityCsvReader::parseIntegral<c>;
+            if constexpr (std::is_same<T, double>::value)
+                targets[c] = std::get<c>(values).data();
+            else {
+                if (!std::is_integral<T>::value || factors[c] != 1)
+                    parsed[c].resize(chunk);
+                targets[c] = parsed[c].data();
+            }
+        };
+        (bind(std::integral_constant<std::size_t, i>()), ...);
+    }
+
+    template <std::size_t... i>
+    void convertColumns(std::index_sequence<i...>) noexcept{
+        auto convert = [&]<std::size_t c>(std::integral_constant<std::size_t, c>){
+            typedef typename ColumnType<c>::ValueType T;
+            if constexpr (std::is_same<T, double>::value){
+                if (factors[c] != 1)
+                    Helper::convertValues(targets[c], targets[c], count, factors[c]);
+            } else if (!std::is_integral<T>::value || factors[c] != 1)
+                Helper::convertValues(std::get<c>(values).data(), targets[c], count, factors[c]);
+        };
+        (convert(std::integral_constant<std::size_t, i>()), ...);
+    }
+
+public:
+    /**
+     * @brief Reads header of CSV from `in` and binds its columns.
+     *
+     * @param in Stream of CSV; must outlive the reader.
+     * @param names Names of columns bound to `Quantities`, without units. If
+     * empty, first columns of the file are bound in order.
+     * @param chunk Maximum number of rows read by one `read()`.
+     */
+    explicit QuantityCsvReader(std::istream& in, std::initializer_list<std::string_view> names = {}, std::size_t chunk = 1 << 16)
+        :in(in), buffer(bufferSize), chunk(chunk){
+        if (chunk == 0)
+            throw std::invalid_argument("CSV chunk must not be empty.");
+        readHeader(names);
+        bindColumns(std::index_sequence_for<Quantities...>());
+    }
+
+    QuantityCsvReader(const QuantityCsvReader&) = delete;
+    QuantityCsvReader& operator=(const QuantityCsvReader&) = delete;
+
+    /**
+     * @brief Unit of `i`-th bound column, as written in the file.
+     */
+    inline const DynamicUnit& unit(std::size_t i) const noexcept{
+        return units[i];
+    }
+
+    /**
+     * @brief Reads next chunk of rows, replacing the previous one.
+     *
+     * Empty lines are skipped.
+     *
+     * @return number of rows read; zero at end of input.
+     */
+    std::size_t read(){
+        count = 0;
+        while (count < chunk){
+            const char* lineEnd = nextLine();
+            if (!lineEnd)
+                break;
+            const char* lineBegin = buffer.data() + begin;
+            if (lineBegin != lineEnd && !(lineEnd - lineBegin == 1 && *lineBegin == '\r'))
+                parseLine(lineBegin, lineEnd, count++);
+            consumeLine(lineEnd);
+        }
+        convertColumns(std::index_sequence_for<Quantities...>());
+        return count;
+    }
+
+    /**
+     * @brief Number of rows of the last chunk read.
+     */
+    inline std::size_t rows() const noexcept{
+        return count;
+    }
+
+    /**
+     * @brief Values of `i`-th bound column in the last chunk read.
+     */
+    template <std::size_t i>
+    inline QuantitySpan<typename ColumnType<i>::UnitType, const typename ColumnType<i>::ValueType> column() const noexcept{
+        return QuantitySpan<typename ColumnType<i>::UnitType,
+                            const typename ColumnType<i>::ValueType>(std::get<i>(values).data(), count);
+    }
+};
+
+}
+
+#endif // QUANTITYCSV_H
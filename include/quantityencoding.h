@@ -0,0 +1,228 @@
+#ifndef QUANTITYENCODING_H
+#define QUANTITYENCODING_H
+
+#include "dynamicquantity.h"
+#include "quantityvector.h"
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @file quantityencoding.h
+ *
+ * Binary encoding of arrays of quantities, for exchanging them between
+ * processes.
+ *
+ * Encoded array consists of a header of `encodedHeaderSize` bytes, followed
+ * by values in native byte order. Header records number of values, their
+ * underlying type, and their unit as a `UnitTag` followed by its full
+ * `UnitSignature`. Decoder compares tag of encoded unit with tag of expected
+ * unit: if they are equal (and so are signatures, which guards against
+ * collisions) values are copied, otherwise values are converted to expected
+ * unit in a single pass.
+ */
+
+namespace LibUnit{
+
+/**
+ * @brief Compact identifier of a unit: a 64-bit hash of its signature.
+ *
+ * Units of equal signatures, ie. `Metre` and `Kilo<Mili<Metre>>`, have equal
+ * tags.
+ */
+typedef std::uint64_t UnitTag;
+
+/**
+ * @brief Tag of unit of given signature.
+ */
+inline constexpr UnitTag unitTag(const UnitSignature& s) noexcept{
+    // FNV-1a over all fields of the signature.
+    std::uint64_t fields[] = {s.dimension, std::uint64_t(s.numerator), std::uint64_t(s.denominator),
+                              std::uint64_t(std::uint32_t(s.exponent)) << 32 | std::uint32_t(s.piExponent),
+                              std::bit_cast<std::uint64_t>(s.inexact)};
+    UnitTag hash = 0xcbf29ce484222325ull;
+    for (std::uint64_t f: fields)
+        for (int i=0; i<8; i++){
+            hash ^= (f >> (8*i)) & 0xff;
+            hash *= 0x100000001b3ull;
+        }
+    return hash;
+}
+
+/**
+ * @brief Tag of static unit `Unit`, computed at compile time.
+ */
+template <typename Unit>
+inline constexpr UnitTag unitTag() noexcept{
+    constexpr UnitTag tag = unitTag(UnitSignature::of<Unit>());
+    return tag;
+}
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Header of encoded array of quantities.
+ */
+class EncodedHeader{
+public:
+    static constexpr std::uint32_t encodingMagic = 0x4c555131;  // "LUQ1"
+
+    std::uint32_t magic;
+    std::uint32_t valueType;    // valueTypeCode() of encoded values
+    std::uint64_t count;
+    UnitTag tag;
+    UnitSignature unit;
+};
+
+static_assert(sizeof(EncodedHeader) == 64, "Unexpected layout of encoded quantities header.");
+
+/**
+ * @brief Reads and validates header of encoded array of `T` values.
+ *
+ * Throws if buffer is not a valid encoding, or values have different type.
+ */
+template <typename T>
+inline EncodedHeader readEncodedHeader(const std::byte* in, std::size_t size){
+    EncodedHeader h;
+    if (size < sizeof(h))
+        throw std::runtime_error("Invalid encoded quantities.");
+    std::memcpy(&h, in, sizeof(h));
+    if (h.magic != EncodedHeader::encodingMagic || h.count > (size - sizeof(h)) / sizeof(T) || !h.unit.isValid())
+        throw std::runtime_error("Invalid encoded quantities.");
+    if (h.valueType != valueTypeCode<T>())
+        throw std::invalid_argument("Encoded quantities have different value type.");
+    return h;
+}
+
+}
+
+/** @endcond */
+
+/**
+ * @brief Size of header of encoded array, in bytes.
+ */
+constexpr std::size_t encodedHeaderSize = sizeof(Helper::EncodedHeader);
+
+/**
+ * @brief Number of bytes needed to encode `count` values of type `T`.
+ */
+template <typename T = double>
+inline constexpr std::size_t encodedSize(std::size_t count) noexcept{
+    return encodedHeaderSize + count * sizeof(T);
+}
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @name Encoding functions.
+ *
+ * Encode quantities of a span or vector into buffer `out`, which must have
+ * at least `encodedSize<T>(size)` bytes, or into a new byte vector.
+ *
+ * @return number of bytes written, or encoded bytes.
+ */
+//@{
+template <typename Unit, typename T>
+inline std::size_t encode(QuantitySpan<Unit, const T> values, std::byte* out) noexcept{
+    Helper::EncodedHeader h;
+    h.magic = Helper::EncodedHeader::encodingMagic;
+    h.valueType = Helper::valueTypeCode<T>();
+    h.count = values.size();
+    h.tag = unitTag<Unit>();
+    h.unit = UnitSignature::of<Unit>();
+    std::memcpy(out, &h, sizeof(h));
+    std::memcpy(out + sizeof(h), values.data(), values.size() * sizeof(T));
+    return encodedSize<T>(values.size());
+}
+
+template <typename Unit, typename T>
+inline std::size_t encode(QuantitySpan<Unit, T> values, std::byte* out) noexcept{
+    return encode(QuantitySpan<Unit, const T>(values), out);
+}
+
+template <typename Unit, typename T>
+inline std::size_t encode(const QuantityVector<Unit, T>& values, std::byte* out) noexcept{
+    return encode(QuantitySpan<Unit, const T>(values), out);
+}
+
+template <typename A>
+inline std::vector<std::byte> encode(const A& values){
+    std::vector<std::byte> result(encodedSize<typename A::ValueType>(values.size()));
+    encode(values, result.data());
+    return result;
+}
+//@}
+
+/**
+ * @brief Number of quantities encoded in buffer `in` of `size` bytes.
+ *
+ * If buffer is not a valid encoding of values of type `T`,
+ * `std::runtime_error` is thrown.
+ */
+template <typename T = double>
+inline std::size_t encodedCount(const std::byte* in, std::size_t size){
+    return Helper::readEncodedHeader<T>(in, size).count;
+}
+
+/**
+ * @brief Decodes quantities from buffer `in` of `size` bytes into span `out`,
+ * converting them to `Unit`.
+ *
+ * If encoded unit has the same tag and signature as `Unit`, values are
+ * copied; otherwise they are converted by exact ratio of encoded unit and
+ * `Unit`, rounded once.
+ *
+ * Header is checked before any value is written:
+ *  - if buffer is not a valid encoding, `std::runtime_error` is thrown;
+ *  - if encoded values are not of type `T`, or their number differs from
+ *    size of `out`, `std::invalid_argument` is thrown;
+ *  - if encoded unit has different dimension than `Unit`, `DimensionError`
+ *    is thrown.
+ *
+ * If a converted integral value does not fit `T`, `std::out_of_range` is
+ * thrown after all values are written.
+ *
+ * @return number of bytes read.
+ */
+template <typename Unit, typename T>
+std::size_t decode(const std::byte* in, std::size_t size, QuantitySpan<Unit, T> out){
+    Helper::EncodedHeader h = Helper::readEncodedHeader<T>(in, size);
+    Helper::checkSizes(h.count, out.size());
+    const std::byte* values = in + sizeof(h);
+    if (h.tag != unitTag<Unit>() || h.unit != UnitSignature::of<Unit>()){
+        constexpr UnitSignature unit = UnitSignature::of<Unit>();
+        if (h.unit.dynamicDimension() != unit.dynamicDimension())
+            throw DimensionError("Encoded quantities have different dimension.");
+        ExactFactor ratio = h.unit.factor() / unit.factor();
+        if (reinterpret_cast<std::uintptr_t>(values) % alignof(T) == 0)
+            Helper::scaleValues(out.data(), reinterpret_cast<const T*>(values), h.count, ratio);
+        else {
+            std::memcpy(out.data(), values, h.count * sizeof(T));
+            Helper::scaleValues(out.data(), out.data(), h.count, ratio);
+        }
+    } else
+        std::memcpy(out.data(), values, h.count * sizeof(T));
+    return encodedSize<T>(h.count);
+}
+
+/**
+ * @brief Decodes quantities from buffer `in` of `size` bytes into a new
+ * vector, converting them to `Unit`.
+ *
+ * Like `decode()` into a span, but vector has size of encoded array.
+ */
+template <typename Unit, typename T = double>
+QuantityVector<Unit, T> decode(const std::byte* in, std::size_t size){
+    QuantityVector<Unit, T> result(encodedCount<T>(in, size));
+    decode(in, size, QuantitySpan<Unit, T>(result));
+    return result;
+}
+
+}
+
+#endif // QUANTITYENCODING_H
@@ -0,0 +1,465 @@
+#ifndef QUANTITYEXPRESSION_H
+#define QUANTITYEXPRESSION_H
+
+#include "quantity.h"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+/**
+ * @file quantityexpression.h
+ *
+ * Lazy elementwise expressions over arrays of quantities.
+ */
+
+namespace LibUnit{
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T = double>
+class QuantityVector;
+/** @endcond */
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Checks if `T` is a `Quantity`.
+ */
+template <typename T>
+class IsQuantity: public std::false_type{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T>
+class IsQuantity<Quantity<Unit, T>>: public std::true_type{};
+/** @endcond */
+
+/**
+ * @brief Checks if `T` is a non-quantity operand of elementwise operators,
+ * ie. neither an array nor a quantity.
+ */
+template <typename T>
+class IsScalar: public std::integral_constant<bool, !IsQuantity<T>::value && !IsQuantityArray<T>::value>{};
+
+/**
+ * @brief Number of elements evaluated by a single step of `evaluateKernel`;
+ * must match unroll pragmas there.
+ */
+constexpr std::size_t vectorBlock = 8;
+
+/**
+ * @brief Throws `std::invalid_argument` if sizes of arrays are different.
+ */
+inline void checkSizes(std::size_t a, std::size_t b){
+    if (a != b)
+        throw std::invalid_argument("Sizes of quantity arrays are different.");
+}
+
+/**
+ * @brief Converts a single value from unit `From` to unit `To` and type `R`,
+ * like converting constructor of `Quantity`.
+ */
+template <typename From, typename To, typename R, typename A>
+inline constexpr R convertValue(A a) noexcept(IsNothrow<R, A>::value){
+    if constexpr (std::is_integral<R>::value && std::is_integral<A>::value)
+        return ConvertIntegral<From, To>::template value<R>(a);
+    else
+        return static_cast<R>(Convert<From, To>::value(a));
+}
+
+/**
+ * @brief Evaluates expression `e` of `n` elements, converts results to unit
+ * `To` and stores them in `out`.
+ *
+ * Whole expression is evaluated in a single pass. Elements are evaluated in
+ * blocks of constant size into a local buffer, and then stored. Blocks are
+ * unrolled into straight-line code, which compilers vectorize even at `-O2`,
+ * where loops of unknown trip count usually are not. Because a block is
+ * stored only after it is evaluated, `out` may be one of arrays read by `e`.
+ */
+template <typename To, typename R, typename E>
+inline void evaluateKernel(R* out, const E& e, std::size_t n){
+    typedef typename E::UnitType From;
+    checkConvertible<From, To>();
+    std::size_t i = 0;
+    for (; i + vectorBlock <= n; i += vectorBlock){
+        R block[vectorBlock];
+#pragma GCC unroll 8
+        for (std::size_t j=0; j<vectorBlock; j++)
+            block[j] = convertValue<From, To, R>(e.evaluate(i + j));
+#pragma GCC unroll 8
+        for (std::size_t j=0; j<vectorBlock; j++)
+            out[i + j] = block[j];
+    }
+    for (; i<n; i++)
+        out[i] = convertValue<From, To, R>(e.evaluate(i));
+}
+
+/**
+ * @brief Multiplies `n` values by exact factor `f`.
+ *
+ * Factor is rounded to a floating point type once. Integral values are
+ * multiplied by rational factors exactly, with the product computed in a
+ * 128-bit integer and divided with rounding toward zero, like by
+ * `ConvertIntegral`; irrational factors are applied in `long double`. If
+ * any integral result does not fit `T`, or without 128-bit integers any
+ * product does not fit `std::intmax_t`, `std::out_of_range` is thrown after
+ * all values are processed, and content of `out` is unspecified. `out` may
+ * equal `in`.
+ */
+template <typename T>
+inline void scaleValues(T* out, const T* in, std::size_t n, const ExactFactor& f){
+    if constexpr (std::is_integral<T>::value){
+        bool fits = true;
+        if (f.isRational()){
+#ifdef __SIZEOF_INT128__
+            __extension__ typedef __int128 Wide;
+            Wide num = f.rationalNumerator();
+            Wide den = f.rationalDenominator();
+            for (std::size_t i=0; i<n; i++){
+                Wide result = RoundTowardZero::divide<Wide>(static_cast<Wide>(in[i]) * num, den);
+                bool valid = result >= std::numeric_limits<T>::min() && result <= std::numeric_limits<T>::max();
+                fits &= valid;
+                out[i] = valid ? static_cast<T>(result) : T();
+            }
+#else
+            std::intmax_t num = f.rationalNumerator();
+            std::intmax_t den = f.rationalDenominator();
+            constexpr long double limit = std::numeric_limits<std::intmax_t>::max();
+            for (std::size_t i=0; i<n; i++){
+                bool valid = std::fabs(static_cast<long double>(in[i]) * num) < limit;
+                std::intmax_t result = valid ? RoundTowardZero::divide<std::intmax_t>(static_cast<std::intmax_t>(in[i]) * num, den) : 0;
+                valid = valid && result >= std::intmax_t(std::numeric_limits<T>::min()) &&
+                        (result < 0 || std::uintmax_t(result) <= std::uintmax_t(std::numeric_limits<T>::max()));
+                fits &= valid;
+                out[i] = valid ? static_cast<T>(result) : T();
+            }
+#endif
+        } else {
+            long double factor = f.as<long double>();
+            // Results are truncated, so valid ones lie strictly between
+            // these bounds; both are exactly representable.
+            constexpr long double low = static_cast<long double>(std::numeric_limits<T>::min()) - 1;
+            const long double high = std::ldexp(1.0L, std::numeric_limits<T>::digits);
+            for (std::size_t i=0; i<n; i++){
+                long double result = in[i] * factor;
+                bool valid = result > low && result < high;
+                fits &= valid;
+                out[i] = valid ? static_cast<T>(result) : T();
+            }
+        }
+        if (!fits)
+            throw std::out_of_range("Scaled quantity value out of range of its type.");
+    } else {
+        T factor = f.as<T>();
+        std::size_t full = n - n % vectorBlock;
+        for (std::size_t i=0; i<full; i+=vectorBlock){
+#pragma GCC unroll 8
+            for (std::size_t j=0; j<vectorBlock; j++)
+                out[i + j] = in[i + j] * factor;
+        }
+        for (std::size_t i=full; i<n; i++)
+            out[i] = in[i] * factor;
+    }
+}
+
+/**
+ * @brief Base class of expression nodes.
+ *
+ * @tparam Derived Type of the node.
+ * @tparam Unit Unit of node values.
+ * @tparam T Underlying type of node values.
+ *
+ * Each node defines `size()` and `evaluate(i)`, which computes underlying
+ * value of `i`-th element.
+ */
+template <typename Derived, typename Unit, typename T>
+class ExpressionNode: public QuantityArray{
+public:
+    typedef Unit UnitType;  //!< Unit of expression values.
+    typedef T ValueType;    //!< Underlying type of expression values.
+
+    /**
+     * @brief Quantity at index `i`, evaluated on access.
+     */
+    inline Quantity<Unit, T> operator[](std::size_t i) const noexcept(IsNothrow<T>::value){
+        return Quantity<Unit, T>(static_cast<const Derived&>(*this).evaluate(i));
+    }
+
+    inline const Derived& node() const noexcept{
+        return static_cast<const Derived&>(*this);
+    }
+};
+
+/**
+ * @brief Leaf node referring to contiguous values of an array.
+ */
+template <typename Unit, typename T>
+class ArrayNode: public ExpressionNode<ArrayNode<Unit, T>, Unit, T>{
+private:
+    const T* values;
+    std::size_t n;
+
+public:
+    inline constexpr ArrayNode(const T* data, std::size_t size) noexcept
+        :values(data), n(size)
+    {}
+
+    inline constexpr std::size_t size() const noexcept{
+        return n;
+    }
+
+    inline constexpr T evaluate(std::size_t i) const noexcept(IsNothrow<T>::value){
+        return values[i];
+    }
+};
+
+/**
+ * @brief Leaf node of a single value, broadcast to all elements.
+ *
+ * Scalar nodes have no size of their own.
+ */
+template <typename Unit, typename T>
+class ScalarNode: public ExpressionNode<ScalarNode<Unit, T>, Unit, T>{
+private:
+    T t;
+
+public:
+    inline constexpr explicit ScalarNode(T value) noexcept(IsNothrow<T>::value)
+        :t(value)
+    {}
+
+    inline constexpr T evaluate(std::size_t) const noexcept(IsNothrow<T>::value){
+        return t;
+    }
+};
+
+template <typename T>
+class IsScalarNode: public std::false_type{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T>
+class IsScalarNode<ScalarNode<Unit, T>>: public std::true_type{};
+/** @endcond */
+
+/**
+ * @brief Node applying binary operation `Op` to elements of two nodes.
+ *
+ * Operands are held by value; leaf nodes only refer to values of arrays, so
+ * expressions are cheap to copy, but arrays must outlive them.
+ */
+template <typename Unit, typename Op, typename L, typename R>
+class BinaryNode: public ExpressionNode<BinaryNode<Unit, Op, L, R>, Unit,
+                                        decltype(Op::apply(std::declval<typename L::ValueType>(), std::declval<typename R::ValueType>()))>{
+private:
+    L l;
+    R r;
+
+public:
+    inline BinaryNode(const L& left, const R& right)
+        :l(left), r(right)
+    {
+        if constexpr (!IsScalarNode<L>::value && !IsScalarNode<R>::value)
+            checkSizes(l.size(), r.size());
+    }
+
+    inline constexpr std::size_t size() const noexcept{
+        if constexpr (IsScalarNode<L>::value)
+            return r.size();
+        else
+            return l.size();
+    }
+
+    inline constexpr auto evaluate(std::size_t i) const{
+        return Op::apply(l.evaluate(i), r.evaluate(i));
+    }
+};
+
+/**
+ * @name Elementwise operations.
+ *
+ * Right operands of addition and subtraction are converted to unit `To` of
+ * the left operand. Conversion factors are compile time constants, so they
+ * are applied once per element and hoisted out of evaluation loops, just
+ * like in operators of `Quantity`.
+ */
+//@{
+template <typename From, typename To>
+class AddOp{
+public:
+    template <typename A, typename B>
+    static inline constexpr auto apply(A a, B b) noexcept(IsNothrow<A, B>::value){
+        return a + Convert<From, To>::value(b);
+    }
+};
+
+template <typename From, typename To>
+class SubtractOp{
+public:
+    template <typename A, typename B>
+    static inline constexpr auto apply(A a, B b) noexcept(IsNothrow<A, B>::value){
+        return a - Convert<From, To>::value(b);
+    }
+};
+
+class MultiplyOp{
+public:
+    template <typename A, typename B>
+    static inline constexpr auto apply(A a, B b) noexcept(IsNothrow<A, B>::value){
+        return a * b;
+    }
+};
+
+class DivideOp{
+public:
+    template <typename A, typename B>
+    static inline constexpr auto apply(A a, B b) noexcept(IsNothrow<A, B>::value){
+        return a / b;
+    }
+};
+//@}
+
+/**
+ * @brief Expression node of an operand of elementwise operators.
+ *
+ * Arrays give their own nodes, quantities and non-quantity values give
+ * scalar nodes.
+ */
+template <typename T>
+inline auto makeNode(const T& t){
+    if constexpr (IsQuantityArray<T>::value)
+        return t.node();
+    else
+        return ScalarNode<Compound<>, T>(t);
+}
+
+template <typename Unit, typename T>
+inline auto makeNode(const Quantity<Unit, T>& q){
+    return ScalarNode<Unit, T>(q.value());
+}
+
+/**
+ * @brief Checks if `A` and `B` can be operands of elementwise addition or
+ * subtraction: at least one of them must be an array, and the other one an
+ * array or a quantity.
+ */
+template <typename A, typename B>
+class IsArraySum: public std::integral_constant<bool, (IsQuantityArray<A>::value || IsQuantityArray<B>::value)
+                                                      && !IsScalar<A>::value && !IsScalar<B>::value>{};
+
+/**
+ * @brief Checks if `A` and `B` can be operands of elementwise multiplication
+ * or division: at least one of them must be an array.
+ */
+template <typename A, typename B>
+class IsArrayProduct: public std::integral_constant<bool, IsQuantityArray<A>::value || IsQuantityArray<B>::value>{};
+
+/**
+ * @brief Unit of product of elementwise operands of units `Unit` and `U`.
+ *
+ * Like operators of `Quantity`, multiplication by a non-quantity value keeps
+ * unit of the other operand.
+ */
+template <typename A, typename B, typename Unit, typename U>
+using ProductUnit = typename std::conditional<IsScalar<A>::value, U,
+                    typename std::conditional<IsScalar<B>::value, Unit, LibUnit::Simplify<LibUnit::Join<Unit, U>>>::type>::type;
+
+/**
+ * @brief Unit of quotient of elementwise operands of units `Unit` and `U`.
+ *
+ * Like operators of `Quantity`, division of a non-quantity value gives
+ * inverted unit of the divisor, and division by non-quantity value keeps
+ * unit of the dividend.
+ */
+template <typename A, typename B, typename Unit, typename U>
+using QuotientUnit = typename std::conditional<IsScalar<A>::value, LibUnit::Invert<U>,
+                     typename std::conditional<IsScalar<B>::value, Unit, LibUnit::Simplify<LibUnit::Join<Unit, LibUnit::Invert<U>>>>::type>::type;
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @name Elementwise operators of arrays of quantities.
+ *
+ * Operands are `QuantityVector`, `QuantitySpan`, expressions returned by
+ * these operators, single quantities and, for multiplication and division,
+ * non-quantity values. At least one operand must be an array.
+ *
+ * Operators do not compute anything. They return expression nodes, which
+ * record the operation and refer to values of operand arrays. The whole
+ * expression is evaluated in a single pass over memory when it is assigned
+ * to a `QuantityVector` or `QuantitySpan`, or passed to `evaluate()`:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * QuantityVector<Joule> e = 0.5*m*v*v + m*g*h; // one loop, no temporaries
+ * ~~~~~~~~~~~~~~~~~~~~
+ *
+ * Units of expressions are computed at compile time, using the same rules
+ * as operators of `Quantity`:
+ *  - addition and subtraction give unit of the left operand; right operand
+ *    is scaled using `RatioFactorOf`;
+ *  - multiplication gives unit `Simplify<Join<Unit, U>>`;
+ *  - division gives unit `Simplify<Join<Unit, Invert<U>>>`.
+ *
+ * If dimensions of added or subtracted operands are different, compilation
+ * error is generated. If sizes of arrays are different,
+ * `std::invalid_argument` is thrown.
+ *
+ * Expressions refer to operand arrays, so they must not outlive them.
+ */
+//@{
+template <typename A, typename B, typename = std::enable_if_t<Helper::IsArraySum<A, B>::value>>
+inline auto operator+(const A& a, const B& b){
+    auto l = Helper::makeNode(a);
+    auto r = Helper::makeNode(b);
+    typedef typename decltype(l)::UnitType Unit;
+    typedef typename decltype(r)::UnitType U;
+    checkConvertible<U, Unit>();
+    return Helper::BinaryNode<Unit, Helper::AddOp<U, Unit>, decltype(l), decltype(r)>(l, r);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<Helper::IsArraySum<A, B>::value>>
+inline auto operator-(const A& a, const B& b){
+    auto l = Helper::makeNode(a);
+    auto r = Helper::makeNode(b);
+    typedef typename decltype(l)::UnitType Unit;
+    typedef typename decltype(r)::UnitType U;
+    checkConvertible<U, Unit>();
+    return Helper::BinaryNode<Unit, Helper::SubtractOp<U, Unit>, decltype(l), decltype(r)>(l, r);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<Helper::IsArrayProduct<A, B>::value>>
+inline auto operator*(const A& a, const B& b){
+    auto l = Helper::makeNode(a);
+    auto r = Helper::makeNode(b);
+    typedef Helper::ProductUnit<A, B, typename decltype(l)::UnitType, typename decltype(r)::UnitType> Unit;
+    return Helper::BinaryNode<Unit, Helper::MultiplyOp, decltype(l), decltype(r)>(l, r);
+}
+
+template <typename A, typename B, typename = std::enable_if_t<Helper::IsArrayProduct<A, B>::value>>
+inline auto operator/(const A& a, const B& b){
+    auto l = Helper::makeNode(a);
+    auto r = Helper::makeNode(b);
+    typedef Helper::QuotientUnit<A, B, typename decltype(l)::UnitType, typename decltype(r)::UnitType> Unit;
+    return Helper::BinaryNode<Unit, Helper::DivideOp, decltype(l), decltype(r)>(l, r);
+}
+//@}
+
+/**
+ * @brief Evaluates an expression into a new `QuantityVector` of the same
+ * unit and underlying type.
+ */
+template <typename E, typename = std::enable_if_t<Helper::IsQuantityArray<E>::value>>
+inline auto evaluate(const E& e){
+    return QuantityVector<typename E::UnitType, typename E::ValueType>(e);
+}
+
+}
+
+#endif // QUANTITYEXPRESSION_H
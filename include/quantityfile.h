@@ -0,0 +1,650 @@
+#ifndef QUANTITYFILE_H
+#define QUANTITYFILE_H
+
+#include "dynamicquantity.h"
+#include "quantityvector.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file quantityfile.h
+ *
+ * Columnar files of quantities, read by memory mapping.
+ *
+ * A file consists of a header, one header per column and values of columns.
+ * Column header records unit of its values as a `UnitSignature` (dimension
+ * exponents and exact factor) and their underlying type. Values of each
+ * column are contiguous, so a column is viewed as a `QuantitySpan` directly
+ * in mapped memory, without copying, and opening a file costs the same
+ * regardless of its size.
+ *
+ * Files are written by `QuantityFileWriter` and read by `QuantityFile`, which
+ * converts columns stored in other units of the requested dimensions.
+ * Values are stored in native byte order; files written on a platform of
+ * different byte order are rejected. Requires POSIX `mmap`.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Header at the beginning of a quantity file.
+ */
+class FileHeader{
+public:
+    static constexpr char fileMagic[8] = {'L', 'I', 'B', 'U', 'N', 'I', 'T', 'Q'};
+    static constexpr std::uint32_t currentVersion = 1;
+    static constexpr std::uint32_t nativeOrder = 0x01020304;
+
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;    // nativeOrder, as written by the writer
+    std::uint64_t columns;
+    std::uint64_t rows;
+    std::uint64_t capacity;     // Number of rows for which columns have space
+    std::uint64_t reserved[3];
+};
+
+/**
+ * @brief Header of a column of a quantity file.
+ */
+class ColumnHeader{
+public:
+    UnitSignature unit;
+    std::uint32_t valueType;    // valueTypeCode() of stored values
+    std::uint32_t reserved;
+    std::uint64_t offset;       // Offset of first value from the beginning of file
+    std::uint64_t reserved2;
+};
+
+static_assert(sizeof(FileHeader) == 64 && sizeof(ColumnHeader) == 64, "Unexpected layout of quantity file headers.");
+
+/**
+ * @brief Alignment of column values in a file.
+ */
+constexpr std::size_t columnAlignment = 64;
+
+inline constexpr std::uint64_t alignColumn(std::uint64_t n) noexcept{
+    return (n + columnAlignment - 1) / columnAlignment * columnAlignment;
+}
+
+/**
+ * @brief Throws `std::system_error` of current `errno`.
+ */
+[[noreturn]] inline void throwSystemError(const std::string& what){
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/**
+ * @brief Synchronizes directory containing `path` to storage, so that a file
+ * renamed to `path` stays there after a crash.
+ */
+inline void syncDirectoryOf(const std::string& path){
+    std::string::size_type slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+    int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throwSystemError(directory);
+    if (::fsync(fd) != 0){
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        throwSystemError(directory);
+    }
+    ::close(fd);
+}
+
+/**
+ * @brief Unit and underlying type of a column of `QuantityFileWriter`.
+ */
+template <typename Q>
+class FileColumn;
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T>
+class FileColumn<Quantity<Unit, T>>{
+public:
+    typedef Unit UnitType;
+    typedef T ValueType;
+};
+/** @endcond */
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Read-only memory mapped quantity file.
+ *
+ * Opening a file maps it to memory and validates its headers; values are read
+ * by the system as they are accessed. Columns are viewed with `column()`,
+ * which checks unit and underlying type of the column against requested ones
+ * once, and returns a span over mapped values.
+ *
+ * If a column is stored in a different unit of the requested dimension, its
+ * values are converted to the requested unit in a single vectorized pass, by
+ * exact ratio of both units rounded once. Converted values are kept by the
+ * file, so each column is converted at most once for each requested unit. To
+ * avoid conversions on following reads, migrate the file to units of its
+ * readers with `migrate()`.
+ *
+ * Spans returned by `column()` are valid as long as the file is open.
+ */
+class QuantityFile{
+private:
+    // Values of a column converted to other unit.
+    class Converted{
+    public:
+        std::size_t column;
+        UnitSignature unit;
+        std::shared_ptr<void> values;
+    };
+
+    const std::byte* map = nullptr;
+    std::size_t mapSize = 0;
+    const Helper::FileHeader* header = nullptr;
+    const Helper::ColumnHeader* columnHeaders = nullptr;
+    mutable std::vector<Converted> converted;
+    mutable std::mutex convertedMutex;
+
+    [[noreturn]] static void invalid(){
+        throw std::runtime_error("Invalid quantity file.");
+    }
+
+    void release() noexcept{
+        if (map)
+            munmap(const_cast<std::byte*>(map), mapSize);
+        map = nullptr;
+    }
+
+    const Helper::ColumnHeader& columnHeader(std::size_t i) const{
+        if (i >= columns())
+            throw std::out_of_range("Quantity file column index out of range.");
+        return columnHeaders[i];
+    }
+
+    // Checks if column can be read as quantities of unit `Unit` and type `T`.
+    template <typename Unit, typename T>
+    static void checkColumn(const Helper::ColumnHeader& c){
+        constexpr UnitSignature unit = UnitSignature::of<Unit>();
+        if (c.unit.dynamicDimension() != unit.dynamicDimension())
+            throw DimensionError("Quantity file column has different dimension.");
+        if (c.valueType != Helper::valueTypeCode<T>())
+            throw std::invalid_argument("Quantity file column has different value type.");
+    }
+
+    // Mutable values of column `i`; valid only for writable mappings.
+    inline std::byte* columnData(std::size_t i) const noexcept{
+        return const_cast<std::byte*>(map) + columnHeaders[i].offset;
+    }
+
+    QuantityFile(const std::string& path, bool writable){
+        int fd = ::open(path.c_str(), (writable ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+        if (fd < 0)
+            Helper::throwSystemError(path);
+        struct stat st;
+        if (fstat(fd, &st) != 0){
+            int error = errno;
+            ::close(fd);
+            errno = error;
+            Helper::throwSystemError(path);
+        }
+        mapSize = st.st_size;
+        if (mapSize < sizeof(Helper::FileHeader)){
+            ::close(fd);
+            invalid();
+        }
+        void* m = mmap(nullptr, mapSize, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        if (m == MAP_FAILED){
+            errno = error;
+            Helper::throwSystemError(path);
+        }
+        map = static_cast<const std::byte*>(m);
+
+        header = reinterpret_cast<const Helper::FileHeader*>(map);
+        columnHeaders = reinterpret_cast<const Helper::ColumnHeader*>(header + 1);
+        if (std::memcmp(header->magic, Helper::FileHeader::fileMagic, sizeof(header->magic)) != 0
+                || header->version != Helper::FileHeader::currentVersion
+                || header->byteOrder != Helper::FileHeader::nativeOrder
+                || header->rows > header->capacity
+                || header->columns > (mapSize - sizeof(Helper::FileHeader)) / sizeof(Helper::ColumnHeader)){
+            release();
+            invalid();
+        }
+        for (std::size_t i=0; i<columns(); i++){
+            const Helper::ColumnHeader& c = columnHeaders[i];
+            std::uint64_t size = c.valueType & 0xff;
+            if (size == 0 || c.offset % Helper::columnAlignment != 0 || c.offset > mapSize
+                    || header->capacity > (mapSize - c.offset) / size || !c.unit.isValid()){
+                release();
+                invalid();
+            }
+        }
+    }
+
+    // Checks if columns can be read as `Quantities`; returns true if any of
+    // them is stored in other unit.
+    template <std::size_t... i, typename... Quantities>
+    static bool checkColumns(std::index_sequence<i...>, const QuantityFile& file, std::tuple<Quantities...>*){
+        (checkColumn<typename Helper::FileColumn<Quantities>::UnitType,
+                     typename Helper::FileColumn<Quantities>::ValueType>(file.columnHeader(i)), ...);
+        return ((file.columnHeaders[i].unit != UnitSignature::of<typename Helper::FileColumn<Quantities>::UnitType>()) || ...);
+    }
+
+    template <std::size_t... i, typename... Quantities>
+    static void migrateColumns(std::index_sequence<i...>, QuantityFile& file, std::tuple<Quantities...>*){
+        ([&](){
+            typedef typename Helper::FileColumn<Quantities>::UnitType Unit;
+            typedef typename Helper::FileColumn<Quantities>::ValueType T;
+            Helper::ColumnHeader& c = const_cast<Helper::ColumnHeader&>(file.columnHeaders[i]);
+            constexpr UnitSignature unit = UnitSignature::of<Unit>();
+            if (c.unit == unit)
+                return;
+            T* values = reinterpret_cast<T*>(file.columnData(i));
+            Helper::scaleValues(values, values, file.rows(), c.unit.factor() / unit.factor());
+            c.unit = unit;
+        }(), ...);
+    }
+
+    // Writes mapped contents of the file to a new file, created next to
+    // `target` with a unique name and permissions `mode`; returns its path.
+    std::string copyNextTo(const std::string& target, mode_t mode) const{
+        std::string path = target + ".XXXXXX";
+        int fd = ::mkstemp(path.data());
+        if (fd < 0)
+            Helper::throwSystemError(target);
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        if (::fchmod(fd, mode) != 0){
+            int error = errno;
+            ::close(fd);
+            ::unlink(path.c_str());
+            errno = error;
+            Helper::throwSystemError(path);
+        }
+        for (std::size_t done = 0; done < mapSize;){
+            ssize_t n = ::write(fd, map + done, mapSize - done);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0){
+                int error = errno;
+                ::close(fd);
+                ::unlink(path.c_str());
+                errno = error;
+                Helper::throwSystemError(path);
+            }
+            done += n;
+        }
+        if (::close(fd) != 0){
+            int error = errno;
+            ::unlink(path.c_str());
+            errno = error;
+            Helper::throwSystemError(path);
+        }
+        return path;
+    }
+
+public:
+    /**
+     * @brief Opens and maps file `path`.
+     *
+     * If file cannot be opened or mapped, `std::system_error` is thrown; if
+     * it is not a valid quantity file, `std::runtime_error` is thrown.
+     */
+    explicit QuantityFile(const std::string& path)
+        :QuantityFile(path, false)
+    {}
+
+    QuantityFile(const QuantityFile&) = delete;
+    QuantityFile& operator=(const QuantityFile&) = delete;
+
+    ~QuantityFile(){
+        release();
+    }
+
+    /**
+     * @brief Number of columns.
+     */
+    inline std::size_t columns() const noexcept{
+        return header->columns;
+    }
+
+    /**
+     * @brief Number of values in each column.
+     */
+    inline std::size_t rows() const noexcept{
+        return header->rows;
+    }
+
+    /**
+     * @brief Unit in which values of column `i` are stored.
+     */
+    inline const UnitSignature& unit(std::size_t i) const{
+        return columnHeader(i).unit;
+    }
+
+    /**
+     * @brief View of values of column `i` as quantities of unit `Unit`.
+     *
+     * If the column is stored in `Unit`, returned span views mapped values.
+     * Otherwise values are converted to `Unit` on the first call, and span
+     * views converted values.
+     *
+     * If dimension of the column is different than dimension of `Unit`,
+     * `DimensionError` is thrown; if its values are not of type `T`,
+     * `std::invalid_argument` is thrown. Both are checked before any value is
+     * read. If a converted integral value does not fit `T`,
+     * `std::out_of_range` is thrown.
+     */
+    template <typename Unit, typename T = double>
+    QuantitySpan<Unit, const T> column(std::size_t i) const{
+        const Helper::ColumnHeader& c = columnHeader(i);
+        checkColumn<Unit, T>(c);
+        constexpr UnitSignature unit = UnitSignature::of<Unit>();
+        if (c.unit == unit)
+            return QuantitySpan<Unit, const T>(reinterpret_cast<const T*>(map + c.offset), rows());
+
+        std::lock_guard<std::mutex> lock(convertedMutex);
+        for (const Converted& conv: converted)
+            if (conv.column == i && conv.unit == unit)
+                return QuantitySpan<Unit, const T>(static_cast<const T*>(conv.values.get()), rows());
+        std::shared_ptr<T[]> values(new T[rows()]);
+        Helper::scaleValues(values.get(), reinterpret_cast<const T*>(map + c.offset), rows(), c.unit.factor() / unit.factor());
+        converted.push_back(Converted{i, unit, values});
+        return QuantitySpan<Unit, const T>(values.get(), rows());
+    }
+
+    /**
+     * @brief Converts columns of file `path` to units of `Quantities`.
+     *
+     * @tparam Quantities Types of quantities of columns, as for
+     * `QuantityFileWriter`.
+     *
+     * Columns stored in other units of the same dimension are converted like
+     * by `column()`, and their headers are updated. Dimensions and underlying
+     * types of all columns are checked, like by `column()`, before anything
+     * is written.
+     *
+     * Converted file is written to a new file with a unique name in the
+     * directory of `path`, synchronized to storage and renamed to `path`, and
+     * then the directory is synchronized too. So after a crash `path` holds
+     * either the old or the converted file, never a partially converted one,
+     * and concurrent migrations of the same file do not overwrite each
+     * other's temporary files. Readers which mapped the old file keep reading
+     * it. If no column needs conversion, file is left untouched.
+     */
+    template <typename... Quantities>
+    static void migrate(const std::string& path){
+        static_assert((Helper::IsQuantity<Quantities>::value && ...), "Columns of quantity file must be quantities.");
+        std::string temporary;
+        {
+            QuantityFile source(path, false);
+            if (source.columns() != sizeof...(Quantities))
+                throw std::invalid_argument("Number of quantities differs from number of columns.");
+            if (!checkColumns(std::index_sequence_for<Quantities...>(), source, static_cast<std::tuple<Quantities...>*>(nullptr)))
+                return;
+            struct stat st;
+            if (::stat(path.c_str(), &st) != 0)
+                Helper::throwSystemError(path);
+            temporary = source.copyNextTo(path, st.st_mode & 07777);
+        }
+        try{
+            QuantityFile file(temporary, true);
+            migrateColumns(std::index_sequence_for<Quantities...>(), file, static_cast<std::tuple<Quantities...>*>(nullptr));
+            if (msync(const_cast<std::byte*>(file.map), file.mapSize, MS_SYNC) != 0)
+                Helper::throwSystemError(temporary);
+        }
+        catch (...){
+            ::unlink(temporary.c_str());
+            throw;
+        }
+        if (std::rename(temporary.c_str(), path.c_str()) != 0){
+            int error = errno;
+            ::unlink(temporary.c_str());
+            errno = error;
+            Helper::throwSystemError(path);
+        }
+        Helper::syncDirectoryOf(path);
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writer of quantity files.
+ *
+ * @tparam Quantities Types of quantities of columns, ie.
+ * `QuantityFileWriter<Quantity<Metre>, Quantity<Second, float>>`.
+ *
+ * Writer creates a file and appends rows to it through a writable mapping.
+ * Appended quantities may have any unit of the same dimension as their
+ * column; they are converted at compile time. File grows geometrically as
+ * rows are appended, so appending a row costs amortized constant time.
+ * `close()` shrinks the file to its contents; until then the file is not
+ * meant to be read.
+ */
+template <typename... Quantities>
+class QuantityFileWriter{
+private:
+    static_assert(sizeof...(Quantities) > 0, "Quantity file without columns.");
+    static_assert((Helper::IsQuantity<Quantities>::value && ...), "Columns of quantity file must be quantities.");
+
+    static constexpr std::size_t columnCount = sizeof...(Quantities);
+    static constexpr std::size_t valueSizes[columnCount] = {sizeof(typename Helper::FileColumn<Quantities>::ValueType)...};
+
+    int fd = -1;
+    std::byte* map = nullptr;
+    std::size_t mapSize = 0;
+    std::size_t count = 0;
+    std::size_t capacity = 0;
+
+    inline Helper::FileHeader& header() const noexcept{
+        return *reinterpret_cast<Helper::FileHeader*>(map);
+    }
+
+    inline Helper::ColumnHeader& columnHeader(std::size_t i) const noexcept{
+        return reinterpret_cast<Helper::ColumnHeader*>(map + sizeof(Helper::FileHeader))[i];
+    }
+
+    template <std::size_t i>
+    inline auto columnData() const noexcept{
+        typedef typename Helper::FileColumn<std::tuple_element_t<i, std::tuple<Quantities...>>>::ValueType T;
+        return reinterpret_cast<T*>(map + columnHeader(i).offset);
+    }
+
+    // Offset of column i in a file of given capacity.
+    static constexpr std::uint64_t offset(std::size_t i, std::size_t capacity) noexcept{
+        std::uint64_t result = Helper::alignColumn(sizeof(Helper::FileHeader) + columnCount * sizeof(Helper::ColumnHeader));
+        for (std::size_t j=0; j<i; j++)
+            result += Helper::alignColumn(capacity * valueSizes[j]);
+        return result;
+    }
+
+    // Changes size of the file and maps it again.
+    void remap(std::size_t size){
+        if (map)
+            munmap(map, mapSize);
+        map = nullptr;
+        if (ftruncate(fd, size) != 0)
+            Helper::throwSystemError("Cannot resize quantity file");
+        void* m = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (m == MAP_FAILED)
+            Helper::throwSystemError("Cannot map quantity file");
+        map = static_cast<std::byte*>(m);
+        mapSize = size;
+    }
+
+    // Moves columns to offsets of a file of new capacity.
+    void moveColumns(std::size_t newCapacity) noexcept{
+        auto move = [&](std::size_t i){
+            std::uint64_t to = offset(i, newCapacity);
+            std::memmove(map + to, map + columnHeader(i).offset, count * valueSizes[i]);
+            columnHeader(i).offset = to;
+        };
+        // Columns move toward the end of file when it grows, and toward its
+        // beginning when it shrinks; moved column must not overwrite the next
+        // one not moved yet.
+        if (newCapacity > capacity)
+            for (std::size_t i=columnCount; i-->0;)
+                move(i);
+        else
+            for (std::size_t i=0; i<columnCount; i++)
+                move(i);
+        capacity = newCapacity;
+        header().capacity = newCapacity;
+    }
+
+    void grow(){
+        std::size_t newCapacity = capacity * 2;
+        remap(offset(columnCount, newCapacity));
+        moveColumns(newCapacity);
+    }
+
+    template <std::size_t... i, typename... Qs>
+    inline void appendRow(std::index_sequence<i...>, const Qs&... q) noexcept{
+        ((columnData<i>()[count] = Quantities(q).value()), ...);
+    }
+
+    template <std::size_t... i, typename... As>
+    inline void appendArrays(std::index_sequence<i...>, std::size_t n, const As&... a){
+        (QuantitySpan<typename Helper::FileColumn<Quantities>::UnitType,
+                      typename Helper::FileColumn<Quantities>::ValueType>(columnData<i>() + count, n).assign(a), ...);
+    }
+
+public:
+    /**
+     * @brief Creates file `path`, replacing existing one, with space for
+     * `capacity` rows.
+     *
+     * If file cannot be created, `std::system_error` is thrown.
+     */
+    explicit QuantityFileWriter(const std::string& path, std::size_t capacity = 4096)
+        :capacity(capacity ? capacity : 1)
+    {
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0)
+            Helper::throwSystemError(path);
+        try {
+            remap(offset(columnCount, this->capacity));
+        } catch (...){
+            ::close(fd);
+            throw;
+        }
+        Helper::FileHeader& h = header();
+        std::memcpy(h.magic, Helper::FileHeader::fileMagic, sizeof(h.magic));
+        h.version = Helper::FileHeader::currentVersion;
+        h.byteOrder = Helper::FileHeader::nativeOrder;
+        h.columns = columnCount;
+        h.capacity = this->capacity;
+        std::size_t i = 0;
+        ((columnHeader(i).unit = UnitSignature::of<typename Helper::FileColumn<Quantities>::UnitType>(),
+          columnHeader(i).valueType = Helper::valueTypeCode<typename Helper::FileColumn<Quantities>::ValueType>(),
+          columnHeader(i).offset = offset(i, this->capacity), i++), ...);
+    }
+
+    QuantityFileWriter(const QuantityFileWriter&) = delete;
+    QuantityFileWriter& operator=(const QuantityFileWriter&) = delete;
+
+    /**
+     * @brief Closes the file; errors are ignored.
+     */
+    ~QuantityFileWriter(){
+        try {
+            close();
+        } catch (...){}
+    }
+
+    /**
+     * @brief Number of appended rows.
+     */
+    inline std::size_t rows() const noexcept{
+        return count;
+    }
+
+    /**
+     * @brief Appends a row of quantities, one for each column.
+     */
+    template <typename... Qs, typename = std::enable_if_t<(Helper::IsQuantity<Qs>::value && ...)>>
+    void append(const Qs&... q){
+        static_assert(sizeof...(Qs) == columnCount, "Number of quantities differs from number of columns.");
+        if (count == capacity)
+            grow();
+        appendRow(std::index_sequence_for<Quantities...>(), q...);
+        header().rows = ++count;
+    }
+
+    /**
+     * @brief Appends rows from arrays of quantities (vectors, spans or
+     * expressions), one for each column.
+     *
+     * Arrays are converted to units of columns in a single vectorized pass
+     * each. If sizes of arrays are different, `std::invalid_argument` is
+     * thrown.
+     */
+    template <typename... As, typename = std::enable_if_t<(Helper::IsQuantityArray<As>::value && ...)>, typename = void>
+    void append(const As&... a){
+        static_assert(sizeof...(As) == columnCount, "Number of arrays differs from number of columns.");
+        std::size_t sizes[] = {Helper::makeNode(a).size()...};
+        for (std::size_t size: sizes)
+            Helper::checkSizes(sizes[0], size);
+        std::size_t n = sizes[0];
+        while (count + n > capacity)
+            grow();
+        appendArrays(std::index_sequence_for<Quantities...>(), n, a...);
+        count += n;
+        header().rows = count;
+    }
+
+    /**
+     * @brief Shrinks the file to appended rows, and closes it.
+     *
+     * If file cannot be resized, `std::system_error` is thrown.
+     */
+    void close(){
+        if (fd < 0)
+            return;
+        if (map && count < capacity){
+            std::size_t newCapacity = count;
+            moveColumns(newCapacity);
+            munmap(map, mapSize);
+            map = nullptr;
+            if (ftruncate(fd, offset(columnCount, newCapacity)) != 0){
+                ::close(fd);
+                fd = -1;
+                Helper::throwSystemError("Cannot resize quantity file");
+            }
+        }
+        if (map)
+            munmap(map, mapSize);
+        map = nullptr;
+        ::close(fd);
+        fd = -1;
+    }
+};
+
+}
+
+#endif // QUANTITYFILE_H
@@ -0,0 +1,432 @@
+#ifndef QUANTITYRING_H
+#define QUANTITYRING_H
+
+#include "dynamicquantity.h"
+#include "quantityvector.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @file quantityring.h
+ *
+ * Ring buffer of quantities in shared memory, for passing quantities between
+ * processes without copying them through pipes or sockets.
+ *
+ * Shared memory segment consists of a header and values. Header records unit
+ * of values as a `UnitSignature`, their underlying type and capacity of the
+ * ring; every process attaching to the segment checks them against its
+ * compile-time type once. Values are stored in the unit of the ring, so
+ * pushes and pops of quantities of that unit only copy values. Requires POSIX
+ * shared memory.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Header of a shared memory segment of a quantity ring.
+ *
+ * Positions are counts of values pushed or popped since creation; value at
+ * position `p` is stored in slot `p % capacity`. Counters are kept on
+ * separate cache lines.
+ *
+ * Single producer publishes values by advancing `committed`. Many producers
+ * claim space by advancing `claimed`, and publish each value separately by
+ * storing `p + 1` in entry `p % capacity` of an array that follows values, so
+ * a producer never waits for others.
+ */
+class RingHeader{
+public:
+    static constexpr std::uint32_t ringMagic = 0x4c555252;  // "LURR"
+    static constexpr std::uint32_t currentVersion = 1;
+
+    std::atomic<std::uint32_t> magic;   // Stored last, when the ring is ready
+    std::uint32_t version;
+    std::uint32_t valueType;            // valueTypeCode() of values
+    std::uint32_t multiProducer;
+    std::uint64_t capacity;             // Power of two
+    std::uint64_t reserved;
+    UnitSignature unit;
+
+    alignas(64) std::atomic<std::uint64_t> consumed;    // Position of the next value to pop
+    alignas(64) std::atomic<std::uint64_t> claimed;     // Position reserved by many producers
+    alignas(64) std::atomic<std::uint64_t> committed;   // Position published by single producer
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+              "Quantity rings require lock-free atomic counters.");
+
+}
+
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Ring buffer of quantities in POSIX shared memory.
+ *
+ * @tparam Unit Unit of stored quantities.
+ * @tparam T Underlying type of stored quantities; arithmetic.
+ * @tparam multiProducer Whether many processes or threads may push at once.
+ *
+ * One process creates the ring under a name; others attach to it by name.
+ * Attaching checks unit, underlying type and producer mode of the ring
+ * against the template parameters: if dimensions differ, `DimensionError`
+ * is thrown; if units or other parameters differ, `std::invalid_argument` is
+ * thrown. After that no unit checks are performed.
+ *
+ * Ring has a single consumer. With a single producer, push and pop are
+ * wait-free, and only move a shared counter. With many producers, each push
+ * claims space with a compare-and-exchange, and publishes each value with a
+ * separate store; producers never wait for each other, and the consumer pops
+ * values in order of claims, as they are published.
+ *
+ * Pushes accept quantities and arrays of any unit of the same dimension;
+ * they are converted to `Unit` as they are stored. Arrays are pushed and
+ * popped in as few copies as possible, and `consume()` gives the consumer
+ * views of stored values without copying them.
+ */
+template <typename Unit, typename T = double, bool multiProducer = false>
+class QuantityRing{
+private:
+    static constexpr std::size_t valuesOffset = sizeof(Helper::RingHeader);
+
+    Helper::RingHeader* header = nullptr;
+    T* slots = nullptr;
+    std::atomic<std::uint64_t>* published = nullptr;
+    std::size_t mapSize = 0;
+    std::uint64_t mask = 0;
+
+    // Size of segment of a ring of given capacity.
+    static constexpr std::uint64_t segmentSize(std::uint64_t capacity) noexcept{
+        std::uint64_t values = (capacity * sizeof(T) + 63) / 64 * 64;
+        return valuesOffset + values + (multiProducer ? capacity * sizeof(std::atomic<std::uint64_t>) : 0);
+    }
+
+    void release() noexcept{
+        if (header)
+            munmap(header, mapSize);
+        header = nullptr;
+    }
+
+    void map(int fd, std::size_t size, const std::string& name){
+        void* m = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        if (m == MAP_FAILED){
+            errno = error;
+            throw std::system_error(errno, std::generic_category(), name);
+        }
+        header = static_cast<Helper::RingHeader*>(m);
+        slots = reinterpret_cast<T*>(static_cast<std::byte*>(m) + valuesOffset);
+        mapSize = size;
+    }
+
+    // Sets capacity and locates array of published positions.
+    void setCapacity(std::uint64_t capacity) noexcept{
+        mask = capacity - 1;
+        if constexpr (multiProducer)
+            published = reinterpret_cast<std::atomic<std::uint64_t>*>(
+                        reinterpret_cast<std::byte*>(header) + segmentSize(capacity) - capacity * sizeof(std::atomic<std::uint64_t>));
+    }
+
+    // Calls f(slot, offset, count) for each part of range [position,
+    // position + n) that is contiguous in slots; offset is relative to
+    // position.
+    template <typename F>
+    inline void forParts(std::uint64_t position, std::size_t n, F f) const{
+        std::size_t first = std::min<std::size_t>(n, capacity() - (position & mask));
+        f(position & mask, std::size_t(0), first);
+        if (first < n)
+            f(std::size_t(0), first, n - first);
+    }
+
+    // Reserves space for up to n values; returns position of the first one.
+    inline std::uint64_t claim(std::size_t& n) noexcept{
+        std::uint64_t position;
+        if constexpr (multiProducer){
+            position = header->claimed.load(std::memory_order_relaxed);
+            do {
+                std::uint64_t free = capacity() - (position - header->consumed.load(std::memory_order_acquire));
+                n = std::min<std::uint64_t>(n, free);
+                if (n == 0)
+                    return position;
+            } while (!header->claimed.compare_exchange_weak(position, position + n, std::memory_order_relaxed));
+        } else {
+            position = header->committed.load(std::memory_order_relaxed);
+            std::uint64_t free = capacity() - (position - header->consumed.load(std::memory_order_acquire));
+            n = std::min<std::uint64_t>(n, free);
+        }
+        return position;
+    }
+
+    // Makes n values stored at position visible to the consumer.
+    inline void commit(std::uint64_t position, std::size_t n) noexcept{
+        if constexpr (multiProducer){
+            for (std::uint64_t p=position; p<position + n; p++)
+                published[p & mask].store(p + 1, std::memory_order_release);
+        } else
+            header->committed.store(position + n, std::memory_order_release);
+    }
+
+    // Number of values, up to max, published from position on.
+    inline std::size_t available(std::uint64_t position, std::size_t max) const noexcept{
+        if constexpr (multiProducer){
+            std::size_t n = 0;
+            while (n < max && published[(position + n) & mask].load(std::memory_order_acquire) == position + n + 1)
+                n++;
+            return n;
+        } else
+            return std::min<std::uint64_t>(max, header->committed.load(std::memory_order_acquire) - position);
+    }
+
+    template <typename U, typename T2>
+    std::size_t pushArray(QuantitySpan<U, const T2> values) noexcept{
+        std::size_t n = values.size();
+        std::uint64_t position = claim(n);
+        if (n == 0)
+            return 0;
+        forParts(position, n, [&](std::size_t slot, std::size_t from, std::size_t count){
+            QuantitySpan<Unit, T>(slots + slot, count).assign(QuantitySpan<U, const T2>(values.data() + from, count));
+        });
+        commit(position, n);
+        return n;
+    }
+
+public:
+    /**
+     * @brief Creates a ring named `name` with space for at least `capacity`
+     * values.
+     *
+     * Capacity is rounded up to a power of two. If shared memory of that
+     * name exists, or cannot be created, `std::system_error` is thrown; stale
+     * rings are removed with `remove()`.
+     */
+    QuantityRing(const std::string& name, std::size_t capacity){
+        std::uint64_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), name);
+        if (ftruncate(fd, segmentSize(size)) != 0){
+            int error = errno;
+            ::close(fd);
+            shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), name);
+        }
+        try {
+            map(fd, segmentSize(size), name);
+        } catch (...){
+            shm_unlink(name.c_str());
+            throw;
+        }
+        setCapacity(size);
+        new (header) Helper::RingHeader;
+        header->version = Helper::RingHeader::currentVersion;
+        header->valueType = Helper::valueTypeCode<T>();
+        header->multiProducer = multiProducer;
+        header->capacity = size;
+        header->unit = UnitSignature::of<Unit>();
+        header->magic.store(Helper::RingHeader::ringMagic, std::memory_order_release);
+    }
+
+    /**
+     * @brief Attaches to an existing ring named `name`.
+     *
+     * If ring does not exist, `std::system_error` is thrown; if it is not a
+     * valid quantity ring, or is not fully created yet, `std::runtime_error`
+     * is thrown.
+     */
+    explicit QuantityRing(const std::string& name){
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), name);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || std::size_t(st.st_size) < valuesOffset){
+            ::close(fd);
+            throw std::runtime_error("Invalid quantity ring.");
+        }
+        map(fd, st.st_size, name);
+        if (header->magic.load(std::memory_order_acquire) != Helper::RingHeader::ringMagic
+                || header->version != Helper::RingHeader::currentVersion
+                || header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0
+                || header->capacity > mapSize){
+            release();
+            throw std::runtime_error("Invalid quantity ring.");
+        }
+        constexpr UnitSignature unit = UnitSignature::of<Unit>();
+        if (header->unit.dynamicDimension() != unit.dynamicDimension()){
+            release();
+            throw DimensionError("Quantity ring has different dimension.");
+        }
+        const char* error = nullptr;
+        if (header->unit != unit)
+            error = "Quantity ring stores quantities in different unit.";
+        else if (header->valueType != Helper::valueTypeCode<T>())
+            error = "Quantity ring has different value type.";
+        else if (header->multiProducer != multiProducer)
+            error = "Quantity ring has different producer mode.";
+        if (error){
+            release();
+            throw std::invalid_argument(error);
+        }
+        if (segmentSize(header->capacity) > mapSize){
+            release();
+            throw std::runtime_error("Invalid quantity ring.");
+        }
+        setCapacity(header->capacity);
+    }
+
+    QuantityRing(QuantityRing&& other) noexcept
+        :header(other.header), slots(other.slots), published(other.published), mapSize(other.mapSize), mask(other.mask)
+    {
+        other.header = nullptr;
+    }
+
+    QuantityRing(const QuantityRing&) = delete;
+    QuantityRing& operator=(const QuantityRing&) = delete;
+
+    /**
+     * @brief Detaches from the ring; shared memory remains until removed.
+     */
+    ~QuantityRing(){
+        release();
+    }
+
+    /**
+     * @brief Removes name of ring `name`; memory is freed when all processes
+     * detach.
+     *
+     * @return false if there was no such ring.
+     */
+    static bool remove(const std::string& name) noexcept{
+        return shm_unlink(name.c_str()) == 0;
+    }
+
+    /**
+     * @brief Maximal number of stored values.
+     */
+    inline std::size_t capacity() const noexcept{
+        return mask + 1;
+    }
+
+    /**
+     * @brief Number of stored values; exact only if no other side is active.
+     */
+    inline std::size_t size() const noexcept{
+        const std::atomic<std::uint64_t>& pushed = multiProducer ? header->claimed : header->committed;
+        return pushed.load(std::memory_order_acquire) - header->consumed.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @name Producer operations.
+     *
+     * May be called by any number of threads or processes if
+     * `multiProducer` is set, otherwise by one at a time.
+     */
+    //@{
+    /**
+     * @brief Pushes a quantity, converted to `Unit`.
+     * @return false if ring is full.
+     */
+    template <typename U, typename T2>
+    inline bool tryPush(const Quantity<U, T2>& q) noexcept{
+        std::size_t n = 1;
+        std::uint64_t position = claim(n);
+        if (n == 0)
+            return false;
+        slots[position & mask] = Quantity<Unit, T>(q).value();
+        commit(position, 1);
+        return true;
+    }
+
+    /**
+     * @brief Pushes as many quantities of an array as fit, converted to
+     * `Unit`.
+     * @return number of pushed quantities.
+     */
+    template <typename U, typename T2>
+    inline std::size_t push(QuantitySpan<U, T2> values) noexcept{
+        return pushArray(QuantitySpan<U, const T2>(values));
+    }
+
+    template <typename U, typename T2>
+    inline std::size_t push(const QuantityVector<U, T2>& values) noexcept{
+        return pushArray(QuantitySpan<U, const T2>(values));
+    }
+    //@}
+
+    /**
+     * @name Consumer operations.
+     *
+     * May be called by one thread at a time.
+     */
+    //@{
+    /**
+     * @brief Pops a quantity, if ring is not empty.
+     */
+    inline std::optional<Quantity<Unit, T>> tryPop() noexcept{
+        std::uint64_t position = header->consumed.load(std::memory_order_relaxed);
+        if (available(position, 1) == 0)
+            return std::nullopt;
+        Quantity<Unit, T> q(slots[position & mask]);
+        header->consumed.store(position + 1, std::memory_order_release);
+        return q;
+    }
+
+    /**
+     * @brief Gives up to `max` stored quantities to `f`, and pops them.
+     *
+     * `f` is called with one or two `QuantitySpan<Unit, const T>` views of
+     * stored values, in order; values are popped after it returns.
+     *
+     * @return number of popped quantities.
+     */
+    template <typename F>
+    std::size_t consume(F f, std::size_t max = std::size_t(-1)){
+        std::uint64_t position = header->consumed.load(std::memory_order_relaxed);
+        std::size_t n = available(position, max);
+        if (n == 0)
+            return 0;
+        forParts(position, n, [&](std::size_t slot, std::size_t, std::size_t count){
+            f(QuantitySpan<Unit, const T>(slots + slot, count));
+        });
+        header->consumed.store(position + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Pops up to `out.size()` quantities into `out`.
+     * @return number of popped quantities.
+     */
+    inline std::size_t pop(QuantitySpan<Unit, T> out) noexcept{
+        T* data = out.data();
+        return consume([&](QuantitySpan<Unit, const T> values){
+            std::memcpy(data, values.data(), values.size() * sizeof(T));
+            data += values.size();
+        }, out.size());
+    }
+    //@}
+};
+
+}
+
+#endif // QUANTITYRING_H
@@ -0,0 +1,459 @@
+#ifndef QUANTITYVECTOR_H
+#define QUANTITYVECTOR_H
+
+#include "quantityexpression.h"
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @file quantityvector.h
+ *
+ * Containers of many quantities of the same unit, stored as contiguous
+ * arrays of underlying values.
+ */
+
+namespace LibUnit{
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename Unit, typename T = double>
+class QuantitySpan;
+/** @endcond */
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Non-owning view of contiguous values of quantities of the same unit.
+ *
+ * @tparam Unit Unit of all viewed quantities.
+ * @tparam T Underlying type of viewed quantities; `const` type makes a
+ * read-only view.
+ *
+ * QuantitySpan is to `QuantityVector` what `std::span` is to `std::vector`:
+ * it refers to values owned by someone else, ie. a part of a vector or a
+ * column of a larger buffer. Unit is part of the type, so values are checked
+ * and scaled at compile time, exactly as `Quantity` values are.
+ *
+ * Spans are operands of elementwise operators, like vectors. Compound
+ * assignment operators and `assign()` modify viewed values.
+ */
+template <typename Unit, typename T>
+class QuantitySpan: public Helper::QuantityArray{
+private:
+    std::span<T> s;
+
+public:
+    typedef Unit UnitType;                     //!< Unit of quantities.
+    typedef std::remove_const_t<T> ValueType;  //!< Underlying type of quantities.
+
+    /**
+     * @brief Constructs an empty span.
+     */
+    QuantitySpan() = default;
+
+    /**
+     * @brief Constructs a span of `size` values starting at `data`.
+     *
+     * Values are interpreted as expressed in `Unit`.
+     */
+    inline constexpr QuantitySpan(T* data, std::size_t size) noexcept
+        :s(data, size)
+    {}
+
+    /**
+     * @brief Constructs a span of values in `std::span`.
+     */
+    inline constexpr explicit QuantitySpan(std::span<T> values) noexcept
+        :s(values)
+    {}
+
+    /**
+     * @brief Constructs a span of all values of a vector.
+     */
+    template <typename T2, typename = std::enable_if_t<std::is_convertible<T2(*)[], T(*)[]>::value>>
+    inline QuantitySpan(QuantityVector<Unit, T2>& v) noexcept
+        :s(v.data(), v.size())
+    {}
+
+    /**
+     * @brief Constructs a read-only span of all values of a vector.
+     */
+    template <typename T2, typename = std::enable_if_t<std::is_convertible<const T2(*)[], T(*)[]>::value>>
+    inline QuantitySpan(const QuantityVector<Unit, T2>& v) noexcept
+        :s(v.data(), v.size())
+    {}
+
+    /**
+     * @brief Constructs read-only span from a span of modifiable values.
+     */
+    template <typename T2, typename = std::enable_if_t<std::is_convertible<T2(*)[], T(*)[]>::value && !std::is_same<T, T2>::value>>
+    inline constexpr QuantitySpan(const QuantitySpan<Unit, T2>& other) noexcept
+        :s(other.values())
+    {}
+
+    inline constexpr std::size_t size() const noexcept{
+        return s.size();
+    }
+
+    inline constexpr bool empty() const noexcept{
+        return s.empty();
+    }
+
+    /**
+     * @brief Pointer to the first viewed value.
+     */
+    inline constexpr T* data() const noexcept{
+        return s.data();
+    }
+
+    /**
+     * @brief Viewed values, without units. Use with caution.
+     */
+    inline constexpr std::span<T> values() const noexcept{
+        return s;
+    }
+
+    /**
+     * @brief Quantity at index `i`.
+     */
+    inline constexpr Quantity<Unit, ValueType> operator[](std::size_t i) const noexcept(Helper::IsNothrow<ValueType>::value){
+        return Quantity<Unit, ValueType>(s[i]);
+    }
+
+    /**
+     * @brief Sets quantity at index `i`; value is scaled to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline constexpr void set(std::size_t i, const Quantity<U, T2>& q) const noexcept(Helper::IsNothrow<ValueType, T2>::value){
+        s[i] = Quantity<Unit, ValueType>(q).value();
+    }
+
+    /**
+     * @brief Span of `count` quantities starting at index `offset`.
+     */
+    inline constexpr QuantitySpan subspan(std::size_t offset, std::size_t count) const noexcept{
+        return QuantitySpan(s.subspan(offset, count));
+    }
+
+    /**
+     * @brief Leaf expression node of viewed values.
+     */
+    inline constexpr Helper::ArrayNode<Unit, ValueType> node() const noexcept{
+        return Helper::ArrayNode<Unit, ValueType>(s.data(), s.size());
+    }
+
+    /**
+     * @brief Evaluates a vector, span or expression of the same size and
+     * dimension into viewed values; values are scaled to `Unit`.
+     *
+     * Expression may read viewed values; it is evaluated in a single pass.
+     * If sizes are different, `std::invalid_argument` is thrown.
+     */
+    template <typename E, typename = std::enable_if_t<Helper::IsQuantityArray<E>::value>>
+    inline const QuantitySpan& assign(const E& e) const{
+        auto n = Helper::makeNode(e);
+        Helper::checkSizes(size(), n.size());
+        Helper::evaluateKernel<Unit>(data(), n, size());
+        return *this;
+    }
+
+    /**
+     * @name Compound assignment operators.
+     *
+     * Modify viewed values elementwise; `s += e` is the same as
+     * `s.assign(s + e)`. Right operand can be a vector, span or expression of
+     * the same size and dimension, or a single quantity of the same dimension.
+     * Multiplication and division accept dimensionless operands and
+     * non-quantity values.
+     */
+    //@{
+    template <typename E>
+    inline const QuantitySpan& operator+=(const E& e) const{
+        return assign(*this + e);
+    }
+
+    template <typename E>
+    inline const QuantitySpan& operator-=(const E& e) const{
+        return assign(*this - e);
+    }
+
+    template <typename E>
+    inline const QuantitySpan& operator*=(const E& e) const{
+        return assign(*this * e);
+    }
+
+    template <typename E>
+    inline const QuantitySpan& operator/=(const E& e) const{
+        return assign(*this / e);
+    }
+    //@}
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Vector of quantities of the same unit.
+ *
+ * @tparam Unit Unit of all stored quantities.
+ * @tparam T Underlying type of stored quantities.
+ *
+ * Values are stored in a single contiguous buffer of `T`, and the unit is
+ * carried by the type, so a vector of `n` quantities takes exactly as much
+ * memory as `n` values of `T`.
+ *
+ * Vectors are operands of elementwise operators (see quantityexpression.h),
+ * which build lazy expressions. Expressions are evaluated in a single
+ * vectorized pass when they are assigned to a vector. Units of results
+ * follow the same rules as operators of `Quantity`.
+ *
+ * Converting constructor and assignment scale values between units of the
+ * same dimension in a single pass. If dimensions are different, compilation
+ * error is generated.
+ *
+ * Examples
+ * ------------------------
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * QuantityVector<Metre> d = {Quantity<Metre>(100), Quantity<Metre>(200)};
+ * QuantityVector<Second> t(2, Quantity<Second>(10));
+ * QuantityVector v = d / t; // QuantityVector<Compound<Metre, Power<Second, -1>>>
+ * QuantityVector<Kilo<Metre>> km = d; // 0.1 km, 0.2 km
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename Unit, typename T>
+class QuantityVector: public Helper::QuantityArray{
+private:
+    std::vector<T> v;
+
+public:
+    typedef Unit UnitType;  //!< Unit of quantities.
+    typedef T ValueType;    //!< Underlying type of quantities.
+
+    /**
+     * @brief Constructs an empty vector.
+     */
+    QuantityVector() = default;
+
+    /**
+     * @brief Constructs a vector of `size` value-initialized quantities.
+     */
+    inline explicit QuantityVector(std::size_t size)
+        :v(size)
+    {}
+
+    /**
+     * @brief Constructs a vector of `size` copies of `q`; `q` is scaled to
+     * `Unit`.
+     */
+    template <typename U, typename T2>
+    inline QuantityVector(std::size_t size, const Quantity<U, T2>& q)
+        :v(size, Quantity<Unit, T>(q).value())
+    {}
+
+    /**
+     * @brief Constructs a vector of given quantities.
+     */
+    inline QuantityVector(std::initializer_list<Quantity<Unit, T>> list){
+        v.reserve(list.size());
+        for (const Quantity<Unit, T>& q: list)
+            v.push_back(q.value());
+    }
+
+    /**
+     * @brief Constructs a vector of values expressed in `Unit`.
+     */
+    inline explicit QuantityVector(std::vector<T> values) noexcept
+        :v(std::move(values))
+    {}
+
+    /**
+     * @brief Constructs a vector from a vector, span or expression of the same
+     * dimension.
+     *
+     * Expressions are evaluated in a single pass. Values are scaled to `Unit`,
+     * like in converting constructor of `Quantity`.
+     */
+    template <typename E, typename = std::enable_if_t<Helper::IsQuantityArray<E>::value>>
+    inline QuantityVector(const E& e){
+        auto n = Helper::makeNode(e);
+        v.resize(n.size());
+        Helper::evaluateKernel<Unit>(v.data(), n, v.size());
+    }
+
+    QuantityVector(const QuantityVector&) = default;
+    QuantityVector(QuantityVector&&) = default;
+    QuantityVector& operator=(const QuantityVector&) = default;
+    QuantityVector& operator=(QuantityVector&&) = default;
+
+    /**
+     * @brief Assigns a vector, span or expression of the same dimension;
+     * values are scaled to `Unit`.
+     *
+     * Expressions are evaluated in a single pass, so they may read this
+     * vector. If sizes are equal, values are written in place; otherwise they
+     * are written to a new buffer, which replaces the old one only after
+     * evaluation.
+     */
+    template <typename E, typename = std::enable_if_t<Helper::IsQuantityArray<E>::value>>
+    inline QuantityVector& operator=(const E& e){
+        auto n = Helper::makeNode(e);
+        if (n.size() != v.size()){
+            std::vector<T> result(n.size());
+            Helper::evaluateKernel<Unit>(result.data(), n, result.size());
+            v = std::move(result);
+        } else
+            Helper::evaluateKernel<Unit>(v.data(), n, v.size());
+        return *this;
+    }
+
+    inline std::size_t size() const noexcept{
+        return v.size();
+    }
+
+    inline bool empty() const noexcept{
+        return v.empty();
+    }
+
+    inline void resize(std::size_t size){
+        v.resize(size);
+    }
+
+    inline void reserve(std::size_t size){
+        v.reserve(size);
+    }
+
+    inline void clear() noexcept{
+        v.clear();
+    }
+
+    /**
+     * @brief Appends a quantity; value is scaled to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void push_back(const Quantity<U, T2>& q){
+        v.push_back(Quantity<Unit, T>(q).value());
+    }
+
+    inline T* data() noexcept{
+        return v.data();
+    }
+
+    inline const T* data() const noexcept{
+        return v.data();
+    }
+
+    /**
+     * @brief Stored values, without units. Use with caution.
+     */
+    inline std::span<T> values() noexcept{
+        return v;
+    }
+
+    inline std::span<const T> values() const noexcept{
+        return v;
+    }
+
+    /**
+     * @brief Quantity at index `i`.
+     */
+    inline Quantity<Unit, T> operator[](std::size_t i) const noexcept(Helper::IsNothrow<T>::value){
+        return Quantity<Unit, T>(v[i]);
+    }
+
+    /**
+     * @brief Sets quantity at index `i`; value is scaled to `Unit`.
+     */
+    template <typename U, typename T2>
+    inline void set(std::size_t i, const Quantity<U, T2>& q) noexcept(Helper::IsNothrow<T, T2>::value){
+        v[i] = Quantity<Unit, T>(q).value();
+    }
+
+    /**
+     * @brief Leaf expression node of stored values.
+     */
+    inline Helper::ArrayNode<Unit, T> node() const noexcept{
+        return Helper::ArrayNode<Unit, T>(v.data(), v.size());
+    }
+
+    /**
+     * @brief Span of all quantities.
+     */
+    inline QuantitySpan<Unit, T> span() noexcept{
+        return QuantitySpan<Unit, T>(v.data(), v.size());
+    }
+
+    inline QuantitySpan<Unit, const T> span() const noexcept{
+        return QuantitySpan<Unit, const T>(v.data(), v.size());
+    }
+
+    /**
+     * @name Compound assignment operators.
+     *
+     * Same as compound assignment operators of `QuantitySpan`.
+     */
+    //@{
+    template <typename R>
+    inline QuantityVector& operator+=(const R& r){
+        span() += r;
+        return *this;
+    }
+
+    template <typename R>
+    inline QuantityVector& operator-=(const R& r){
+        span() -= r;
+        return *this;
+    }
+
+    template <typename R>
+    inline QuantityVector& operator*=(const R& r){
+        span() *= r;
+        return *this;
+    }
+
+    template <typename R>
+    inline QuantityVector& operator/=(const R& r){
+        span() /= r;
+        return *this;
+    }
+    //@}
+};
+
+/**
+ * @brief Deduces unit and underlying type of a vector constructed from an
+ * expression.
+ */
+template <typename E, typename = std::enable_if_t<Helper::IsQuantityArray<E>::value>>
+QuantityVector(const E&) -> QuantityVector<typename E::UnitType, typename E::ValueType>;
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Span of values of a quantity array; used by functions that accept
+ * both spans and vectors.
+ */
+template <typename Unit, typename T>
+inline QuantitySpan<Unit, T> viewOf(QuantitySpan<Unit, T> s) noexcept{
+    return s;
+}
+
+template <typename Unit, typename T>
+inline QuantitySpan<Unit, T> viewOf(QuantityVector<Unit, T>& v) noexcept{
+    return v.span();
+}
+
+template <typename Unit, typename T>
+inline QuantitySpan<Unit, const T> viewOf(const QuantityVector<Unit, T>& v) noexcept{
+    return v.span();
+}
+
+}
+
+/** @endcond */
+
+}
+
+#endif // QUANTITYVECTOR_H
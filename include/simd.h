@@ -0,0 +1,130 @@
+#ifndef UNIT_SIMD_H
+#define UNIT_SIMD_H
+
+#include "quantityvector.h"
+#include <cstddef>
+#include <type_traits>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#endif
+
+/**
+ * @file simd.h
+ *
+ * Support of `std::experimental::simd` as underlying type of quantities.
+ *
+ * `Quantity<Unit, simd<T>>` holds several values of the same unit, which are
+ * processed at once by vector instructions:
+ *  - conversions multiply all values by a factor broadcast to the element
+ *    type (see `VectorTraits`);
+ *  - comparisons return `simd_mask`;
+ *  - functions of cmath.h dispatch to vector math of `std::experimental`.
+ *
+ * Values are loaded from and stored to `QuantitySpan` or `QuantityVector`
+ * using `load()` and `store()`, so hand-written vector kernels keep unit
+ * safety. If the standard library has no `<experimental/simd>`, this header
+ * declares nothing.
+ *
+ * Examples
+ * ------------------------
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * typedef std::experimental::native_simd<double> V;
+ * for (std::size_t i=0; i + V::size() <= n; i += V::size()){
+ *     Quantity<Metre, V> d = load<V>(distance, i);
+ *     Quantity<Second, V> t = load<V>(time, i);
+ *     store(d / t, speed, i); // Converted to unit of speed.
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+
+#if __has_include(<experimental/simd>)
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Vector type loaded by `load()`: `V`, or native vector of `T` if `V`
+ * is `void`.
+ */
+template <typename V, typename T>
+using LoadedVector = std::conditional_t<std::is_void<V>::value, std::experimental::native_simd<std::remove_const_t<T>>, V>;
+
+}
+
+/** @endcond */
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T, typename Abi>
+class VectorTraits<std::experimental::simd<T, Abi>>{
+public:
+    static constexpr bool isVector = true;
+    typedef T Element;
+};
+/** @endcond */
+
+/**
+ * @brief Loads values of quantities into a vector.
+ *
+ * @tparam V Vector type of loaded values, native vector of `T` by default.
+ * @param s Span of loaded quantities.
+ * @param index Index of the first loaded value.
+ * @param flags Alignment of loaded values, `element_aligned` by default.
+ * @return quantity of `V::size()` values starting at `index`.
+ *
+ * Span must hold at least `index + V::size()` values; it is not checked.
+ */
+template <typename V = void, typename Unit, typename T, typename Flags = std::experimental::element_aligned_tag>
+inline Quantity<Unit, Helper::LoadedVector<V, T>> load(QuantitySpan<Unit, T> s, std::size_t index, Flags flags = {}) noexcept{
+    typedef Helper::LoadedVector<V, T> Vector;
+    return Quantity<Unit, Vector>(Vector(s.data() + index, flags));
+}
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename V = void, typename Unit, typename T, typename Flags = std::experimental::element_aligned_tag>
+inline Quantity<Unit, Helper::LoadedVector<V, T>> load(const QuantityVector<Unit, T>& v, std::size_t index, Flags flags = {}) noexcept{
+    return load<V>(v.span(), index, flags);
+}
+/** @endcond */
+
+/**
+ * @brief Stores values of a vector quantity.
+ *
+ * @param q Stored quantity.
+ * @param s Span in which values are stored.
+ * @param index Index at which the first value is stored.
+ * @param flags Alignment of stored values, `element_aligned` by default.
+ *
+ * Values are converted to unit of the span before they are stored. If
+ * dimensions of units are different, compilation error is generated. Span
+ * must hold at least `index + V::size()` values; it is not checked.
+ */
+template <typename U, typename V, typename Unit, typename T, typename Flags = std::experimental::element_aligned_tag>
+inline void store(const Quantity<U, V>& q, QuantitySpan<Unit, T> s, std::size_t index, Flags flags = {}) noexcept{
+    static_assert(VectorTraits<V>::isVector, "Stored quantity is not a vector quantity.");
+    V(Convert<U, Unit>::value(q.value())).copy_to(s.data() + index, flags);
+}
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename U, typename V, typename Unit, typename T, typename Flags = std::experimental::element_aligned_tag>
+inline void store(const Quantity<U, V>& q, QuantityVector<Unit, T>& v, std::size_t index, Flags flags = {}) noexcept{
+    store(q, v.span(), index, flags);
+}
+/** @endcond */
+
+/**
+ * @brief Sum of all values of a vector quantity.
+ */
+template <typename Unit, typename T, typename Abi>
+inline Quantity<Unit, T> reduce(const Quantity<Unit, std::experimental::simd<T, Abi>>& q) noexcept{
+    return Quantity<Unit, T>(std::experimental::reduce(q.value()));
+}
+
+}
+
+#endif
+
+#endif // UNIT_SIMD_H
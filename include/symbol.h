@@ -0,0 +1,509 @@
+#ifndef SYMBOL_H
+#define SYMBOL_H
+
+#include "quantity.h"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <version>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+/**
+ * @file symbol.h
+ */
+
+namespace LibUnit{
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class SymbolOf;
+/** @endcond */
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Helper class used to assemble unit symbols at compile time.
+ */
+class SymbolBuffer{
+public:
+    static constexpr int capacity = 256;
+
+    char data[capacity] = {};
+    int size = 0;
+
+    constexpr void append(std::string_view s){
+        for (char c: s){
+            if (size == capacity)
+                throw "Unit symbol is too long.";
+            data[size++] = c;
+        }
+    }
+
+    constexpr void appendNumber(std::intmax_t n){
+        char digits[24] = {};
+        int count = 0;
+        std::uintmax_t u = n < 0 ? -static_cast<std::uintmax_t>(n) : n;
+        do {
+            digits[count++] = '0' + u % 10;
+            u /= 10;
+        } while (u);
+        if (n < 0)
+            append("-");
+        while (count)
+            append(std::string_view(&digits[--count], 1));
+    }
+
+    // Appends exponent using superscript digits; exponent 1 is omitted.
+    constexpr void appendExponent(int e){
+        constexpr std::string_view superscripts[] = {"⁰", "¹", "²", "³", "⁴", "⁵", "⁶", "⁷", "⁸", "⁹"};
+        if (e == 1)
+            return;
+        if (e < 0)
+            append("⁻");
+        unsigned int u = e < 0 ? -e : e;
+        unsigned int scale = 1;
+        while (scale * 10 <= u)
+            scale *= 10;
+        for (; scale; scale /= 10)
+            append(superscripts[u / scale % 10]);
+    }
+};
+
+/**
+ * @brief Checks if simple unit defines `symbol` member.
+ */
+template <typename T, typename = void>
+class HasSymbol: public std::false_type{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class HasSymbol<T, std::void_t<decltype(T::symbol)>>: public std::true_type{};
+/** @endcond */
+
+/**
+ * @brief Checks if simple unit is a dimensionless factor of ten without a
+ * symbol (ie. `IntFactor<10>`); such units are written as SI prefixes.
+ */
+template <typename T, bool = HasSymbol<T>::value>
+class IsDecade: public std::integral_constant<bool, IsEqualDimension<T, Compound<>>::value && FactorOf<T>::value == ExactFactor(10)>{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class IsDecade<T, true>: public std::false_type{};
+/** @endcond */
+
+/**
+ * @brief Splits member of simplified Compound into simple unit and its power.
+ */
+template <typename T>
+class SymbolMember{
+public:
+    typedef T Base;
+    static constexpr int power = 1;
+};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T, int pow>
+class SymbolMember<Power<T, pow>>{
+public:
+    typedef T Base;
+    static constexpr int power = pow;
+};
+/** @endcond */
+
+/**
+ * @brief Symbol of SI prefix of given power of ten, or empty string.
+ */
+constexpr std::string_view prefixSymbol(int exponent){
+    switch (exponent){
+    case 24: return "Y";
+    case 21: return "Z";
+    case 18: return "E";
+    case 15: return "P";
+    case 12: return "T";
+    case 9: return "G";
+    case 6: return "M";
+    case 3: return "k";
+    case 2: return "h";
+    case 1: return "da";
+    case -1: return "d";
+    case -2: return "c";
+    case -3: return "m";
+    case -6: return "µ";
+    case -9: return "n";
+    case -12: return "p";
+    case -15: return "f";
+    case -18: return "a";
+    case -21: return "z";
+    case -24: return "y";
+    default: return "";
+    }
+}
+
+/**
+ * @brief Base class of `SymbolOf` for units whose symbol is generated.
+ */
+class GeneratedSymbol{};
+
+/**
+ * @brief Checks if `SymbolOf` is specialized for unit `T`.
+ */
+template <typename T>
+class HasSymbolOf: public std::integral_constant<bool, !std::is_base_of<GeneratedSymbol, SymbolOf<T>>::value>{};
+
+/**
+ * @brief Value of `prefixable` member of `T`, or false if there is none.
+ */
+template <typename T, typename = void>
+class PrefixableMember: public std::false_type{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class PrefixableMember<T, std::void_t<decltype(T::prefixable)>>: public std::integral_constant<bool, T::prefixable>{};
+/** @endcond */
+
+/**
+ * @brief Symbol a unit has of its own: specialization of `SymbolOf`, or
+ * `symbol` member of a simple unit.
+ *
+ * `value` is true if unit has such symbol, and `prefixable` if the symbol
+ * accepts SI prefixes, as given by `prefixable` member of `SymbolOf` or the
+ * unit.
+ */
+template <typename T>
+class OwnSymbol{
+public:
+    static constexpr bool value = HasSymbolOf<T>::value || HasSymbol<T>::value;
+    static constexpr bool prefixable = HasSymbolOf<T>::value ? PrefixableMember<SymbolOf<T>>::value : PrefixableMember<T>::value;
+
+    static constexpr void write(SymbolBuffer& b){
+        if constexpr (HasSymbolOf<T>::value)
+            b.append(SymbolOf<T>::value);
+        else
+            b.append(T::symbol);
+    }
+};
+
+/**
+ * @brief Symbol a unit has of its own, looked through Compound of a single
+ * member and power of one.
+ */
+template <typename T>
+class NamedSymbol: public OwnSymbol<T>{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename T>
+class NamedSymbol<Compound<T>>: public std::conditional<HasSymbolOf<Compound<T>>::value, OwnSymbol<Compound<T>>, NamedSymbol<T>>::type{};
+
+template <typename T>
+class NamedSymbol<Power<T, 1>>: public std::conditional<HasSymbolOf<Power<T, 1>>::value, OwnSymbol<Power<T, 1>>, NamedSymbol<T>>::type{};
+/** @endcond */
+
+/**
+ * @brief Symbol of a unit that has a symbol of its own, optionally with an
+ * SI prefix (ie. `Kilo<Pascal>` is written as `kPa`).
+ */
+template <typename T>
+class PrefixedSymbol: public NamedSymbol<T>{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename First, typename ...Rest>
+class PrefixedSymbol<Compound<First, Rest...>>{
+private:
+    typedef NamedSymbol<Compound<First, Rest...>> Named;
+    typedef NamedSymbol<Compound<Rest...>> Base;
+    typedef SymbolMember<First> Prefix;
+
+public:
+    static constexpr bool value = Named::value || (IsDecade<typename Prefix::Base>::value && !prefixSymbol(Prefix::power).empty()
+                                                   && Base::value && Base::prefixable);
+
+    static constexpr void write(SymbolBuffer& b){
+        if constexpr (Named::value)
+            Named::write(b);
+        else {
+            b.append(prefixSymbol(Prefix::power));
+            Base::write(b);
+        }
+    }
+};
+/** @endcond */
+
+/**
+ * @brief Helper class used to write symbol of a unit from symbols of its
+ * members, before it is simplified.
+ *
+ * `value` is true if unit can be written this way: it has a symbol of its
+ * own, possibly prefixed, or it is a Compound whose every member is such unit
+ * raised to a power. A power of ten directly followed by a member of power one
+ * is written as its prefix. Other units are written in their simplified form
+ * by `SymbolWriter`.
+ */
+template <typename T>
+class MemberSymbolWriter: public PrefixedSymbol<T>{};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename ...Args>
+class MemberSymbolWriter<Compound<Args...>>{
+private:
+    static constexpr std::size_t count = sizeof...(Args);
+    static constexpr bool decade[] = {IsDecade<typename SymbolMember<Args>::Base>::value..., false};
+    static constexpr int power[] = {SymbolMember<Args>::power..., 0};
+    static constexpr bool named[] = {NamedSymbol<typename SymbolMember<Args>::Base>::value..., false};
+    static constexpr bool prefixable[] = {NamedSymbol<typename SymbolMember<Args>::Base>::prefixable..., false};
+    static constexpr bool prefixed[] = {PrefixedSymbol<typename SymbolMember<Args>::Base>::value..., false};
+
+    static constexpr bool membersWritable(){
+        for (std::size_t i=0; i<count; i++){
+            if (!decade[i])
+                continue;
+            if (i + 1 == count || decade[i + 1] || !named[i + 1] || !prefixable[i + 1] || power[i + 1] != 1
+                    || prefixSymbol(power[i]).empty() || (i > 0 && decade[i - 1]))
+                return false;
+        }
+        for (std::size_t i=0; i<count; i++)
+            if (!decade[i] && !prefixed[i])
+                return false;
+        return count > 0;
+    }
+
+public:
+    static constexpr bool value = PrefixedSymbol<Compound<Args...>>::value || membersWritable();
+
+    static constexpr void write(SymbolBuffer& b){
+        if constexpr (PrefixedSymbol<Compound<Args...>>::value)
+            PrefixedSymbol<Compound<Args...>>::write(b);
+        else {
+            bool first = true;
+            bool afterPrefix = false;
+            ([&](){
+                typedef SymbolMember<Args> M;
+                if (!first && !afterPrefix)
+                    b.append("·");
+                first = false;
+                afterPrefix = IsDecade<typename M::Base>::value;
+                if constexpr (IsDecade<typename M::Base>::value)
+                    b.append(prefixSymbol(M::power));
+                else {
+                    PrefixedSymbol<typename M::Base>::write(b);
+                    b.appendExponent(M::power);
+                }
+            }(), ...);
+        }
+    }
+};
+
+template <typename T, int pow>
+class MemberSymbolWriter<Power<T, pow>>: public MemberSymbolWriter<Compound<Power<T, pow>>>{};
+/** @endcond */
+
+/**
+ * @brief Appends symbol of a simple unit.
+ *
+ * Units without `symbol` member are written as their factor, if it is an
+ * integer and unit is dimensionless. Otherwise compilation error is generated.
+ */
+template <typename T>
+constexpr void appendSimpleSymbol(SymbolBuffer& b){
+    if constexpr (HasSymbol<T>::value)
+        b.append(T::symbol);
+    else {
+        static_assert(IsEqualDimension<T, Compound<>>::value && FactorOf<T>::value.isInteger(),
+                      "Unit has no symbol.");
+        b.appendNumber(FactorOf<T>::value.integer());
+    }
+}
+
+/**
+ * @brief Helper class used to write symbol of a simplified unit.
+ */
+template <typename T>
+class SymbolWriter{
+public:
+    static constexpr void write(SymbolBuffer& b){
+        SymbolWriter<Compound<T>>::write(b);
+    }
+};
+
+/** @cond DOXYGEN_EXCLUDE */
+template <typename ...Args>
+class SymbolWriter<Compound<Args...>>{
+public:
+    static constexpr void write(SymbolBuffer& b){
+        constexpr int decades = (0 + ... + (IsDecade<typename SymbolMember<Args>::Base>::value ? SymbolMember<Args>::power : 0));
+        constexpr std::string_view prefix = prefixSymbol(decades);
+        constexpr bool prefixed = !prefix.empty()
+                && (false || ... || (!IsDecade<typename SymbolMember<Args>::Base>::value && SymbolMember<Args>::power == 1));
+
+        [[maybe_unused]] bool first = true;
+        [[maybe_unused]] bool pending = prefixed;
+        if (decades != 0 && !prefixed){
+            b.append("10");
+            b.appendExponent(decades);
+            first = false;
+        }
+        ([&](){
+            typedef SymbolMember<Args> M;
+            if constexpr (!IsDecade<typename M::Base>::value){
+                if (!first)
+                    b.append("·");
+                first = false;
+                if (pending && M::power == 1){
+                    b.append(prefix);
+                    pending = false;
+                }
+                appendSimpleSymbol<typename M::Base>(b);
+                b.appendExponent(M::power);
+            }
+        }(), ...);
+    }
+};
+/** @endcond */
+
+/**
+ * @brief Storage of generated symbol of unit `T`.
+ */
+template <typename T>
+class SymbolStorage{
+private:
+    static constexpr SymbolBuffer buffer = [](){
+        SymbolBuffer b;
+        if constexpr (MemberSymbolWriter<T>::value)
+            MemberSymbolWriter<T>::write(b);
+        else
+            SymbolWriter<LibUnit::Simplify<T>>::write(b);
+        return b;
+    }();
+
+    static constexpr std::array<char, buffer.size + 1> storage = [](){
+        std::array<char, buffer.size + 1> s{};
+        for (int i=0; i<buffer.size; i++)
+            s[i] = buffer.data[i];
+        return s;
+    }();
+
+public:
+    static constexpr std::string_view value = std::string_view(storage.data(), buffer.size);
+};
+
+}
+
+/** @endcond */
+
+/**
+ * @brief Template used to compute symbol of a unit.
+ *
+ * @tparam T Unit for which symbol is computed.
+ *
+ * `static constexpr` member `value` is a `std::string_view` of UTF-8 encoded
+ * symbol of `T`, assembled at compile time. Units that have a symbol of their
+ * own (a specialization of this class or a `symbol` member) are written using
+ * it, prefixed units as SI prefix followed by that symbol, and Compound units
+ * as symbols of their members, so that named units like `Hour` or `Litre`
+ * are kept. Members are separated by `·` and powers are written using
+ * superscript digits.
+ *
+ * Units that cannot be written this way are written in their simplified form
+ * (`Simplify<T>`): simple units using their `symbol` members and powers of
+ * ten as SI prefixes of the first unit of power one.
+ *
+ * Examples
+ * ------------------------
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * SymbolOf<Kilo<Gram>>::value; // "kg"
+ * SymbolOf<Kilo<Pascal>>::value; // "kPa"
+ * SymbolOf<Compound<Kilo<Metre>, Power<Hour, -1>>>::value; // "km·h⁻¹"
+ * SymbolOf<Compound<Second, Power<Kilo<Metre>, -1>>>::value; // "s·km⁻¹"
+ * ~~~~~~~~~~~~~~~~~~~~
+ *
+ * @remark
+ * Specialize this class to give a unit a symbol that cannot be derived from
+ * its members (ie. `Hour` is written as `h`, not as `60²·s`). Specialization
+ * may define `static constexpr bool prefixable = true` if the symbol accepts
+ * SI prefixes; so may simple units with `symbol` member.
+ */
+template <typename T>
+class SymbolOf: public Helper::GeneratedSymbol{
+public:
+    static constexpr std::string_view value = Helper::SymbolStorage<T>::value;
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes quantity as its value followed by a space and unit symbol.
+ *
+ * @param first Beginning of output buffer.
+ * @param last End of output buffer.
+ * @param q Written quantity.
+ * @param args Optional format and precision, passed to `std::to_chars`.
+ * @return Pointer past the last written character and error code, like
+ * `std::to_chars`.
+ *
+ * Value is written using `std::to_chars`, so output does not depend on locale
+ * and nothing is allocated. Dimensionless quantities are written without
+ * symbol. If buffer is too small, `ec` is `std::errc::value_too_large` and
+ * `ptr` equals `last`.
+ */
+template <typename Unit, typename T, typename ...Args>
+inline std::to_chars_result toChars(char* first, char* last, const Quantity<Unit, T>& q, Args... args) noexcept{
+    std::to_chars_result result = std::to_chars(first, last, q.value(), args...);
+    constexpr std::string_view symbol = SymbolOf<Unit>::value;
+    if constexpr (!symbol.empty()){
+        if (result.ec != std::errc())
+            return result;
+        if (last - result.ptr < static_cast<std::ptrdiff_t>(symbol.size() + 1))
+            return {last, std::errc::value_too_large};
+        *result.ptr++ = ' ';
+        result.ptr = std::char_traits<char>::copy(result.ptr, symbol.data(), symbol.size()) + symbol.size();
+    }
+    return result;
+}
+
+/**
+ * @brief Quantity written as its value followed by a space and unit symbol.
+ */
+template <typename Unit, typename T>
+inline std::string toString(const Quantity<Unit, T>& q){
+    char buffer[64 + SymbolOf<Unit>::value.size()];
+    std::to_chars_result result = toChars(buffer, buffer + sizeof(buffer), q);
+    return std::string(buffer, result.ptr);
+}
+
+}
+
+#ifdef __cpp_lib_format
+
+/**
+ * @brief Formatter of quantities for `std::format`.
+ *
+ * Value is formatted using format specification of underlying type, and is
+ * followed by a space and unit symbol, ie. `std::format("{:.1f}", q)` gives
+ * `9.8 m·s⁻²`.
+ */
+template <typename Unit, typename T>
+struct std::formatter<LibUnit::Quantity<Unit, T>, char>: std::formatter<T, char>{
+    template <typename FormatContext>
+    auto format(const LibUnit::Quantity<Unit, T>& q, FormatContext& ctx) const{
+        auto out = std::formatter<T, char>::format(q.value(), ctx);
+        constexpr std::string_view symbol = LibUnit::SymbolOf<Unit>::value;
+        if constexpr (!symbol.empty()){
+            *out++ = ' ';
+            for (char c: symbol)
+                *out++ = c;
+        }
+        return out;
+    }
+};
+
+#endif
+
+#endif // SYMBOL_H
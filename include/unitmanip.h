@@ -1,7 +1,13 @@
 #ifndef UNITS_H
 #define UNITS_H
 
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
 #include <type_traits>
+#include <utility>
 
 /**
  * @file unitmanip.h
@@ -31,6 +37,395 @@ class IsEqual;
 
 //------------------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Class representing a dimension as a vector of exponents of base
+ * dimensions.
+ *
+ * Each base dimension that has a `BaseDimensionIndex` specialization occupies
+ * one slot of the vector. A dimension is represented by exponents to which
+ * every base dimension is raised. Comparing such dimensions is a single
+ * constexpr comparison, and multiplying or dividing them is elementwise
+ * addition or subtraction of exponents.
+ *
+ * DimensionVector is a structural type, so it can be used as a non-type
+ * template parameter (see `VectorDimension`).
+ */
+class DimensionVector{
+public:
+    static constexpr int size = 8;
+    //!< Maximum number of base dimensions that can be indexed.
+
+    int exponents[size] = {};
+    //!< Exponents of base dimensions, indexed by `BaseDimensionIndex`.
+
+    /**
+     * @brief Vector of a single base dimension raised to the power of one.
+     */
+    static constexpr DimensionVector base(int index){
+        DimensionVector result;
+        result.exponents[index] = 1;
+        return result;
+    }
+
+    /**
+     * @brief Checks if all exponents are equal to zero.
+     */
+    constexpr bool isDimensionless() const{
+        return *this == DimensionVector();
+    }
+
+    constexpr bool operator==(const DimensionVector&) const = default;
+
+    constexpr DimensionVector operator+(const DimensionVector& v) const{
+        DimensionVector result;
+        for (int i=0; i<size; i++)
+            result.exponents[i] = exponents[i] + v.exponents[i];
+        return result;
+    }
+
+    constexpr DimensionVector operator-(const DimensionVector& v) const{
+        DimensionVector result;
+        for (int i=0; i<size; i++)
+            result.exponents[i] = exponents[i] - v.exponents[i];
+        return result;
+    }
+
+    constexpr DimensionVector operator*(int pow) const{
+        DimensionVector result;
+        for (int i=0; i<size; i++)
+            result.exponents[i] = exponents[i] * pow;
+        return result;
+    }
+};
+
+/**
+ * @brief Class used to assign slots of `DimensionVector` to base dimensions.
+ *
+ * @tparam T Base dimension.
+ *
+ * `value` equal to `-1` means that base dimension has no slot assigned, and
+ * dimensions containing it are compared using Compound type algebra. Specialize
+ * this class for your own base dimensions in order to use unused slots.
+ */
+template <typename T>
+class BaseDimensionIndex{
+public:
+    static constexpr int value = -1;
+};
+
+/**
+ * @brief Dimension described directly by a vector of base dimension exponents.
+ *
+ * @tparam v Exponents of base dimensions.
+ *
+ * Can be used as a `Dimension` of a unit, in place of a Compound of base
+ * dimensions.
+ */
+template <DimensionVector v>
+class VectorDimension{
+public:
+    static constexpr DimensionVector vector = v;
+    //!< Exponents of base dimensions.
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Class representing exact value of a unit factor.
+ *
+ * Factor is stored as a reduced rational number multiplied by an integral
+ * power of ten and an integral power of π. Products, quotients and integral
+ * powers of such factors are computed exactly at compile time, so factors
+ * of units like `Kilo<Mili<Metre>>` fold to exactly one, and prefixes like
+ * `Yocto` do not accumulate rounding errors.
+ *
+ * Factors that cannot be represented exactly (ie. user units defining
+ * `factor` as an arbitrary floating point value) are kept in the `inexact`
+ * member, which equals `1` for exact factors. If a product of exact factors
+ * does not fit the rational part, its rational part is moved to `inexact` as
+ * well.
+ *
+ * Exact factors are rounded to a numeric type only once, by `as()`, when
+ * conversion ratio between two units is computed.
+ */
+class ExactFactor{
+public:
+    std::intmax_t numerator = 1;    //!< Numerator of rational part.
+    std::intmax_t denominator = 1;  //!< Denominator of rational part; always positive.
+    int exponent = 0;               //!< Power of ten.
+    int piExponent = 0;             //!< Power of π.
+    double inexact = 1;             //!< Part of the factor that has no exact representation.
+
+    /**
+     * @brief Constructs factor equal to one.
+     */
+    constexpr ExactFactor() = default;
+
+    /**
+     * @brief Constructs factor equal to `num/den * 10^exp10 * π^piExp`.
+     */
+    constexpr ExactFactor(std::intmax_t num, std::intmax_t den = 1, int exp10 = 0, int piExp = 0)
+        :numerator(num), denominator(den), exponent(exp10), piExponent(piExp)
+    {
+        normalize();
+    }
+
+    /**
+     * @brief Deleted, so that floating point values are not truncated to
+     * integers; use `approximate()` or `decimal()` for them.
+     */
+    template <typename F, typename = std::enable_if_t<std::is_floating_point<F>::value>>
+    ExactFactor(F value, std::intmax_t den = 1, int exp10 = 0, int piExp = 0) = delete;
+
+    /**
+     * @brief Constructs factor equal to `mantissa * 10^exp10`.
+     *
+     * Used to write down decimal factors exactly, ie. `decimal(254, -4)`
+     * equals 0.0254.
+     */
+    static constexpr ExactFactor decimal(std::intmax_t mantissa, int exp10){
+        return ExactFactor(mantissa, 1, exp10);
+    }
+
+    /**
+     * @brief Constructs factor from a floating point value.
+     *
+     * Integral values are represented exactly, others are stored as `inexact`.
+     */
+    static constexpr ExactFactor approximate(double value){
+        if (value > -9007199254740992.0 && value < 9007199254740992.0 && value == static_cast<double>(static_cast<std::intmax_t>(value)))
+            return ExactFactor(static_cast<std::intmax_t>(value));
+        ExactFactor result;
+        result.inexact = value;
+        return result;
+    }
+
+    /**
+     * @brief Checks if factor has no inexact part.
+     */
+    constexpr bool isExact() const{
+        return inexact == 1;
+    }
+
+    /**
+     * @brief Checks if factor equals exactly one.
+     */
+    constexpr bool isOne() const{
+        return *this == ExactFactor();
+    }
+
+    /**
+     * @brief Checks if factor is an integer that fits in `std::intmax_t`.
+     */
+    constexpr bool isInteger() const{
+        if (!isExact() || piExponent != 0 || denominator != 1 || exponent < 0)
+            return false;
+        std::intmax_t result = numerator;
+        for (int i=0; i<exponent; i++)
+            if (!multiply(result, 10))
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief Integral value of a factor, valid only if `isInteger()`.
+     */
+    constexpr std::intmax_t integer() const{
+        std::intmax_t result = numerator;
+        for (int i=0; i<exponent; i++)
+            result *= 10;
+        return result;
+    }
+
+    /**
+     * @brief Checks if factor is a fraction with numerator and denominator
+     * that fit in `std::intmax_t`.
+     */
+    constexpr bool isRational() const{
+        if (!isExact() || piExponent != 0)
+            return false;
+        std::intmax_t num = numerator;
+        std::intmax_t den = denominator;
+        for (int i=0; i<exponent; i++)
+            if (!multiply(num, 10))
+                return false;
+        for (int i=0; i>exponent; i--)
+            if (!multiply(den, 10))
+                return false;
+        return true;
+    }
+
+    /**
+     * @brief Numerator of a factor written as a fraction, valid only if
+     * `isRational()`.
+     */
+    constexpr std::intmax_t rationalNumerator() const{
+        std::intmax_t result = numerator;
+        for (int i=0; i<exponent; i++)
+            result *= 10;
+        return result;
+    }
+
+    /**
+     * @brief Denominator of a factor written as a fraction, valid only if
+     * `isRational()`. Always positive.
+     */
+    constexpr std::intmax_t rationalDenominator() const{
+        std::intmax_t result = denominator;
+        for (int i=0; i>exponent; i--)
+            result *= 10;
+        return result;
+    }
+
+    /**
+     * @brief Value of the factor rounded to type `T`.
+     *
+     * Computation is performed in `long double`, and then rounded to `T`.
+     */
+    template <typename T>
+    constexpr T as() const{
+        long double scale = 1;
+        for (int i=0; i < (exponent < 0 ? -exponent : exponent); i++)
+            scale *= 10;
+        long double result = exponent < 0 ? numerator / (denominator * scale)
+                                          : numerator * scale / denominator;
+        constexpr long double pi = 3.141592653589793238462643383279502884L;
+        for (int i=0; i<piExponent; i++)
+            result *= pi;
+        for (int i=0; i>piExponent; i--)
+            result /= pi;
+        return static_cast<T>(result * inexact);
+    }
+
+    /**
+     * @brief Factor raised to an integral power.
+     */
+    constexpr ExactFactor pow(int power) const{
+        ExactFactor base = power < 0 ? inverse() : *this;
+        ExactFactor result;
+        for (unsigned int p = power < 0 ? -power : power; p; p /= 2){
+            if (p % 2)
+                result = result * base;
+            base = base * base;
+        }
+        return result;
+    }
+
+    /**
+     * @brief Factor raised to power of -1.
+     */
+    constexpr ExactFactor inverse() const{
+        ExactFactor result;
+        result.numerator = denominator;
+        result.denominator = numerator;
+        result.exponent = -exponent;
+        result.piExponent = -piExponent;
+        result.inexact = 1 / inexact;
+        result.normalize();
+        return result;
+    }
+
+    constexpr bool operator==(const ExactFactor&) const = default;
+
+    friend constexpr ExactFactor operator*(const ExactFactor& a, const ExactFactor& b){
+        ExactFactor result;
+        std::intmax_t g1 = std::gcd(a.numerator, b.denominator);
+        std::intmax_t g2 = std::gcd(b.numerator, a.denominator);
+        std::intmax_t num = a.numerator / g1;
+        std::intmax_t den = a.denominator / g2;
+        if (multiply(num, b.numerator / g2) && multiply(den, b.denominator / g1)){
+            result.numerator = num;
+            result.denominator = den;
+            result.inexact = a.inexact * b.inexact;
+        } else {
+            result.inexact = a.inexact * b.inexact
+                           * (static_cast<double>(a.numerator) / a.denominator)
+                           * (static_cast<double>(b.numerator) / b.denominator);
+        }
+        result.exponent = a.exponent + b.exponent;
+        result.piExponent = a.piExponent + b.piExponent;
+        result.normalize();
+        return result;
+    }
+
+    friend constexpr ExactFactor operator/(const ExactFactor& a, const ExactFactor& b){
+        return a * b.inverse();
+    }
+
+private:
+    // Multiplies a by b, unless result would overflow.
+    static constexpr bool multiply(std::intmax_t& a, std::intmax_t b){
+        constexpr std::intmax_t max = std::numeric_limits<std::intmax_t>::max();
+        if (a != 0 && (b > max / (a < 0 ? -a : a) || b < -(max / (a < 0 ? -a : a))))
+            return false;
+        a *= b;
+        return true;
+    }
+
+    // Brings factor to the canonical form: reduced fraction with positive
+    // denominator that is coprime with 10, and numerator not divisible by 10.
+    // If numerator of that form does not fit, factor is written as a plain
+    // fraction if it fits, and otherwise with the lowest power of ten for
+    // which the fraction fits. Either way the form depends only on the value,
+    // so equal factors compare equal.
+    constexpr void normalize(){
+        if (denominator == 0)
+            return;
+        if (numerator == 0){
+            denominator = 1;
+            exponent = 0;
+            return;
+        }
+        if (denominator < 0){
+            numerator = -numerator;
+            denominator = -denominator;
+        }
+        std::intmax_t g = std::gcd(numerator, denominator);
+        // Value is num/den * 2^twos * 5^fives, with num and den coprime with 10.
+        std::intmax_t num = numerator / g;
+        std::intmax_t den = denominator / g;
+        int twos = exponent, fives = exponent;
+        for (; num % 2 == 0; num /= 2)
+            twos++;
+        for (; num % 5 == 0; num /= 5)
+            fives++;
+        for (; den % 2 == 0; den /= 2)
+            twos--;
+        for (; den % 5 == 0; den /= 5)
+            fives--;
+        int first = twos < fives ? twos : fives;
+        int last = twos < fives ? fives : twos;
+        int plain = first > 0 ? first : last < 0 ? last : 0;
+        if (setScaled(num, den, twos, fives, first) || setScaled(num, den, twos, fives, plain))
+            return;
+        for (int exp10=first+1; exp10<=last; exp10++)
+            if (setScaled(num, den, twos, fives, exp10))
+                return;
+    }
+
+    // Sets factor to num/den * 2^twos * 5^fives written with power of ten
+    // exp10, unless numerator or denominator would overflow.
+    constexpr bool setScaled(std::intmax_t num, std::intmax_t den, int twos, int fives, int exp10){
+        bool fits = true;
+        for (int i=exp10; i<twos && fits; i++)
+            fits = multiply(num, 2);
+        for (int i=exp10; i<fives && fits; i++)
+            fits = multiply(num, 5);
+        for (int i=twos; i<exp10 && fits; i++)
+            fits = multiply(den, 2);
+        for (int i=fives; i<exp10 && fits; i++)
+            fits = multiply(den, 5);
+        if (fits){
+            numerator = num;
+            denominator = den;
+            exponent = exp10;
+        }
+        return fits;
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
 namespace Helper{
 
 /** @cond DOXYGEN_EXCLUDE */
@@ -41,7 +436,7 @@ class TypeCount;
 template <typename T, int i>
 class TypeAt;
 
-template <typename T, int pow=1, int i=TypeCount<T>::value-1>
+template <typename T, int pow=1>
 class Raise;
 
 template <typename T>
@@ -50,12 +445,15 @@ class PowerOf;
 template <typename T>
 class BasicOf;
 
-template <typename T, typename U, int i=TypeCount<T>::value-1>
+template <typename T, typename U>
 class HasPower;
 
 template <typename T, typename U>
 class Join;
 
+template <typename ...Args>
+class JoinAll;
+
 template <typename T, int i, int j=TypeCount<T>::value-1>
 class TakeAt;
 
@@ -65,21 +463,24 @@ class ReplaceAt;
 template <typename T, int i=TypeCount<T>::value-1>
 class InvertPowers;
 
-template <typename T, int i=TypeCount<T>::value-1>
+template <typename T>
 class Flatten;
 
-template <typename T, int i=TypeCount<T>::value-1>
+template <typename T>
 class Simplify;
 
 template <typename T>
 class UnitOf;
 
-template <typename T, int i=TypeCount<T>::value-1>
+template <typename T>
 class DimensionOf;
 
-template <typename T, int i=TypeCount<T>::value-1>
+template <typename T>
 class FactorOf;
 
+template <typename T, typename = void>
+class DimensionVectorOf;
+
 /** @endcond */
 
 //------------------------------------------------------------------------------------------------------------------
@@ -106,32 +507,34 @@ public:
 
 //------------------------------------------------------------------------------------------------------------------
 
-/**
- * @brief Helper class used for extracting i-th type from Compound;
- */
-template <typename T, int i>
-class TypeAt{
+/** @cond DOXYGEN_EXCLUDE */
+
+template <std::size_t i, typename T>
+class IndexedType{
 public:
-    typedef T Type; //!< For non-Compound type, it's always template type;
+    typedef T Type;
 };
 
+template <typename Indices, typename ...Args>
+class IndexedTypes;
+
+template <std::size_t ...I, typename ...Args>
+class IndexedTypes<std::index_sequence<I...>, Args...>: public IndexedType<I, Args>...{};
+
+template <std::size_t i, typename T>
+IndexedType<i, T> selectIndexed(const IndexedType<i, T>&);
+
+/** @endcond */
+
 /**
  * @brief Helper class used for extracting i-th type from Compound;
  */
-template <typename T, typename ...Args>
-class TypeAt<Compound<T, Args...>, 0>{
+template <typename T, int i>
+class TypeAt{
 public:
-    typedef T Type;    //!< I-th type of the Compound.
+    typedef T Type; //!< For non-Compound type, it's always template type;
 };
 
-/**
- * @brief Helper class used for extracting i-th type from Compound;
- *
- * Specialization added for error control purpose.
- */
-template <>
-class TypeAt<Compound<>, 0>{};
-
 /**
  * @brief Helper class used for extracting i-th type from Compound;
  *
@@ -142,12 +545,17 @@ class TypeAt<Compound<>, i>{};
 
 /**
  * @brief Helper class used for extracting i-th type from Compound;
+ *
+ * Type is selected by overload resolution against a class deriving from all
+ * indexed members, so neither instantiation depth nor count depend on `i`.
  */
-template <int i, typename T, typename ...Args>
-class TypeAt<Compound<T, Args...>, i>{
+template <int i, typename ...Args>
+class TypeAt<Compound<Args...>, i>{
+private:
+    typedef IndexedTypes<std::index_sequence_for<Args...>, Args...> Indexed;
 public:
-    typedef typename TypeAt<Compound<Args...>, i-1>::Type Type;
-    //!< Defined as i-1-th element of shorter Compound.
+    typedef typename decltype(selectIndexed<i>(Indexed()))::Type Type;
+    //!< I-th type of the Compound.
 };
 
 //------------------------------------------------------------------------------------------------------------------
@@ -156,15 +564,13 @@ public:
  * @brief Helper class used for raising to given power classes representing
  * units and dimensions.
  *
- * Specialization that uses recursion to check all members of a Compound type.
+ * Specialization for Compound types. Every member is raised separately, and
+ * results are joined using `JoinAll`.
  */
-template <typename ...Args, int pow, int i>
-class Raise<Compound<Args...>, pow, i>{
-public:
-    typedef typename Raise<Compound<Args...>, pow, i-1>::Type Basic;
-    typedef typename Raise<typename TypeAt<Compound<Args...>, i>::Type, pow>::Type iPower;
+template <typename ...Args, int pow>
+class Raise<Compound<Args...>, pow>{
 public:
-    typedef typename Join<Basic, iPower>::Type Type;
+    typedef typename JoinAll<typename Raise<Args, pow>::Type...>::Type Type;
     //!< For Compound types, just use Raise on every type on it's argument list.
 };
 
@@ -172,12 +578,13 @@ public:
  * @brief Helper class used for raising to given power classes representing
  * units and dimensions.
  *
- * Specialization for recursion termination.
+ * Specialization for Compound types and power of one. It is necesary to avoid
+ * ambiguity when selcting template specialization.
  */
-template <typename ...Args, int pow>
-class Raise<Compound<Args...>, pow, -1>{
+template <typename ...Args>
+class Raise<Compound<Args...>, 1>{
 public:
-    typedef Compound<> Type;
+    typedef typename JoinAll<typename Raise<Args, 1>::Type...>::Type Type;
 };
 
 /**
@@ -186,8 +593,8 @@ public:
  *
  * Specialization for Power class.
  */
-template <typename T, int tpow, int pow, int i>
-class Raise<Power<T, tpow>, pow, i>{
+template <typename T, int tpow, int pow>
+class Raise<Power<T, tpow>, pow>{
 public:
     typedef typename Raise<T, tpow*pow>::Type Type;
 };
@@ -199,8 +606,8 @@ public:
  * Specialization for power of one.
  * Used to skip Power wrapper class if it's not necesary.
  */
-template <typename T, int i>
-class Raise<T, 1, i>{
+template <typename T>
+class Raise<T, 1>{
 public:
     typedef T Type;
 };
@@ -213,8 +620,8 @@ public:
  * ambiguity when selcting template specialization. Used to skip Power wrapper
  * class if it's not necesary.
  */
-template <typename T, int tpow, int i>
-class Raise<Power<T, tpow>, 1, i>{
+template <typename T, int tpow>
+class Raise<Power<T, tpow>, 1>{
 public:
     typedef typename Raise<T, tpow>::Type Type;
 };
@@ -225,7 +632,7 @@ public:
  *
  * Specialization for generic classes.
  */
-template <typename T, int pow, int i>
+template <typename T, int pow>
 class Raise{
 public:
     typedef Power<T, pow> Type;
@@ -292,33 +699,12 @@ public:
  * argument can be a singular unit or dimension or a power of it, but never a
  * compound unit or dimension.
  *
- * Recursive specialization for Compound class and singular type.
- */
-
-template <typename ...Args, typename T, int i>
-class HasPower<Compound<Args...>, T, i>{
-private:
-    typedef HasPower<Compound<Args...>, T, i-1> Basic;
-    typedef typename TypeAt<Compound<Args...>, i>::Type iType;
-public:
-    enum:int { value = Basic::value || IsEqual<T, iType>::value };
-};
-
-/**
- * @brief Helper class used for checking if (first template argument) class
- * representing unit or dimensions contains specific unit or dimension (second
- * class template).
- *
- * First template argument must be simplified. Second template
- * argument can be a singular unit or dimension or a power of it, but never a
- * compound unit or dimension.
- *
- * Specialization for recursion termination.
+ * Specialization for Compound class and singular type.
  */
 template <typename ...Args, typename T>
-class HasPower<Compound<Args...>, T, -1>{
+class HasPower<Compound<Args...>, T>{
 public:
-    static const bool value = false;
+    static const bool value = (false || ... || IsEqual<T, Args>::value);
 };
 
 /**
@@ -332,7 +718,7 @@ public:
  *
  * Specialization for comparing singular types.
  */
-template <typename T, typename U, int i>
+template <typename T, typename U>
 class HasPower{
 public:
     static const bool value = LibUnit::IsEqual<T, U>::value;
@@ -350,62 +736,24 @@ class IsEqualHelper;
 /**
  * @brief Helper class used for comparing Compound units and dimensions.
  *
- * It uses recursion, and it has additional template parameter used to cutoff
- * template instantiation in case it is already clear that Compound units are
- * different. Input types must be simplified and have the same length.
+ * Checks if every type from the first Compound is present in the second one.
+ * Input types must be simplified and have the same length.
  */
-// Additional bool parameter stops checking if we deteremine that both Compounds
-// are not equal.
-template <typename T, typename U, int i=TypeCount<T>::value-1, bool differ=false>
+template <typename T, typename U>
 class IsEqualCompound;
 
 /**
  * @brief Helper class used for comparing Compound units and dimensions.
  *
- * It uses recursion, and it has additional template parameter used to cutoff
- * template instantiation in case it is already clear that Compound units are
- * different. Input types must be simplified and have the same length.
+ * Checks if every type from the first Compound is present in the second one.
+ * Input types must be simplified and have the same length.
  *
- * Specialization used as cutoff when Compounds are already known to be
- * different.
- */
-template <typename T, typename U, int i>
-class IsEqualCompound<T, U, i, true>{
-public:
-    static const bool value = 0;
-};
-
-/**
- * @brief Helper class used for comparing Compound units and dimensions.
- *
- * It uses recursion, and it has additional template parameter used to cutoff
- * template instantiation in case it is already clear that Compound units are
- * different. Input types must be simplified and have the same length.
- *
- * Specialization for recursion stop.
+ * Specialization for Compound types.
  */
 template <typename ...Args1, typename ...Args2>
-class IsEqualCompound<Compound<Args1...>, Compound<Args2...>, -1, false>{
-public:
-    static const bool value = 1;
-};
-
-/**
- * @brief Helper class used for comparing Compound units and dimensions.
- *
- * It uses recursion, and it has additional template parameter used to cutoff
- * template instantiation in case it is already clear that Compound units are
- * different. Input types must be simplified and have the same length.
- *
- * Main specialization used for recursive checking.
- */
-template <typename ...Args1, typename ...Args2, int i>
-class IsEqualCompound<Compound<Args1...>, Compound<Args2...>, i, false>{
-private:
-    typedef typename TypeAt<Compound<Args1...>, i>::Type iType;
-    typedef IsEqualCompound<Compound<Args1...>, Compound<Args2...>, i-1, !HasPower<Compound<Args2...>, iType>::value> Basic;
+class IsEqualCompound<Compound<Args1...>, Compound<Args2...>>{
 public:
-    static const bool value = Basic::value;
+    static const bool value = (true && ... && HasPower<Compound<Args2...>, Args1>::value);
 };
 
 /**
@@ -500,38 +848,45 @@ public:
 
 //------------------------------------------------------------------------------------------------------------------
 
-// Flatten Helper class.
-//
-// This class works on user-supplied compound types without any further checking.
-// It is used to transform possibly nested Compound type into flat Compound list.
+/** @cond DOXYGEN_EXCLUDE */
+
+template <typename T>
+class JoinTag{
+public:
+    typedef T Type;
+};
+
+template <typename T, typename U>
+JoinTag<typename Join<T, U>::Type> operator|(JoinTag<T>, JoinTag<U>);
+
+/** @endcond */
 
 /**
- * @brief Helper class used for flattening nested Compound types.
+ * @brief Helper class used for joining any number of units and dimensions
+ * into a compound unit or dimension.
  *
- * @tparam Compound<Args...> Type to be falttened.
- * @tparam i @keep_default
- *
- * Flattened type is guaranteed to be either a simple type, a power of a simple
- * type or a Compound containing simple types and powers of simple types.
- * Flatten converts input types into falttened types by extracting nested
- * Compound types and converting Compound type raised to a power to Compound
- * with all its elements raised to the same power.
- *
- * Specialization for Compound types.
+ * Result is the same as joining all arguments one by one using `Join`,
+ * starting with an empty `Compound<>`. Joining is performed by a fold
+ * expression, so template instantiation depth doesn't depend on number of
+ * arguments.
  */
-template <typename ...Args, int i>
-class Flatten<Compound<Args...>, i>{
-    typedef typename Flatten<Compound<Args...>, i-1>::Type Basic;
+template <typename ...Args>
+class JoinAll{
 public:
-    typedef typename Join<Basic, typename Flatten<typename TypeAt<Compound<Args...>, i>::Type>::Type>::Type Type;
-    // Appending a compound joins both argument lists, so no matter what comes out At<i>, it will behave well
+    typedef typename decltype((JoinTag<Compound<>>() | ... | JoinTag<Args>()))::Type Type;
 };
 
+//------------------------------------------------------------------------------------------------------------------
+
+// Flatten Helper class.
+//
+// This class works on user-supplied compound types without any further checking.
+// It is used to transform possibly nested Compound type into flat Compound list.
+
 /**
  * @brief Helper class used for flattening nested Compound types.
  *
  * @tparam Compound<Args...> Type to be falttened.
- * @tparam i @keep_default
  *
  * Flattened type is guaranteed to be either a simple type, a power of a simple
  * type or a Compound containing simple types and powers of simple types.
@@ -539,19 +894,19 @@ public:
  * Compound types and converting Compound type raised to a power to Compound
  * with all its elements raised to the same power.
  *
- * Specialization used as recursion end condition.
+ * Specialization for Compound types.
  */
 template <typename ...Args>
-class Flatten<Compound<Args...>, -1>{
+class Flatten<Compound<Args...>>{
 public:
-    typedef Compound<> Type;
+    typedef typename JoinAll<typename Flatten<Args>::Type...>::Type Type;
+    // Appending a compound joins both argument lists, so no matter what comes out of Flatten, it will behave well
 };
 
 /**
  * @brief Helper class used for flattening nested Compound types.
  *
  * @tparam Power<T, pow> Type to be falttened.
- * @tparam i @keep_default
  *
  * Flattened type is guaranteed to be either a simple type, a power of a simple
  * type or a Compound containing simple types and powers of simple types.
@@ -561,8 +916,8 @@ public:
  *
  * Specialization for Power type.
  */
-template <typename T, int pow, int i>
-class Flatten<Power<T, pow>, i>{
+template <typename T, int pow>
+class Flatten<Power<T, pow>>{
 public:
     typedef typename Raise<T, pow>::Type Type;
 };
@@ -571,7 +926,6 @@ public:
  * @brief Helper class used for flattening nested Compound types.
  *
  * @tparam Power<T, 1> Type to be falttened.
- * @tparam i @keep_default
  *
  * Flattened type is guaranteed to be either a simple type, a power of a simple
  * type or a Compound containing simple types and powers of simple types.
@@ -581,8 +935,8 @@ public:
  *
  * Specialization for Power of one type.
  */
-template <typename T, int i>
-class Flatten<Power<T, 1>, i>{
+template <typename T>
+class Flatten<Power<T, 1>>{
 public:
     typedef typename Flatten<T>::Type Type;
 };
@@ -591,7 +945,6 @@ public:
  * @brief Helper class used for flattening nested Compound types.
  *
  * @tparam T Type to be falttened.
- * @tparam i @keep_default
  *
  * Flattened type is guaranteed to be either a simple type, a power of a simple
  * type or a Compound containing simple types and powers of simple types.
@@ -601,7 +954,7 @@ public:
  *
  * Specialization for simple types.
  */
-template <typename T, int i>
+template <typename T>
 class Flatten{
 public:
     typedef T Type;
@@ -610,91 +963,38 @@ public:
 //------------------------------------------------------------------------------------------------------------------
 
 /** @cond DOXYGEN_EXCLUDE */
-template <typename U, typename T, int i = TypeCount<U>::value-1>
-class SimplifyJoin;
-/** @endcond */
-
 
-/**
- * @brief Helper class used for joining a type into a Compound type.
- *
- * @tparam U Already simplified Compound class, that type `T` will be integrated
- * into.
- * @tparam T Power class, that should be integrated into `U` list.
- * @tparam i @keep_default
- *
- * Joining a type into a Compound type is performed by by adjusting
- * a power of preexisting power of same simple type and removing such entry
- * completely if final power equals `0`. If no preexisting power of given simple
- * type exists in given Compound, the `Type` typedef equals to input Compound
- * and `joined` member is set to `false`. Otherwise `joined` member is set to
- * `true`. Input Compound must be already simplified, and type to be joined
- * must be a power of a simple type.
- *
- * Specialization for recursive joining.
- */
-
-// SimplifyJoin is a helper class that is used by Simplify. It is inserting type T into U if U already contains
-// any power of T::basic. If resulting power of T::basic equals 0, resulting list has no entry for this type.
-//
-// If U doesnt contain a power of T::basic, entry is not created, and joined equals zero. Otherwise joined equals one.
-
-template <typename ...Args, typename T, int i>
-class SimplifyJoin<Compound<Args...>, T, i>{
-private:
-    typedef typename TypeAt<Compound<Args...>, i>::Type I;
-    typedef SimplifyJoin<Compound<Args...>, T, i-1> Helper;
-
-    // This is here and not direclty public because doxygen makes a mess out of
-    // it.
-    typedef typename std::conditional< std::is_same<typename BasicOf<T>::Type, typename BasicOf<I>::Type>::value,
-                                       typename std::conditional<PowerOf<T>::value + PowerOf<I>::value,
-                                                                 typename Join<typename Helper::Type, Power<typename BasicOf<T>::Type, PowerOf<T>::value + PowerOf<I>::value>>::Type,
-                                                                 typename Helper::Type
-                                       >::type,
-                                       typename Join<typename Helper::Type, I>::Type
-        >::type ResultType;
-public:
-
-    static const bool joined = Helper::joined || std::is_same<typename BasicOf<T>::Type, typename BasicOf<I>::Type>::value;
-    //!< indicates if T was indeed integrated into resulting list.
+template <typename T, typename ...Args>
+constexpr std::size_t firstOfBasic(){
+    constexpr bool same[] = {std::is_same<typename BasicOf<T>::Type, typename BasicOf<Args>::Type>::value...};
+    std::size_t i = 0;
+    while (!same[i])
+        i++;
+    return i;
+}
 
-    typedef ResultType Type;
-    //!< compound class representing resulting list
-};
+template <typename ...Args>
+constexpr std::array<int, sizeof...(Args)> sumPowersOfBasics(){
+    constexpr std::size_t first[] = {firstOfBasic<Args, Args...>()...};
+    constexpr int powers[] = {PowerOf<Args>::value...};
+    std::array<int, sizeof...(Args)> result = {};
+    for (std::size_t i=0; i<sizeof...(Args); i++)
+        result[first[i]] += powers[i];
+    return result;
+}
 
+template <typename T>
+T unwrapSingle(Compound<T>*);
 
-/**
- * @brief Helper class used for joining a type into a Compound type.
- *
- * @tparam U Already simplified Compound class, that type `T` will be integrated
- * into.
- * @tparam T Power class, that should be integrated into `U` list.
- * @tparam i @keep_default
- *
- * Joining a type into a Compound type is performed by by adjusting
- * a power of preexisting power of same simple type and removing such entry
- * completely if final power equals `0`. If no preexisting power of given simple
- * type exists in given Compound, the `Type` typedef equals to input Compound
- * and `joined` member is set to `false`. Otherwise `joined` member is set to
- * `true`. Input Compound must be already simplified, and type to be joined
- * must be a power of a simple type.
- *
- * Specialization that stops recursion.
- */
-template <typename ...Args, typename T>
-class SimplifyJoin<Compound<Args...>, T, -1>{
-public:
-    static const bool joined = 0;
+template <typename T>
+T unwrapSingle(T*);
 
-    typedef Compound<> Type;
-};
+/** @endcond */
 
 /**
  * @brief Helper class used for simplifying a type.
  *
  * @tparam Compound<Args...> Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -704,28 +1004,34 @@ public:
  * `Power` or `Compound`. Empty-unit (dimensionless) is represented by empty
  * `Compound<>`.
  *
- * Specialization for recursive simplification of Compound types.
+ * Specialization for Compound types. Powers of each singular type are summed
+ * up and stored at position of its first occurence; types with resulting
+ * power of `0` are removed. Powers are computed by a constexpr function over
+ * the argument pack, so instantiation depth doesn't depend on Compound length.
  */
-template <typename ...Args, int i>
-class Simplify<Compound<Args...>, i>{
+template <typename ...Args>
+class Simplify<Compound<Args...>>{
 private:
-    typedef typename Simplify<Compound<Args...>, i-1>::Type Basic;
-    typedef typename TypeAt<Compound<Args...>, i>::Type I;
-    typedef SimplifyJoin<Basic, I> Helper;
-public:
+    static constexpr std::array<int, sizeof...(Args)> powers = sumPowersOfBasics<Args...>();
 
-    typedef typename std::conditional<Helper::joined || PowerOf<I>::value == 0,
-                                      typename Helper::Type,
-                                      typename Join<typename Helper::Type, I>::Type
-    >::type Type;
+    template <std::size_t ...I>
+    static auto simplify(std::index_sequence<I...>) -> typename JoinAll<
+        typename std::conditional<powers[I] != 0,
+                                  typename Raise<typename BasicOf<Args>::Type, powers[I]>::Type,
+                                  Compound<>
+        >::type...
+    >::Type;
 
+    typedef decltype(simplify(std::index_sequence_for<Args...>())) Simplified;
+
+public:
+    typedef decltype(unwrapSingle(static_cast<Simplified*>(nullptr))) Type;
 };
 
 /**
  * @brief Helper class used for simplifying a type.
  *
- * @tparam Compound<Args...> Type to be simplified.
- * @tparam i @keep_default
+ * @tparam Compound<> Type to be simplified.
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -735,10 +1041,10 @@ public:
  * `Power` or `Compound`. Empty-unit (dimensionless) is represented by empty
  * `Compound<>`.
  *
- * Specialization that stops recursion.
+ * Specialization for empty Compound.
  */
-template <typename ...Args>
-class Simplify<Compound<Args...>, -1>{
+template <>
+class Simplify<Compound<>>{
 public:
     typedef Compound<> Type;
 };
@@ -747,7 +1053,6 @@ public:
  * @brief Helper class used for simplifying a type.
  *
  * @tparam Compound<T> Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -759,8 +1064,8 @@ public:
  *
  * Specialization for Compound types containing only one element.
  */
-template <typename T, int i>
-class Simplify<Compound<T>, i>{
+template <typename T>
+class Simplify<Compound<T>>{
 public:
     typedef typename Simplify<T>::Type Type;
 };
@@ -769,7 +1074,6 @@ public:
  * @brief Helper class used for simplifying a type.
  *
  * @tparam Power<T, pow> Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -781,8 +1085,8 @@ public:
  *
  * Specialization for power type.
  */
-template <typename T, int pow, int i>
-class Simplify<Power<T, pow>, i>{
+template <typename T, int pow>
+class Simplify<Power<T, pow>>{
 public:
     typedef typename Raise<typename Simplify<T>::Type, pow>::Type Type;
 };
@@ -791,7 +1095,6 @@ public:
  * @brief Helper class used for simplifying a type.
  *
  * @tparam Power<T,1> Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -803,8 +1106,8 @@ public:
  *
  * Specialization for power-of-one type.
  */
-template <typename T, int i>
-class Simplify<Power<T, 1>, i>{
+template <typename T>
+class Simplify<Power<T, 1>>{
 public:
     typedef typename Simplify<T>::Type Type;
 };
@@ -813,7 +1116,6 @@ public:
  * @brief Helper class used for simplifying a type.
  *
  * @tparam Power<T, 0> Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -825,8 +1127,8 @@ public:
  *
  * Specialization for power-of-zero type.
  */
-template <typename T, int i>
-class Simplify<Power<T, 0>, i>{
+template <typename T>
+class Simplify<Power<T, 0>>{
 public:
     typedef Compound<> Type;
 };
@@ -836,7 +1138,6 @@ public:
  * @brief Helper class used for simplifying a type.
  *
  * @tparam T Type to be simplified.
- * @tparam i @keep_default
  *
  * Type that is to be simplified must be flat. Simplified type is a flat type
  * that has at most one power of any singular type. If simplified type has only
@@ -848,7 +1149,7 @@ public:
  *
  * Specialization for simple type.
  */
-template <typename T, int i>
+template <typename T>
 class Simplify{
 public:
     typedef T Type;
@@ -891,20 +1192,17 @@ public:
  * unit.
  *
  * @tparam T Unit for which dimension is computed.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `Dimension` subtype.
  *
- * Recursive Specialization for Compound units.
+ * Specialization for Compound units. Dimensions of all members are joined
+ * using `JoinAll`.
  */
-template <typename ...Args, int i>
-class DimensionOf<Compound<Args...>, i>{
-private:
-    typedef typename DimensionOf<Compound<Args...>, i-1>::Type basic;
-    typedef typename DimensionOf<typename TypeAt<Compound<Args...>, i>::Type>::Type iDimension;
+template <typename ...Args>
+class DimensionOf<Compound<Args...>>{
 public:
-    typedef typename Join<basic, iDimension>::Type Type;
+    typedef typename JoinAll<typename DimensionOf<Args>::Type...>::Type Type;
     //!< Dimension of template-parameter unit;
 };
 
@@ -913,17 +1211,16 @@ public:
  * unit.
  *
  * @tparam T Unit for which dimension is computed.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `Dimension` subtype.
  *
- * Specialization that ends recursion.
+ * Specialization for power types.
  */
-template <typename ...Args>
-class DimensionOf<Compound<Args...>, -1>{
+template <typename T, int pow>
+class DimensionOf<Power<T, pow>>{
 public:
-    typedef Compound<> Type;
+    typedef Power<typename DimensionOf<T>::Type, pow> Type;
 };
 
 /**
@@ -931,35 +1228,105 @@ public:
  * unit.
  *
  * @tparam T Unit for which dimension is computed.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `Dimension` subtype.
  *
- * Specialization for power types.
+ * Specialization for simple types.
  */
-template <typename T, int pow, int i>
-class DimensionOf<Power<T, pow>, i>{
+template <typename T>
+class DimensionOf{
 public:
-    typedef Power<typename DimensionOf<T>::Type, pow> Type;
+    typedef typename T::Dimension Type;
 };
 
+//------------------------------------------------------------------------------------------------------------------
+
 /**
- * @brief Helper class used to extract dimension form a type representing a
- * unit.
+ * @brief Helper class used to compute exponent vector of a unit or a
+ * dimension.
  *
- * @tparam T Unit for which dimension is computed.
- * @tparam i @keep_default
+ * @tparam T Unit or dimension for which vector is computed.
  *
- * Input type must be a proper unit ie. all simple units used must define
- * `Dimension` subtype.
+ * Simple types that define `Dimension` subtype are treated as units and their
+ * dimension is used. Other simple types are treated as base dimensions.
+ * `representable` is `false` if any base dimension used has no slot assigned
+ * by `BaseDimensionIndex`; `value` is meaningless in such case.
  *
- * Specialization for simple types.
+ * Specialization for base dimensions.
  */
-template <typename T, int i>
-class DimensionOf{
+template <typename T, typename>
+class DimensionVectorOf{
+private:
+    static constexpr int index = BaseDimensionIndex<T>::value;
 public:
-    typedef typename T::Dimension Type;
+    static constexpr bool representable = index >= 0;
+    static constexpr DimensionVector value = representable ? DimensionVector::base(index) : DimensionVector();
+};
+
+/**
+ * @brief Helper class used to compute exponent vector of a unit or a
+ * dimension.
+ *
+ * @tparam T Unit or dimension for which vector is computed.
+ *
+ * Specialization for simple units.
+ */
+template <typename T>
+class DimensionVectorOf<T, std::void_t<typename T::Dimension>>{
+private:
+    typedef DimensionVectorOf<typename T::Dimension> basic;
+public:
+    static constexpr bool representable = basic::representable;
+    static constexpr DimensionVector value = basic::value;
+};
+
+/**
+ * @brief Helper class used to compute exponent vector of a unit or a
+ * dimension.
+ *
+ * @tparam T Unit or dimension for which vector is computed.
+ *
+ * Specialization for dimensions described by a vector.
+ */
+template <DimensionVector v>
+class DimensionVectorOf<VectorDimension<v>, void>{
+public:
+    static constexpr bool representable = true;
+    static constexpr DimensionVector value = v;
+};
+
+/**
+ * @brief Helper class used to compute exponent vector of a unit or a
+ * dimension.
+ *
+ * @tparam T Unit or dimension for which vector is computed.
+ *
+ * Specialization for power types.
+ */
+template <typename T, int pow>
+class DimensionVectorOf<Power<T, pow>, void>{
+private:
+    typedef DimensionVectorOf<T> basic;
+public:
+    static constexpr bool representable = basic::representable;
+    static constexpr DimensionVector value = basic::value * pow;
+};
+
+/**
+ * @brief Helper class used to compute exponent vector of a unit or a
+ * dimension.
+ *
+ * @tparam T Unit or dimension for which vector is computed.
+ *
+ * Specialization for Compound types. Vectors of all members are added without
+ * any recursion over the argument list.
+ */
+template <typename ...Args>
+class DimensionVectorOf<Compound<Args...>, void>{
+public:
+    static constexpr bool representable = (true && ... && DimensionVectorOf<Args>::representable);
+    static constexpr DimensionVector value = (DimensionVector() + ... + DimensionVectorOf<Args>::value);
 };
 
 //------------------------------------------------------------------------------------------------------------------
@@ -1021,127 +1388,91 @@ public:
 };
 
 /**
- * @brief Helper class used to invert ratio of a value of a class. Result type
- * is integral if value is `1` or `-1`, otherwise it's double;
- *
- * @tparam T Type that contains `static constexpr` field `value`.
- * @tparam integral @keep_default
- *
- * Specialization for non-integral result types.
- */
-template <typename T, bool integral = std::is_integral<decltype(T::value)>::value>
-class InvertFactor{
-public:
-    static constexpr auto value = 1/T::value;
-};
-
-/**
- * @brief Helper class used to invert ratio of a value of a class. Result type
- * is integral if value is `1` or `-1`, otherwise it's double;
+ * @brief Helper class used to compute exact ratio of two factors.
  *
- * @tparam T Type that contains `static constexpr` field `value`.
- * @tparam integral @keep_default
+ * @tparam T Type that represents factor in numerator. 'T' must contain `static
+ * constexpr` field `value` of type `ExactFactor`.
+ * @tparam U Type that represents factor in denominator. 'U' must contain
+ * `static constexpr` field `value` of type `ExactFactor`.
  *
- * Specialization for integral result types.
+ * Ratio is computed exactly and rounded only once. Member `value` is of type
+ * `int` if ratio is an integer that fits it, `std::intmax_t` if ratio is a
+ * larger integer, or `double` otherwise. This way conversions by integral
+ * ratios stay in integer arithmetic.
  */
-template <typename T>
-class InvertFactor<T, true>{
-private:
-    typedef typename std::conditional<T::value == 1 || T::value == -1, decltype(T::value), double>::type ttype;
+template <typename T, typename U>
+class ExactRatioFactor{
 public:
-    static constexpr auto value = 1/ttype(T::value);
-};
+    static constexpr ExactFactor exact = T::value / U::value;
+    //!< Exact value of the ratio.
 
+    static constexpr bool identity = exact.isOne();
+    //!< True if the ratio equals exactly one.
 
-/**
- * @brief Helper class that raises a value to given integer power.
- * @return `value` to the power `pow`
- *
- * @tparam T Type that contains `static constexpr` field `value`.
- * @tparam pow Power to which value is raised to.
- * @tparam powlz @keep_default
- *
- * It is used in factor calculation of powers of units.
- */
-template <typename T, int pow, bool powlz=(pow<0)>
-class RaiseToPower{
-private:
-    typedef RaiseToPower<T, pow/2> prevPow;
-public:
-    static constexpr auto value = prevPow::value*prevPow::value
-          * (pow%2?T::value:1);
-};
+    static constexpr auto value = [](){
+        if constexpr (exact.isInteger() && exact.integer() <= std::numeric_limits<int>::max())
+            return static_cast<int>(exact.integer());
+        else if constexpr (exact.isInteger())
+            return exact.integer();
+        else
+            return exact.template as<double>();
+    }();
+    //!< Value of the ratio, rounded once.
 
-/** @cond DOXYGEN_EXCLUDE */
+    static constexpr bool rational = exact.isRational();
+    //!< True if the ratio is a fraction of two `std::intmax_t` integers.
 
-template <typename T>
-class RaiseToPower<T, 1, false>{
-public:
-    static constexpr auto value = T::value;
-};
+    static constexpr std::intmax_t numerator = rational ? exact.rationalNumerator() : 0;
+    //!< Numerator of the ratio, valid only if `rational`.
 
-template <typename T>
-class RaiseToPower<T, 0, false>{
-public:
-    static constexpr int value = 1;
-};
+    static constexpr std::intmax_t denominator = rational ? exact.rationalDenominator() : 1;
+    //!< Denominator of the ratio, valid only if `rational`.
 
-template <typename T, int pow>
-class RaiseToPower<T, pow, true>{
-private:
-    typedef RaiseToPower<T, -pow> prevPow;
-public:
-    static constexpr auto value = InvertFactor<prevPow>::value;
+    static constexpr inline auto getValue(){
+        return value;
+    }
 };
 
-/** @endcond */
-
 /**
- * @brief Helper class used to compute factor used to convert units.
- *
- * @tparam T Unit to compute factor of.
- * @tparam i @keep_default
- *
- * Input type must be a proper unit ie. all simple units used must define
- * `factor` static constant. Result is a multiplication of factors of all
- * simple units raised to powers in which those simple units appear in a unit
- * for which calculation is performed.
+ * @brief Helper function converting `factor` member of a simple unit into
+ * `ExactFactor`.
  *
- * Recursive specialization for Compound types.
+ * Integral factors are converted exactly; floating point factors are
+ * converted using `ExactFactor::approximate`.
  */
-template <typename ...Args, int i>
-class FactorOf<Compound<Args...>, i>{
-private:
-    typedef FactorOf<Compound<Args...>, i-1> basic;
-    typedef FactorOf<typename TypeAt<Compound<Args...>, i>::Type> iFactor;
-public:
-    static constexpr auto value = basic::value*iFactor::value;
-};
+template <typename T>
+constexpr ExactFactor toExactFactor(const T& factor){
+    if constexpr (std::is_integral<T>::value)
+        return ExactFactor(factor);
+    else if constexpr (std::is_floating_point<T>::value)
+        return ExactFactor::approximate(factor);
+    else
+        return factor;
+}
 
 /**
  * @brief Helper class used to compute factor used to convert units.
  *
  * @tparam T Unit to compute factor of.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `factor` static constant. Result is a multiplication of factors of all
  * simple units raised to powers in which those simple units appear in a unit
  * for which calculation is performed.
  *
- * Specialization that ends recursion.
+ * Specialization for Compound types. Factors are multiplied by a fold
+ * expression.
  */
 template <typename ...Args>
-class FactorOf<Compound<Args...>, -1>{
+class FactorOf<Compound<Args...>>{
 public:
-    static constexpr int value = 1;
+    static constexpr ExactFactor value = (ExactFactor() * ... * FactorOf<Args>::value);
 };
 
 /**
  * @brief Helper class used to compute factor used to convert units.
  *
  * @tparam T Unit to compute factor of.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `factor` static constant. Result is a multiplication of factors of all
@@ -1150,19 +1481,16 @@ public:
  *
  * Specialization for power types.
  */
-template <typename T, int pow, int i>
-class FactorOf<Power<T, pow>, i>{
-private:
-    typedef FactorOf<T> basic;
+template <typename T, int pow>
+class FactorOf<Power<T, pow>>{
 public:
-    static constexpr auto value = RaiseToPower<basic, pow>::value;
+    static constexpr ExactFactor value = FactorOf<T>::value.pow(pow);
 };
 
 /**
  * @brief Helper class used to compute factor used to convert units.
  *
  * @tparam T Unit to compute factor of.
- * @tparam i @keep_default
  *
  * Input type must be a proper unit ie. all simple units used must define
  * `factor` static constant. Result is a multiplication of factors of all
@@ -1171,10 +1499,10 @@ public:
  *
  * Specialization for simple types.
  */
-template <typename T, int i>
+template <typename T>
 class FactorOf{
 public:
-   static constexpr auto value = T::factor;
+   static constexpr ExactFactor value = toExactFactor(T::factor);
 };
 
 //------------------------------------------------------------------------------------------------------------------
@@ -1265,7 +1593,7 @@ using Join = typename Helper::Join<T, U>::Type;
  * Flatten<Compound<Compound<A,B>, C>>; // is Compound<A,B,C>
  * Flatten<Compound<A, Power<Compound<B, C>,2>>; // is Compound<A,Power<B,2>,Power<C,2>>
  * Flatten<Compound<A, Power<Compound<B, Power<C,3>>,2>>; // is Compound<A,Power<B,2>,Power<C,6>>
- * Flatten<Compound<A, Power<Compound<B, Power<C,-1>>,2>>; // is Compound<A,Power<B,2>,C>
+ * Flatten<Compound<A, Power<Compound<B, Power<C,-1>>,2>>; // is Compound<A,Power<B,2>,Power<C,-2>>
  * ~~~~~~~~~~~~~~~~~~~~
  */
 template <typename T>
@@ -1395,6 +1723,10 @@ using DimensionOf = typename Helper::DimensionOf<T>::Type;
  * unit `Un2` equals value multiplied by ration of the factor of unit `Un1` to
  * the factor of unit `Un2`.
  *
+ * `static constexpr` member `value` is an `ExactFactor`. Simple units can
+ * define their `factor` as an integer, an `ExactFactor` or a floating point
+ * value; the last one is not exact.
+ *
  * Examples
  * ------------------------
  * ~~~~~~~~~~~~~~~~~~~~{.cpp}
@@ -1448,11 +1780,14 @@ using RatioFactor = Helper::RatioFactor<T,U>;
  * @tparam T Unit in the numerator.
  * @tparam U Unit in the denominator.
  *
- * `static constexpr` member `value` represents value of a ratio of factors of
- * units `T` and `U`.
+ * `static constexpr` member `exact` is the exact `ExactFactor` ratio of factors
+ * of units `T` and `U`, and member `value` represents it rounded once to
+ * `int`, `std::intmax_t` or `double` (see `Helper::ExactRatioFactor`). Member
+ * `identity` is `true` if both units have exactly the same factor. If member
+ * `rational` is `true`, the ratio equals exactly `numerator/denominator`.
  */
 template <typename T, typename U>
-using RatioFactorOf = Helper::RatioFactor<FactorOf<T>,FactorOf<U>>;
+using RatioFactorOf = Helper::ExactRatioFactor<FactorOf<T>,FactorOf<U>>;
 
 /**
  * @brief Template used to comapre units and dimensions.
@@ -1537,17 +1872,46 @@ class IsEqual<T,U, false>: public std::integral_constant<bool, IsEqual<Simplify<
 /** @endcond */
 
 //------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Template used to compute exponent vector of a unit or a dimension.
+ *
+ * @tparam T Unit or dimension for which a vector is computed.
+ *
+ * `static constexpr` member `value` is a `DimensionVector` of `T`, and member
+ * `representable` tells if all base dimensions of `T` have slots assigned by
+ * `BaseDimensionIndex`.
+ *
+ * Examples
+ * ------------------------
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * DimensionVectorOf<Newton>::value; // {1, 1, -2, 0, 0, 0, 0, 0}
+ * DimensionVectorOf<Compound<Length, Power<Time, -1>>>::value; // {1, 0, -1, 0, 0, 0, 0, 0}
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename T>
+using DimensionVectorOf = Helper::DimensionVectorOf<T>;
+
 /**
  * @brief Template shortcut used to compare dimensions of two units.
  *
  * @tparam T First unit or dimension to be compared.
  * @tparam U %Second unit or dimension to be compared.
+ * @tparam representable @keep_default
  *
- * It is equivalent to `IsEqual<DimensionOf<T>, DimensionOf<U>>`.
+ * It is equivalent to `IsEqual<DimensionOf<T>, DimensionOf<U>>`. If both
+ * dimensions can be represented by a `DimensionVector`, their vectors are
+ * compared instead, which requires no simplification of Compound types.
  */
+template <typename T, typename U, bool representable = DimensionVectorOf<T>::representable && DimensionVectorOf<U>::representable>
+class IsEqualDimension: public std::integral_constant<bool, DimensionVectorOf<T>::value == DimensionVectorOf<U>::value>
+{};
+
+/** @cond DOXYGEN_EXCLUDE */
 template <typename T, typename U>
-class IsEqualDimension: public std::integral_constant<bool, IsEqual<DimensionOf<T>, DimensionOf<U>>::value>
+class IsEqualDimension<T, U, false>: public std::integral_constant<bool, IsEqual<DimensionOf<T>, DimensionOf<U>>::value>
 {};
+/** @endcond */
 
 /**
  * @brief Template used to check if two units are convertible.
@@ -1572,10 +1936,35 @@ class Convertible: public std::integral_constant<bool, IsEqualDimension<From, To
  *
  */
 template <typename From, typename To>
-inline constexpr void checkConvertible(){
+inline constexpr void checkConvertible() noexcept{
     static_assert(Convertible<From, To>::value, "Attempt to convert value between non-convertible units.");
 }
 
+/**
+ * @brief Traits of vector types used as underlying types of quantities.
+ *
+ * @tparam T Underlying type of a quantity.
+ *
+ * Vector types hold several values of the same element type, and apply
+ * operators to all of them at once, ie. `std::experimental::simd` (see
+ * simd.h) or GCC vector extensions. For such types:
+ *  - `isVector` is true;
+ *  - `Element` is the type of elements.
+ *
+ * Conversion factors are converted to `Element` before multiplication, so
+ * they are broadcast to all elements. For other types `Element` is `T`.
+ *
+ * @remark
+ * Specialize this class to use other vector types as underlying types of
+ * quantities.
+ */
+template <typename T>
+class VectorTraits{
+public:
+    static constexpr bool isVector = false;
+    typedef T Element;
+};
+
 /**
  * @brief Template used to convert value expressed in one unit to value
  * expressed in another.
@@ -1591,6 +1980,18 @@ inline constexpr void checkConvertible(){
  */
 template <typename From, typename To>
 class Convert{
+private:
+    template <typename T>
+    static inline constexpr auto factor() noexcept{
+        typedef typename VectorTraits<T>::Element Element;
+        if constexpr (VectorTraits<T>::isVector){
+            static_assert(!std::is_integral<Element>::value || RatioFactorOf<From, To>::exact.isInteger(),
+                          "Non-integral conversion factor for vector of integral values.");
+            return static_cast<Element>(RatioFactorOf<From, To>::value);
+        } else
+            return RatioFactorOf<From, To>::value;
+    }
+
 public:
     /**
      * @brief Performs value conversion.
@@ -1599,13 +2000,185 @@ public:
      * @param t Value to be converted.
      * @return value expressed in unit `To` if conversion between `From` and
      * `To` is possible, otherwise it results in compilation error.
+     *
+     * Values of vector types (see `VectorTraits`) are multiplied by the
+     * factor converted to their element type, which is broadcast to all
+     * elements.
      */
     template <typename T>
-    // constexpr has some weird requirements.
-    // As soon as GCC 5 is widespread this should go away.
-    static inline constexpr auto value(T t){
-        return checkConvertible<From,To>(),
-               t * RatioFactorOf<From, To>::value;
+    static inline constexpr auto value(T t) noexcept(noexcept(t * factor<T>())){
+        checkConvertible<From,To>();
+        if constexpr (RatioFactorOf<From, To>::identity)
+            return t;
+        else
+            return t * factor<T>();
+    }
+};
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Rounding policy of `ConvertIntegral` that rounds toward zero.
+ *
+ * Gives the same results as built-in conversion of floating point values to
+ * integers.
+ */
+class RoundTowardZero{
+public:
+    /**
+     * @brief Divides `num` by positive `den`, rounding toward zero.
+     */
+    template <typename I>
+    static inline constexpr I divide(I num, I den){
+        return num / den;
+    }
+
+    /**
+     * @brief Rounds floating point value toward zero.
+     */
+    template <typename F>
+    static inline F round(F f){
+        return std::trunc(f);
+    }
+};
+
+/**
+ * @brief Rounding policy of `ConvertIntegral` that rounds to the nearest
+ * integer, and halfway cases away from zero.
+ */
+class RoundToNearest{
+public:
+    /**
+     * @brief Divides `num` by positive `den`, rounding to the nearest integer.
+     */
+    template <typename I>
+    static inline constexpr I divide(I num, I den){
+        I result = num / den;
+        I rest = num % den;
+        if (rest < 0 ? -rest >= den + rest : rest >= den - rest)
+            result += num < 0 ? -1 : 1;
+        return result;
+    }
+
+    /**
+     * @brief Rounds floating point value to the nearest integer.
+     */
+    template <typename F>
+    static inline F round(F f){
+        return std::round(f);
+    }
+};
+
+/**
+ * @brief Rounding policy of `ConvertIntegral` that rounds toward negative
+ * infinity.
+ */
+class RoundDown{
+public:
+    /**
+     * @brief Divides `num` by positive `den`, rounding toward negative
+     * infinity.
+     */
+    template <typename I>
+    static inline constexpr I divide(I num, I den){
+        I result = num / den;
+        if (num % den < 0)
+            result -= 1;
+        return result;
+    }
+
+    /**
+     * @brief Rounds floating point value toward negative infinity.
+     */
+    template <typename F>
+    static inline F round(F f){
+        return std::floor(f);
+    }
+};
+
+/**
+ * @brief Template used to convert integral value expressed in one unit to
+ * integral value expressed in another.
+ *
+ * @tparam From Unit in which input value is expressed.
+ * @tparam To Unit in which result value is expressed.
+ * @tparam Rounding Rounding policy: `RoundTowardZero`, `RoundToNearest` or
+ * `RoundDown`.
+ *
+ * If ratio of factors of `From` and `To` is rational (see `RatioFactorOf`),
+ * value is multiplied by numerator and divided by denominator of the ratio
+ * using integer arithmetic only. Intermediate product is computed in
+ * `std::intmax_t` if it always fits, otherwise in a 128-bit integer, so it
+ * cannot overflow. If neither is wide enough, or if the ratio alone exceeds
+ * range of the target type, compilation error is generated. Overflow of the
+ * result itself depends on the converted value and is not checked, just like
+ * in regular integer arithmetic.
+ *
+ * Values of units with irrational ratios (ie. `PlaneDegree` to `Radian`)
+ * are converted using `Convert` and rounded according to `Rounding`. Such
+ * conversions use rounding functions of `<cmath>`, so they cannot be used in
+ * constant expressions; conversions of rational ratios can.
+ */
+template <typename From, typename To, typename Rounding = RoundTowardZero>
+class ConvertIntegral{
+private:
+    typedef RatioFactorOf<From, To> Ratio;
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 Wide;
+    static constexpr int wideDigits = 127;
+#else
+    typedef std::intmax_t Wide;
+    static constexpr int wideDigits = std::numeric_limits<std::intmax_t>::digits;
+#endif
+
+    static constexpr std::uintmax_t magnitude = Ratio::numerator < 0 ? -static_cast<std::uintmax_t>(Ratio::numerator)
+                                                                     : static_cast<std::uintmax_t>(Ratio::numerator);
+
+    // Checks if product of any value of type T and numerator of the ratio
+    // fits in a signed integer with given number of value bits.
+    template <typename T>
+    static constexpr bool productFits(int digits){
+        int spare = digits - std::numeric_limits<T>::digits;
+        return spare >= 0 && (spare >= 63 || magnitude <= (std::uintmax_t(1) << spare));
+    }
+
+    template <typename T>
+    using Intermediate = typename std::conditional<productFits<T>(std::numeric_limits<std::intmax_t>::digits), std::intmax_t, Wide>::type;
+
+    // Not constexpr, as rounding functions of <cmath> are not.
+    template <typename Target, typename T>
+    static inline Target irrationalValue(T t) noexcept{
+        return static_cast<Target>(Rounding::round(Convert<From, To>::value(t)));
+    }
+
+public:
+    /**
+     * @brief Performs value conversion.
+     *
+     * @tparam Target Integral type of the result.
+     * @tparam T Integral type of value to be converted.
+     * @param t Value to be converted.
+     * @return value expressed in unit `To`, rounded according to `Rounding`.
+     *
+     * Usable in constant expressions only if ratio of factors is rational.
+     */
+    template <typename Target, typename T>
+    static inline constexpr Target value(T t) noexcept{
+        static_assert(std::is_integral<Target>::value && std::is_integral<T>::value, "Integral conversion of non-integral types.");
+        checkConvertible<From,To>();
+        if constexpr (Ratio::identity)
+            return static_cast<Target>(t);
+        else if constexpr (!Ratio::rational)
+            return irrationalValue<Target>(t);
+        else {
+            static_assert(magnitude / Ratio::denominator <= static_cast<std::uintmax_t>(std::numeric_limits<Target>::max()),
+                          "Conversion factor exceeds range of the target type.");
+            static_assert(productFits<T>(wideDigits), "Conversion factor too large for integral conversion.");
+            typedef Intermediate<T> I;
+            return static_cast<Target>(Rounding::divide(static_cast<I>(t) * static_cast<I>(Ratio::numerator),
+                                                        static_cast<I>(Ratio::denominator)));
+        }
     }
 };
 
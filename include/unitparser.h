@@ -0,0 +1,669 @@
+#ifndef UNITPARSER_H
+#define UNITPARSER_H
+
+#include "dynamicquantity.h"
+#include "units/SI.h"
+#include "units/imperial.h"
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+/**
+ * @file unitparser.h
+ *
+ * Parser of unit expressions like `kg*m/s^2`, `km/h` or `µA` into
+ * `DynamicUnit`, and of quantities like `12.5 km` into `Quantity`.
+ */
+
+namespace LibUnit{
+
+/** @cond INTERNAL */
+
+namespace Helper{
+
+/**
+ * @brief Entry of unit symbol registry.
+ */
+class UnitSymbol{
+public:
+    std::string_view symbol;  //!< Symbol of the unit, UTF-8 encoded.
+    DynamicUnit unit;         //!< Unit represented by the symbol.
+    bool prefixable;          //!< True if symbol accepts SI prefixes.
+};
+
+/**
+ * @brief Entry of SI prefix table.
+ */
+class UnitPrefix{
+public:
+    std::string_view symbol;  //!< Symbol of the prefix, UTF-8 encoded.
+    int exponent;             //!< Power of ten represented by the prefix.
+};
+
+/**
+ * @brief Registry entry of unit `Unit`, using its symbol as written by
+ * `SymbolOf`, and accepting SI prefixes if the symbol does.
+ */
+template <typename Unit>
+constexpr UnitSymbol unitSymbol(){
+    return UnitSymbol{SymbolOf<Unit>::value, DynamicUnit::of<Unit>(), NamedSymbol<Unit>::prefixable};
+}
+
+/**
+ * @brief Registry entry of an alternative symbol of unit `Unit`, accepted by
+ * the parser but never written.
+ */
+template <typename Unit>
+constexpr UnitSymbol unitAlias(std::string_view symbol, bool prefixable = NamedSymbol<Unit>::prefixable){
+    return UnitSymbol{symbol, DynamicUnit::of<Unit>(), prefixable};
+}
+
+/**
+ * @brief Symbols of units defined in units/SI.h and units/imperial.h.
+ *
+ * Symbols are taken from units themselves, so every symbol written by
+ * `SymbolOf` of a registered unit is parsed back as that unit (checked by
+ * test/symbol-test.cpp). Aliases follow them: ASCII spellings, and symbols of
+ * units whose types are shared with other quantities, so that `SymbolOf`
+ * cannot give them.
+ */
+inline constexpr UnitSymbol unitSymbols[] = {
+    unitSymbol<Metre>(),
+    unitSymbol<Gram>(),
+    unitSymbol<Second>(),
+    unitSymbol<Ampere>(),
+    unitSymbol<Kelvin>(),
+    unitSymbol<Mole>(),
+    unitSymbol<Candela>(),
+
+    unitSymbol<Newton>(),
+    unitSymbol<Pascal>(),
+    unitSymbol<Joule>(),
+    unitSymbol<Watt>(),
+    unitSymbol<Coulomb>(),
+    unitSymbol<Volt>(),
+    unitSymbol<Farad>(),
+    unitSymbol<Ohm>(),
+    unitSymbol<Siemens>(),
+    unitSymbol<Weber>(),
+    unitSymbol<Tesla>(),
+    unitSymbol<Henry>(),
+    unitSymbol<Lux>(),
+    unitSymbol<Katal>(),
+
+    unitSymbol<Minute>(),
+    unitSymbol<Hour>(),
+    unitSymbol<Day>(),
+    unitSymbol<PlaneDegree>(),
+    unitSymbol<PlaneMinute>(),
+    unitSymbol<PlaneSecond>(),
+    unitSymbol<Hectare>(),
+    unitSymbol<Litre>(),
+    unitSymbol<Tonne>(),
+    unitSymbol<ElectronVolt>(),
+    unitSymbol<AtomicMass>(),
+    unitSymbol<AstronomicalUnit>(),
+    unitSymbol<Angstrom>(),
+    unitSymbol<Are>(),
+    unitSymbol<Barn>(),
+    unitSymbol<Bar>(),
+    unitSymbol<Atmosphere>(),
+    unitSymbol<MillimetreOfMercury>(),
+    unitSymbol<Torr>(),
+
+    unitSymbol<Imperial::Thou>(),
+    unitSymbol<Imperial::Inch>(),
+    unitSymbol<Imperial::Foot>(),
+    unitSymbol<Imperial::Yard>(),
+    unitSymbol<Imperial::Chain>(),
+    unitSymbol<Imperial::Furlong>(),
+    unitSymbol<Imperial::Mile>(),
+    unitSymbol<Imperial::League>(),
+    unitSymbol<Imperial::Fathom>(),
+    unitSymbol<Imperial::Cable>(),
+    unitSymbol<Imperial::NauticalMile>(),
+    unitSymbol<Imperial::Link>(),
+    unitSymbol<Imperial::Rod>(),
+    unitSymbol<Imperial::Perch>(),
+    unitSymbol<Imperial::Rood>(),
+    unitSymbol<Imperial::Acre>(),
+    unitSymbol<Imperial::FluidOunce>(),
+    unitSymbol<Imperial::Gill>(),
+    unitSymbol<Imperial::Pint>(),
+    unitSymbol<Imperial::Quart>(),
+    unitSymbol<Imperial::Gallon>(),
+    unitSymbol<Imperial::Grain>(),
+    unitSymbol<Imperial::Drachm>(),
+    unitSymbol<Imperial::Ounce>(),
+    unitSymbol<Imperial::Pound>(),
+    unitSymbol<Imperial::Stone>(),
+    unitSymbol<Imperial::Quarter>(),
+    unitSymbol<Imperial::ImperialHundredweight>(),
+    unitSymbol<Imperial::ImperialTon>(),
+
+    unitAlias<Radian>("rad", true),
+    unitAlias<Steradian>("sr", true),
+    unitAlias<Herz>("Hz", true),
+    unitAlias<Becquerel>("Bq", true),
+    unitAlias<Gray>("Gy", true),
+    unitAlias<Sievert>("Sv", true),
+    unitAlias<Lumen>("lm", true),
+    unitAlias<Ohm>("Ohm"),
+    unitAlias<PlaneDegree>("deg"),
+    unitAlias<PlaneMinute>("arcmin"),
+    unitAlias<PlaneSecond>("arcsec"),
+    unitAlias<Litre>("l"),
+    unitAlias<AtomicMass>("Da", true),
+    unitAlias<Imperial::FluidOunce>("floz"),
+};
+
+/**
+ * @brief SI prefixes. Longer prefixes go first, so that `da` is matched
+ * before `d`.
+ */
+inline constexpr UnitPrefix unitPrefixes[] = {
+    {"da", 1}, {"µ", -6}, {"μ", -6},
+    {"Y", 24}, {"Z", 21}, {"E", 18}, {"P", 15}, {"T", 12}, {"G", 9}, {"M", 6}, {"k", 3}, {"h", 2},
+    {"d", -1}, {"c", -2}, {"m", -3}, {"u", -6}, {"n", -9}, {"p", -12}, {"f", -15}, {"a", -18}, {"z", -21}, {"y", -24},
+};
+
+/**
+ * @brief FNV-1a hash of a symbol.
+ */
+constexpr std::uint64_t symbolHash(std::string_view s) noexcept{
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    for (char c: s){
+        h ^= std::uint8_t(c);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/**
+ * @brief Perfect hash table of unit symbols.
+ *
+ * Uses hash and displace scheme: symbols are assigned to buckets by their
+ * hash, and every bucket has a displacement chosen so that all symbols land
+ * in distinct slots. Table is built at compile time, so lookup costs one hash
+ * of the symbol and one string comparison, and needs no initialization.
+ */
+class UnitRegistry{
+public:
+    static constexpr int bucketCount = 64;
+    static constexpr int slotCount = 256;
+    static constexpr std::uint8_t empty = 0xff;
+    static constexpr int symbolCount = sizeof(unitSymbols) / sizeof(unitSymbols[0]);
+
+    static_assert(symbolCount < empty, "Too many unit symbols.");
+
+    std::array<std::uint32_t, bucketCount> displacements{};
+    std::array<std::uint8_t, slotCount> slots{};
+
+    static constexpr int slotOf(std::uint64_t hash, std::uint32_t displacement) noexcept{
+        std::uint64_t h = hash + displacement * 0x9e3779b97f4a7c15ull;
+        h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+        h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+        return (h ^ (h >> 31)) & (slotCount - 1);
+    }
+
+    constexpr UnitRegistry(){
+        for (auto& s: slots)
+            s = empty;
+
+        std::array<int, bucketCount> sizes{};
+        for (const UnitSymbol& u: unitSymbols)
+            sizes[symbolHash(u.symbol) % bucketCount]++;
+
+        // Buckets with more symbols are harder to place, so go first.
+        std::array<int, bucketCount> order{};
+        for (int i=0; i<bucketCount; i++)
+            order[i] = i;
+        for (int i=0; i<bucketCount; i++)
+            for (int j=i+1; j<bucketCount; j++)
+                if (sizes[order[j]] > sizes[order[i]])
+                    std::swap(order[i], order[j]);
+
+        for (int bucket: order){
+            if (sizes[bucket] == 0)
+                break;
+            for (std::uint32_t d=0;; d++){
+                if (d == 1000000)
+                    throw "Unable to build perfect hash of unit symbols.";
+                std::array<int, slotCount> taken{};
+                bool ok = true;
+                for (int i=0; i<symbolCount && ok; i++){
+                    std::uint64_t h = symbolHash(unitSymbols[i].symbol);
+                    if (int(h % bucketCount) != bucket)
+                        continue;
+                    int slot = slotOf(h, d);
+                    ok = slots[slot] == empty && !taken[slot];
+                    taken[slot] = 1;
+                }
+                if (!ok)
+                    continue;
+                displacements[bucket] = d;
+                for (int i=0; i<symbolCount; i++){
+                    std::uint64_t h = symbolHash(unitSymbols[i].symbol);
+                    if (int(h % bucketCount) == bucket)
+                        slots[slotOf(h, d)] = i;
+                }
+                break;
+            }
+        }
+    }
+
+    /**
+     * @brief Finds a symbol in the registry.
+     * @return pointer to registry entry, or `nullptr` if symbol is unknown.
+     */
+    constexpr const UnitSymbol* find(std::string_view symbol) const noexcept{
+        std::uint64_t h = symbolHash(symbol);
+        std::uint8_t index = slots[slotOf(h, displacements[h % bucketCount])];
+        if (index == empty || unitSymbols[index].symbol != symbol)
+            return nullptr;
+        return &unitSymbols[index];
+    }
+};
+
+inline constexpr UnitRegistry unitRegistry;
+
+/**
+ * @brief Recursive descent parser of unit expressions.
+ *
+ * Intermediate results are kept as `DimensionVector`, and checked after
+ * every operation, so exponents out of range of `DynamicDimension` are
+ * detected before they overflow. Nesting of parentheses is limited to
+ * `maxDepth`, so that recursion cannot exhaust the stack.
+ */
+class UnitParser{
+public:
+    static constexpr int maxDepth = 64;
+
+    const char* pos;
+    const char* last;
+    std::errc error = std::errc();
+    int depth = 0;
+
+    class Result{
+    public:
+        DimensionVector dimension;
+        double factor = 1;
+    };
+
+    constexpr UnitParser(const char* first, const char* l) noexcept
+        :pos(first), last(l)
+    {}
+
+    constexpr bool peek(std::string_view s) const noexcept{
+        return std::string_view(pos, last - pos).substr(0, s.size()) == s;
+    }
+
+    constexpr bool isSymbolChar() const noexcept{
+        if (pos == last)
+            return false;
+        char c = *pos;
+        if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+            return true;
+        return std::uint8_t(c) >= 0x80 && !peek("·") && !isSuperscript();
+    }
+
+    constexpr bool isSuperscript() const noexcept{
+        return peek("¹") || peek("²") || peek("³") || peek("⁻")
+            || (peek("\xe2\x81") && last - pos >= 3 && (std::uint8_t(pos[2]) == 0xb0 || (std::uint8_t(pos[2]) >= 0xb4 && std::uint8_t(pos[2]) <= 0xb9)));
+    }
+
+    constexpr bool parseSymbol(Result& result) noexcept{
+        const char* begin = pos;
+        while (isSymbolChar())
+            pos++;
+        std::string_view symbol(begin, pos - begin);
+        if (symbol.empty()){
+            error = std::errc::invalid_argument;
+            return false;
+        }
+        // Symbols of two words, like `fl oz`, go before their first word.
+        if (pos != last && *pos == ' '){
+            const char* end = pos++;
+            while (isSymbolChar())
+                pos++;
+            if (const UnitSymbol* u = pos - end > 1 ? unitRegistry.find(std::string_view(begin, pos - begin)) : nullptr){
+                result.dimension = u->unit.dimension.vector();
+                result.factor = u->unit.factor;
+                return true;
+            }
+            pos = end;
+        }
+        if (const UnitSymbol* u = unitRegistry.find(symbol)){
+            result.dimension = u->unit.dimension.vector();
+            result.factor = u->unit.factor;
+            return true;
+        }
+        for (const UnitPrefix& p: unitPrefixes){
+            if (symbol.size() <= p.symbol.size() || symbol.substr(0, p.symbol.size()) != p.symbol)
+                continue;
+            const UnitSymbol* u = unitRegistry.find(symbol.substr(p.symbol.size()));
+            if (!u || !u->prefixable)
+                continue;
+            result.dimension = u->unit.dimension.vector();
+            result.factor = u->unit.factor * ExactFactor::decimal(1, p.exponent).as<double>();
+            return true;
+        }
+        pos = begin;
+        error = std::errc::invalid_argument;
+        return false;
+    }
+
+    // Checks if exponents fit `DynamicDimension`; sets error otherwise.
+    constexpr bool checkRange(const Result& result) noexcept{
+        for (int e: result.dimension.exponents)
+            if (e < -128 || e > 127){
+                error = std::errc::result_out_of_range;
+                return false;
+            }
+        return true;
+    }
+
+    constexpr bool parsePrimary(Result& result) noexcept{
+        if (pos != last && *pos == '('){
+            if (depth == maxDepth){
+                error = std::errc::result_out_of_range;
+                return false;
+            }
+            const char* begin = pos++;
+            depth++;
+            bool parsed = parseExpression(result);
+            depth--;
+            if (!parsed)
+                return false;
+            if (pos == last || *pos != ')'){
+                pos = begin;
+                error = std::errc::invalid_argument;
+                return false;
+            }
+            pos++;
+            return true;
+        }
+        if (pos != last && *pos == '1'){
+            pos++;
+            result = Result();
+            return true;
+        }
+        return parseSymbol(result);
+    }
+
+    // Parses optional exponent, either as `^n` or as superscript digits.
+    constexpr bool parseExponent(int& exponent) noexcept{
+        exponent = 1;
+        if (pos != last && *pos == '^'){
+            const char* begin = pos++;
+            bool negative = pos != last && *pos == '-';
+            if (pos != last && (*pos == '-' || *pos == '+'))
+                pos++;
+            if (pos == last || *pos < '0' || *pos > '9'){
+                pos = begin;
+                return true;
+            }
+            int value = 0;
+            while (pos != last && *pos >= '0' && *pos <= '9'){
+                value = value * 10 + (*pos++ - '0');
+                if (value > 127){
+                    error = std::errc::result_out_of_range;
+                    return false;
+                }
+            }
+            exponent = negative ? -value : value;
+            return true;
+        }
+        if (!isSuperscript())
+            return true;
+        bool negative = false;
+        if (peek("⁻")){
+            negative = true;
+            pos += 3;
+        }
+        int value = 0;
+        bool digits = false;
+        for (;; digits = true){
+            int digit;
+            if (peek("¹"))
+                digit = 1;
+            else if (peek("²"))
+                digit = 2;
+            else if (peek("³"))
+                digit = 3;
+            else if (isSuperscript() && !peek("⁻"))
+                digit = std::uint8_t(pos[2]) - 0xb0;
+            else
+                break;
+            pos += digit >= 1 && digit <= 3 ? 2 : 3;
+            value = value * 10 + digit;
+            if (value > 127){
+                error = std::errc::result_out_of_range;
+                return false;
+            }
+        }
+        if (!digits){
+            error = std::errc::invalid_argument;
+            return false;
+        }
+        exponent = negative ? -value : value;
+        return true;
+    }
+
+    constexpr bool parseFactor(Result& result) noexcept{
+        int exponent;
+        // Exponents of primary and `exponent` are at most 128 in magnitude,
+        // so their products do not overflow.
+        if (!parsePrimary(result) || !parseExponent(exponent))
+            return false;
+        result.dimension = result.dimension * exponent;
+        if (!checkRange(result))
+            return false;
+        double base = result.factor;
+        result.factor = 1;
+        for (int i=0; i<(exponent < 0 ? -exponent : exponent); i++)
+            result.factor *= base;
+        if (exponent < 0)
+            result.factor = 1 / result.factor;
+        return true;
+    }
+
+    constexpr bool parseExpression(Result& result) noexcept{
+        if (!parseFactor(result))
+            return false;
+        for (;;){
+            const char* op = pos;
+            bool divide;
+            if (pos != last && (*pos == '*' || *pos == '.'))
+                pos++, divide = false;
+            else if (pos != last && *pos == '/')
+                pos++, divide = true;
+            else if (peek("·"))
+                pos += 2, divide = false;
+            else
+                return true;
+
+            Result next;
+            if (!parseFactor(next)){
+                if (error == std::errc::result_out_of_range)
+                    return false;
+                // Operator not followed by a unit is not part of the expression.
+                pos = op;
+                error = std::errc();
+                return true;
+            }
+            if (divide){
+                result.dimension = result.dimension - next.dimension;
+                result.factor /= next.factor;
+            } else {
+                result.dimension = result.dimension + next.dimension;
+                result.factor *= next.factor;
+            }
+            if (!checkRange(result))
+                return false;
+        }
+    }
+};
+
+}
+
+/** @endcond */
+
+/**
+ * @brief Parses unit expression into a `DynamicUnit`.
+ *
+ * @param first Beginning of parsed characters.
+ * @param last End of parsed characters.
+ * @param unit Parsed unit; modified only on success.
+ * @return Pointer to the first character not matching the pattern and
+ * error code, like `std::from_chars`.
+ *
+ * Unit expression consists of unit symbols joined with `*`, `.` or `·` for
+ * multiplication and `/` for division. Symbols can be raised to integral
+ * powers using `^n` or superscript digits, and grouped with parentheses.
+ * `1` denotes dimensionless unit. Examples: `kg*m/s^2`, `km/h`, `µA`,
+ * `m·s⁻²`, `1/(mol*K)`.
+ *
+ * Symbols are resolved using a registry of units defined in units/SI.h and
+ * units/imperial.h. SI units accept SI prefixes. Registry uses a perfect hash
+ * built at compile time, so parsing does no allocation or locking. Parsing
+ * stops at the first character that is not part of the expression.
+ *
+ * On failure `ptr` equals `first`; `ec` is `std::errc::invalid_argument` if
+ * expression contains an unknown symbol, and `std::errc::result_out_of_range`
+ * if exponents of the result or of any intermediate result do not fit
+ * `DynamicDimension`, or parentheses are nested deeper than 64 levels.
+ */
+constexpr std::from_chars_result parseUnit(const char* first, const char* last, DynamicUnit& unit) noexcept{
+    Helper::UnitParser parser(first, last);
+    Helper::UnitParser::Result result;
+    if (!parser.parseExpression(result))
+        return {first, parser.error == std::errc() ? std::errc::invalid_argument : parser.error};
+    unit = DynamicUnit(result.dimension, result.factor);
+    return {parser.pos, std::errc()};
+}
+
+/**
+ * @brief Parses unit expression into a `DynamicUnit`.
+ *
+ * Convenience overload of `parseUnit()` for string views.
+ */
+constexpr std::from_chars_result parseUnit(std::string_view s, DynamicUnit& unit) noexcept{
+    return parseUnit(s.data(), s.data() + s.size(), unit);
+}
+
+//------------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Parses quantity written as a value followed by a unit expression.
+ *
+ * @tparam Rounding Rounding policy used if underlying type is integral:
+ * `RoundTowardZero`, `RoundToNearest` or `RoundDown`.
+ * @param first Beginning of parsed characters.
+ * @param last End of parsed characters.
+ * @param q Parsed quantity; modified only on success.
+ * @return Pointer to the first character not matching the pattern and
+ * error code, like `std::from_chars`.
+ *
+ * Value is parsed using `std::from_chars`, so it does not depend on locale.
+ * Value can be followed by spaces or tabs and a unit expression, as accepted
+ * by `parseUnit()`: `12.5 km`, `300ms`, `4.2e3 Pa`. Parsed value is converted
+ * to unit of `q` using factors of both units; if they are the same, value is
+ * stored unchanged. Value without a unit is stored unchanged if `q` is
+ * dimensionless (ie. `90` read as `PlaneDegree` is 90°), and is not
+ * convertible otherwise. Nothing is allocated.
+ *
+ * Integral values written without fraction or exponent, in unit of `q`, are
+ * parsed exactly. Other values are parsed as `double`, converted and rounded
+ * according to `Rounding`.
+ *
+ * On failure `q` is left unchanged:
+ *  - if no value is found, or value is followed by a word that is not a unit
+ *    expression (ie. `5 apples`), `ptr` equals `first` and `ec` is
+ *    `std::errc::invalid_argument`;
+ *  - if unit is not convertible to unit of `q`, `ptr` points past the unit and
+ *    `ec` is `std::errc::argument_out_of_domain`;
+ *  - if value does not fit underlying type, or does not fit `double` before
+ *    conversion (ie. `1e999 m`), `ptr` points past the unit and `ec` is
+ *    `std::errc::result_out_of_range`.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~{.cpp}
+ * Quantity<Metre, double> d;
+ * fromChars(s.data(), s.data() + s.size(), d); // "12.5 km" gives 12500 m
+ * ~~~~~~~~~~~~~~~~~~~~
+ */
+template <typename Rounding = RoundTowardZero, typename Unit, typename T>
+inline std::from_chars_result fromChars(const char* first, const char* last, Quantity<Unit, T>& q) noexcept{
+    static_assert(std::is_arithmetic<T>::value, "Only quantities of arithmetic types can be parsed.");
+    constexpr DynamicUnit target = DynamicUnit::of<Unit>();
+
+    typedef typename std::conditional<std::is_floating_point<T>::value, T, double>::type Parsed;
+    T integral = T();
+    Parsed value = Parsed();
+    bool exact = false;
+    std::from_chars_result result;
+    if constexpr (std::is_integral<T>::value){
+        result = std::from_chars(first, last, integral);
+        exact = result.ec == std::errc()
+                && (result.ptr == last || (*result.ptr != '.' && *result.ptr != 'e' && *result.ptr != 'E'));
+        if (result.ec != std::errc() || !exact)
+            result = std::from_chars(first, last, value);
+    } else
+        result = std::from_chars(first, last, value);
+    bool overflow = result.ec == std::errc::result_out_of_range;
+    if (result.ec != std::errc() && !overflow)
+        return result;
+
+    const char* pos = result.ptr;
+    while (pos != last && (*pos == ' ' || *pos == '\t'))
+        pos++;
+    DynamicUnit unit = target;
+    std::from_chars_result u = parseUnit(pos, last, unit);
+    if (u.ec == std::errc())
+        result.ptr = u.ptr;
+    else if (u.ec != std::errc::invalid_argument)
+        return u;
+    else if (pos != last && (*pos == '(' || (*pos >= 'a' && *pos <= 'z') || (*pos >= 'A' && *pos <= 'Z') || std::uint8_t(*pos) >= 0x80))
+        return {first, std::errc::invalid_argument};
+    else if (target.dimension != DynamicDimension())
+        unit = DynamicUnit();
+
+    if (unit.dimension != target.dimension)
+        return {result.ptr, std::errc::argument_out_of_domain};
+    if (overflow)
+        return {result.ptr, std::errc::result_out_of_range};
+
+    if constexpr (std::is_integral<T>::value){
+        if (exact && unit.factor == target.factor){
+            q = Quantity<Unit, T>(integral);
+            return result;
+        }
+        if (exact)
+            value = static_cast<double>(integral);
+        double converted = Rounding::round(unit.factor == target.factor ? value : value * unit.ratioTo(target));
+        constexpr double lowest = static_cast<double>(std::numeric_limits<T>::min());
+        constexpr double limit = static_cast<double>(std::numeric_limits<T>::max() / 2 + 1) * 2;
+        if (!(converted >= lowest && converted < limit))
+            return {result.ptr, std::errc::result_out_of_range};
+        q = Quantity<Unit, T>(static_cast<T>(converted));
+    } else
+        q = Quantity<Unit, T>(unit.factor == target.factor ? value : static_cast<T>(value * unit.ratioTo(target)));
+    return result;
+}
+
+/**
+ * @brief Parses quantity written as a value followed by a unit expression.
+ *
+ * Convenience overload of `fromChars()` for string views.
+ */
+template <typename Rounding = RoundTowardZero, typename Unit, typename T>
+inline std::from_chars_result fromChars(std::string_view s, Quantity<Unit, T>& q) noexcept{
+    return fromChars<Rounding>(s.data(), s.data() + s.size(), q);
+}
+
+}
+
+#endif // UNITPARSER_H
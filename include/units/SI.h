@@ -3,6 +3,7 @@
 
 #include <cmath>
 #include "../quantity.h"
+#include "../symbol.h"
 
 namespace LibUnit{
 
@@ -48,7 +49,7 @@ namespace LibUnit{
 template <int f>
 class IntFactor{
 public:
-    static constexpr double factor = f;
+    static constexpr ExactFactor factor = f;
     typedef Compound<> Dimension;
 };
 
@@ -206,6 +207,18 @@ public:
 //    typedef Candela DefaultUnit;
 };
 
+/** @cond DOXYGEN_EXCLUDE */
+
+template <> class BaseDimensionIndex<Length>{ public: static constexpr int value = 0; };
+template <> class BaseDimensionIndex<Mass>{ public: static constexpr int value = 1; };
+template <> class BaseDimensionIndex<Time>{ public: static constexpr int value = 2; };
+template <> class BaseDimensionIndex<ElectricCurrent>{ public: static constexpr int value = 3; };
+template <> class BaseDimensionIndex<ThermodynamicTemperature>{ public: static constexpr int value = 4; };
+template <> class BaseDimensionIndex<SubstanceAmount>{ public: static constexpr int value = 5; };
+template <> class BaseDimensionIndex<LuminousIntensity>{ public: static constexpr int value = 6; };
+
+/** @endcond */
+
 // ----------------------------------------------------------------------------------------------------------------------
 // Base SI units
 
@@ -215,6 +228,8 @@ class Metre{
 public:
     typedef Length Dimension; //!< Dimension of this unit
     static constexpr unsigned int factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "m"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /**
@@ -229,6 +244,8 @@ class Gram{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "g"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /** @brief Second unit.
@@ -237,6 +254,8 @@ class Second{
 public:
     typedef Time Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "s"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /** @brief Ampere unit.
@@ -245,6 +264,8 @@ class Ampere{
 public:
     typedef ElectricCurrent Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "A"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /** @brief Kelvin unit.
@@ -253,6 +274,8 @@ class Kelvin{
 public:
     typedef ThermodynamicTemperature Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "K"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /** @brief Mole unit.
@@ -261,6 +284,8 @@ class Mole{
 public:
     typedef SubstanceAmount Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "mol"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 /** @brief Candela unit.
@@ -269,6 +294,8 @@ class Candela{
 public:
     typedef LuminousIntensity Dimension; //!< Dimension of this unit
     static constexpr unsigned int  factor = 1; //!< factor equals 1 for default units
+    static constexpr char symbol[] = "cd"; //!< Symbol of this unit
+    static constexpr bool prefixable = true; //!< Symbol accepts SI prefixes
 };
 
 // ----------------------------------------------------------------------------------------------------------------------
@@ -327,7 +354,8 @@ using Day =            Join< IntFactor<24>,                   Hour>;
 class PlaneDegree{
 public:
     typedef Compound<> Dimension;
-    static constexpr double factor = M_PI / 180;
+    static constexpr ExactFactor factor = ExactFactor(1, 180, 0, 1);
+    static constexpr char symbol[] = "°";
 };
 
 using PlaneMinute =    Join< Power<IntFactor<60>, -1>,        PlaneDegree>;
@@ -339,13 +367,16 @@ using Tonne =          Join< Power<IntFactor<10>, 6>,         Gram>;
 class ElectronVolt{
 public:
     typedef DimensionOf<Joule> Dimension;
-    static constexpr double factor = 1.60217653e-19*FactorOf<Joule>::value;
+    static constexpr ExactFactor factor = ExactFactor::decimal(160217653, -27)*FactorOf<Joule>::value;
+    static constexpr char symbol[] = "eV";
+    static constexpr bool prefixable = true;
 };
 
 class AtomicMass{
 public:
     typedef Mass Dimension;
-    static constexpr double factor = 1.660538921e-24; //!< factor equals 1.660538921e-27 kg
+    static constexpr ExactFactor factor = ExactFactor::decimal(1660538921, -33); //!< factor equals 1.660538921e-27 kg
+    static constexpr char symbol[] = "u"; //!< Symbol of this unit
 
 };
 
@@ -353,6 +384,7 @@ class AstronomicalUnit{
 public:
     typedef Length Dimension;
     static constexpr unsigned long long factor = 149597870692;
+    static constexpr char symbol[] = "au";
 };
 
 
@@ -367,21 +399,60 @@ using Bar =            Join< Power<IntFactor<10>, 5>,          Pascal>;
 class Atmosphere{
 public:
     typedef DimensionOf<Pascal> Dimension;
-    static constexpr auto factor = 101325*FactorOf<Pascal>::value;
+    static constexpr ExactFactor factor = 101325*FactorOf<Pascal>::value;
+    static constexpr char symbol[] = "atm";
 };
 
 class MillimetreOfMercury{
 public:
     typedef DimensionOf<Pascal> Dimension;
-    static constexpr auto factor = 133.322387415*FactorOf<Pascal>::value;
+    static constexpr ExactFactor factor = ExactFactor::decimal(133322387415, -9)*FactorOf<Pascal>::value;
+    static constexpr char symbol[] = "mmHg";
 };
 
 class Torr{
 public:
     typedef DimensionOf<Pascal> Dimension;
-    static constexpr auto factor = 133.322368421*FactorOf<Pascal>::value;
+    static constexpr ExactFactor factor = ExactFactor(101325, 760)*FactorOf<Pascal>::value;
+    static constexpr char symbol[] = "Torr";
 };
 
+// -----------------------------------------------------------------------------------------------------------------------
+// Symbols of units that cannot be derived from their members.
+// Herz, Gray and Lumen are not given symbols: they share types with other
+// quantities (ie. angular velocity or squared speed), which would be
+// written using them.
+
+/** @cond DOXYGEN_EXCLUDE */
+template <> class SymbolOf<Newton>{ public: static constexpr std::string_view value = "N"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Pascal>{ public: static constexpr std::string_view value = "Pa"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Joule>{ public: static constexpr std::string_view value = "J"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Watt>{ public: static constexpr std::string_view value = "W"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Coulomb>{ public: static constexpr std::string_view value = "C"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Volt>{ public: static constexpr std::string_view value = "V"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Farad>{ public: static constexpr std::string_view value = "F"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Ohm>{ public: static constexpr std::string_view value = "Ω"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Siemens>{ public: static constexpr std::string_view value = "S"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Weber>{ public: static constexpr std::string_view value = "Wb"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Tesla>{ public: static constexpr std::string_view value = "T"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Henry>{ public: static constexpr std::string_view value = "H"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Lux>{ public: static constexpr std::string_view value = "lx"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Katal>{ public: static constexpr std::string_view value = "kat"; static constexpr bool prefixable = true; };
+
+template <> class SymbolOf<Minute>{ public: static constexpr std::string_view value = "min"; };
+template <> class SymbolOf<Hour>{ public: static constexpr std::string_view value = "h"; };
+template <> class SymbolOf<Day>{ public: static constexpr std::string_view value = "d"; };
+template <> class SymbolOf<PlaneMinute>{ public: static constexpr std::string_view value = "′"; };
+template <> class SymbolOf<PlaneSecond>{ public: static constexpr std::string_view value = "″"; };
+template <> class SymbolOf<Hectare>{ public: static constexpr std::string_view value = "ha"; };
+template <> class SymbolOf<Litre>{ public: static constexpr std::string_view value = "L"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Tonne>{ public: static constexpr std::string_view value = "t"; };
+template <> class SymbolOf<Angstrom>{ public: static constexpr std::string_view value = "Å"; };
+template <> class SymbolOf<Are>{ public: static constexpr std::string_view value = "a"; };
+template <> class SymbolOf<Barn>{ public: static constexpr std::string_view value = "b"; static constexpr bool prefixable = true; };
+template <> class SymbolOf<Bar>{ public: static constexpr std::string_view value = "bar"; static constexpr bool prefixable = true; };
+/** @endcond */
+
 // -----------------------------------------------------------------------------------------------------------------------
 
 /** @cond INTERNAL */
@@ -398,37 +469,37 @@ public:
     /**
      * @brief OneType default constructor.
      */
-    inline OneType(){}
+    inline constexpr OneType() noexcept{}
 
     /**
      * @brief OneType constructs from anything.
      */
     template <typename T>
-    inline OneType(const T&){}
+    inline constexpr OneType(const T&) noexcept{}
 
     /**
      * @brief Converts to anything.
      */
     template <typename T>
-    inline operator T() const{
+    inline constexpr operator T() const noexcept{
         return 1;
     }
 };
 
 /** @brief Helper operator. */
 template <typename T>
-inline T operator*(T t, OneType){
+inline constexpr T operator*(T t, OneType) noexcept(noexcept(T(t))){
     return t;
 }
 
 /** @brief Helper operator. */
 template <typename T>
-inline T operator*(OneType, T t){
+inline constexpr T operator*(OneType, T t) noexcept(noexcept(T(t))){
     return t;
 }
 
 /** @brief Helper operator. */
-inline int operator*(OneType, OneType){
+inline constexpr int operator*(OneType, OneType) noexcept{
     return 1;
 }
 
@@ -437,62 +508,62 @@ inline int operator*(OneType, OneType){
 /** @endcond */
 
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Metre, Helper::OneType>       metre;
+inline constexpr Quantity<Metre, Helper::OneType>       metre;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Gram, Helper::OneType>        gram;
+inline constexpr Quantity<Gram, Helper::OneType>        gram;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Second, Helper::OneType>      second;
+inline constexpr Quantity<Second, Helper::OneType>      second;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Ampere, Helper::OneType>      ampere;
+inline constexpr Quantity<Ampere, Helper::OneType>      ampere;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Kelvin, Helper::OneType>      kelvin;
+inline constexpr Quantity<Kelvin, Helper::OneType>      kelvin;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Mole, Helper::OneType>        mole;
+inline constexpr Quantity<Mole, Helper::OneType>        mole;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Candela, Helper::OneType>     candela;
+inline constexpr Quantity<Candela, Helper::OneType>     candela;
 
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Radian, Helper::OneType>      radian;
+inline constexpr Quantity<Radian, Helper::OneType>      radian;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Steradian, Helper::OneType>   steradian;
+inline constexpr Quantity<Steradian, Helper::OneType>   steradian;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Herz, Helper::OneType>        herz;
+inline constexpr Quantity<Herz, Helper::OneType>        herz;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Newton, Helper::OneType>      newton;
+inline constexpr Quantity<Newton, Helper::OneType>      newton;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Pascal, Helper::OneType>      pascal;
+inline constexpr Quantity<Pascal, Helper::OneType>      pascal;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Joule, Helper::OneType>       joule;
+inline constexpr Quantity<Joule, Helper::OneType>       joule;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Watt, Helper::OneType>        watt;
+inline constexpr Quantity<Watt, Helper::OneType>        watt;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Coulomb, Helper::OneType>     coulomb;
+inline constexpr Quantity<Coulomb, Helper::OneType>     coulomb;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Volt, Helper::OneType>        volt;
+inline constexpr Quantity<Volt, Helper::OneType>        volt;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Farad, Helper::OneType>       farad;
+inline constexpr Quantity<Farad, Helper::OneType>       farad;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Ohm, Helper::OneType>         ohm;
+inline constexpr Quantity<Ohm, Helper::OneType>         ohm;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Siemens, Helper::OneType>     siemens;
+inline constexpr Quantity<Siemens, Helper::OneType>     siemens;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Weber, Helper::OneType>       weber;
+inline constexpr Quantity<Weber, Helper::OneType>       weber;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Tesla, Helper::OneType>       tesla;
+inline constexpr Quantity<Tesla, Helper::OneType>       tesla;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Henry, Helper::OneType>       henry;
+inline constexpr Quantity<Henry, Helper::OneType>       henry;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Lumen, Helper::OneType>       lumen;
+inline constexpr Quantity<Lumen, Helper::OneType>       lumen;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Lux, Helper::OneType>         lux;
+inline constexpr Quantity<Lux, Helper::OneType>         lux;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Becquerel, Helper::OneType>   becquerel;
+inline constexpr Quantity<Becquerel, Helper::OneType>   becquerel;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Gray, Helper::OneType>        gray;
+inline constexpr Quantity<Gray, Helper::OneType>        gray;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Sievert, Helper::OneType>     sievert;
+inline constexpr Quantity<Sievert, Helper::OneType>     sievert;
 /** @brief Helper variable used for inline unit composition. */
-Quantity<Katal, Helper::OneType>       katal;
+inline constexpr Quantity<Katal, Helper::OneType>       katal;
 
 /** }@ */
 
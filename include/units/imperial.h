@@ -34,99 +34,105 @@ namespace Imperial{
 /** @brief Imperial thou unit.*/
 class Thou{
 public:
-    typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.0000254; //!< factor
+    typedef Length Dimension; //!< Dimension of this unit
+    static constexpr ExactFactor factor = ExactFactor::decimal(254, -7); //!< factor
+    static constexpr char symbol[] = "th"; //!< Symbol of this unit
 };
 
 /** @brief Imperial inch unit.*/
 class Inch{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.0254; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(254, -4); //!< factor
+    static constexpr char symbol[] = "in"; //!< Symbol of this unit
 };
 
 /** @brief Imperial foot unit.*/
 class Foot{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.3048; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(3048, -4); //!< factor
+    static constexpr char symbol[] = "ft"; //!< Symbol of this unit
 };
 
 /** @brief Imperial yard unit.*/
 class Yard{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.9144; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(9144, -4); //!< factor
+    static constexpr char symbol[] = "yd"; //!< Symbol of this unit
 };
 
 /** @brief Imperial chain unit.*/
 class Chain{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 20.1168; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(201168, -4); //!< factor
+    static constexpr char symbol[] = "ch"; //!< Symbol of this unit
 };
 
 /** @brief Imperial furlong unit.*/
 class Furlong{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 201.168; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(201168, -3); //!< factor
+    static constexpr char symbol[] = "fur"; //!< Symbol of this unit
 };
 
 /** @brief Imperial mile unit.*/
 class Mile{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1609.344; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(1609344, -3); //!< factor
+    static constexpr char symbol[] = "mi"; //!< Symbol of this unit
 };
 
 /** @brief Imperial league unit.*/
 class League{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 4828.032; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(4828032, -3); //!< factor
+    static constexpr char symbol[] = "lea"; //!< Symbol of this unit
 };
 
 /** @brief Imperial fathom unit.*/
 class Fathom{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1.82880; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(18288, -4); //!< factor
+    static constexpr char symbol[] = "ftm"; //!< Symbol of this unit
 };
 
 /** @brief Imperial cable unit.*/
 class Cable{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 185.3184; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(1853184, -4); //!< factor
+    static constexpr char symbol[] = "cable"; //!< Symbol of this unit
 };
 
 /** @brief Imperial nautical mile unit.*/
 class NauticalMile{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1853.184; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(1853184, -3); //!< factor
+    static constexpr char symbol[] = "nmi"; //!< Symbol of this unit
 };
 
 /** @brief Imperial link unit.*/
 class Link{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.201168; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(201168, -6); //!< factor
+    static constexpr char symbol[] = "li"; //!< Symbol of this unit
 };
 
 /** @brief Imperial rod unit.*/
 class Rod{
 public:
     typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 5.0292; //!< factor
-};
-
-/** @brief Imperial chain unit.*/
-class Chain{
-public:
-    typedef Length Dimension; //!< Dimension of this unit
-    static constexpr double factor = 20.1168; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(50292, -4); //!< factor
+    static constexpr char symbol[] = "rd"; //!< Symbol of this unit
 };
 
 //----------------------------------------------------------------------------
@@ -142,35 +148,40 @@ using Acre = Compound<Furlong, Chain>;
 class FluidOunce{
 public:
     typedef DimensionOf<Litre> Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.0284130625*FactorOf<Litre>::value; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(284130625, -10)*FactorOf<Litre>::value; //!< factor
+    static constexpr char symbol[] = "fl oz"; //!< Symbol of this unit
 };
 
 /** @brief Imperial gill (gi) unit.*/
 class Gill{
 public:
     typedef DimensionOf<Litre> Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.1420653125*FactorOf<Litre>::value; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(1420653125, -10)*FactorOf<Litre>::value; //!< factor
+    static constexpr char symbol[] = "gi"; //!< Symbol of this unit
 };
 
 /** @brief Imperial pint (pt) unit.*/
 class Pint{
 public:
     typedef DimensionOf<Litre> Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.56826125*FactorOf<Litre>::value; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(56826125, -8)*FactorOf<Litre>::value; //!< factor
+    static constexpr char symbol[] = "pt"; //!< Symbol of this unit
 };
 
 /** @brief Imperial quart (qt) unit.*/
 class Quart{
 public:
     typedef DimensionOf<Litre> Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1.1365225*FactorOf<Litre>::value; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(11365225, -7)*FactorOf<Litre>::value; //!< factor
+    static constexpr char symbol[] = "qt"; //!< Symbol of this unit
 };
 
 /** @brief Imperial gallon (qt) unit.*/
 class Gallon{
 public:
     typedef DimensionOf<Litre> Dimension; //!< Dimension of this unit
-    static constexpr double factor = 4.54609*FactorOf<Litre>::value; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(454609, -5)*FactorOf<Litre>::value; //!< factor
+    static constexpr char symbol[] = "gal"; //!< Symbol of this unit
 };
 
 // ToDo: for now skipping British apothecaries' volume units - who uses those anyway?
@@ -182,60 +193,77 @@ public:
 class Grain{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 0.06479891; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(6479891, -8); //!< factor
+    static constexpr char symbol[] = "gr"; //!< Symbol of this unit
 };
 
 /** @brief Imperial drachm unit.*/
 class Drachm{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1.7718451953125; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(17718451953125, -13); //!< factor
+    static constexpr char symbol[] = "dr"; //!< Symbol of this unit
 };
 
 /** @brief Imperial ounce unit.*/
 class Ounce{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 28.349523125; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(28349523125, -9); //!< factor
+    static constexpr char symbol[] = "oz"; //!< Symbol of this unit
 };
 
 /** @brief Imperial pound unit.*/
 class Pound{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 453.59237; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(45359237, -5); //!< factor
+    static constexpr char symbol[] = "lb"; //!< Symbol of this unit
 };
 
 /** @brief Imperial stone unit.*/
 class Stone{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 6350.29318; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(635029318, -5); //!< factor
+    static constexpr char symbol[] = "st"; //!< Symbol of this unit
 };
 
 /** @brief Imperial quarter unit.*/
 class Quarter{
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 12700.58636; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(1270058636, -5); //!< factor
+    static constexpr char symbol[] = "qr"; //!< Symbol of this unit
 };
 
 /** @brief Imperial imperial hundredweight unit.*/
 class ImperialHundredweight {
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 50802.34544; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(5080234544, -5); //!< factor
+    static constexpr char symbol[] = "cwt"; //!< Symbol of this unit
 };
 
 /** @brief Imperial hundredweight unit.*/
 class ImperialTon {
 public:
     typedef Mass Dimension; //!< Dimension of this unit
-    static constexpr double factor = 1016046.9088; //!< factor
+    static constexpr ExactFactor factor = ExactFactor::decimal(10160469088, -4); //!< factor
+    static constexpr char symbol[] = "ton"; //!< Symbol of this unit
 };
 
 }
 
+//----------------------------------------------------------------------------
+// Symbols of units that are not written in their simplified form.
+
+/** @cond DOXYGEN_EXCLUDE */
+template <> class SymbolOf<Imperial::Perch>{ public: static constexpr std::string_view value = "perch"; };
+template <> class SymbolOf<Imperial::Rood>{ public: static constexpr std::string_view value = "rood"; };
+template <> class SymbolOf<Imperial::Acre>{ public: static constexpr std::string_view value = "ac"; };
+/** @endcond */
+
 }
 
 /** }@ */
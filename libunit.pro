@@ -7,7 +7,7 @@
 QT       -= core gui
 #CONFIG   += c++11
 
-QMAKE_CXXFLAGS += -std=c++1y
+QMAKE_CXXFLAGS += -std=c++20
 
 TARGET = unit
 TEMPLATE = lib
@@ -21,7 +21,22 @@ HEADERS += \
     include/unitmanip.h \
     include/cmath.h \
     include/units/SI.h \
-    include/units/imperial.h
+    include/units/imperial.h \
+    include/dynamicquantity.h \
+    include/unitparser.h \
+    include/conversioncache.h \
+    include/symbol.h \
+    include/quantityvector.h \
+    include/quantityexpression.h \
+    include/simd.h \
+    include/quantityalgorithm.h \
+    include/accumulator.h \
+    include/atomicquantity.h \
+    include/metrics.h \
+    include/quantityfile.h \
+    include/quantityencoding.h \
+    include/quantityring.h \
+    include/quantitycsv.h
 
 unix {
     target.path = /usr/lib
@@ -0,0 +1,171 @@
+/**
+ * @file accumulator-test.cpp
+ *
+ * Checks that accumulators return exact sums of values on which repeated
+ * `operator+=` loses precision, both for quantities added one at a time and
+ * for whole arrays, and that added quantities are converted to unit of the
+ * sum. Also checks that `MultiUnitSum` keeps quantities of each unit in its
+ * own lane and converts them only when they are read or merged.
+ */
+
+#include "accumulator.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Large values cancelling each other around small ones; naive sum is 0.
+QuantityVector<Metre, double> cancelling(){
+    QuantityVector<Metre, double> v;
+    for (int i=0; i<3; i++){
+        v.push_back(Quantity<Metre, double>(1.0));
+        v.push_back(Quantity<Metre, double>(1e100));
+        v.push_back(Quantity<Metre, double>(1.0));
+        v.push_back(Quantity<Metre, double>(-1e100));
+    }
+    return v;
+}
+
+// Opposite large values in different lanes, followed by ones; naive sum is
+// missing most of the ones.
+QuantityVector<Metre, double> laneCancelling(){
+    QuantityVector<Metre, double> v;
+    v.push_back(Quantity<Metre, double>(1e16));
+    v.push_back(Quantity<Metre, double>(-1e16));
+    for (std::size_t i=0; i<64 * MultiLaneSum<Metre>::lanes; i++)
+        v.push_back(Quantity<Metre, double>(1.0));
+    return v;
+}
+
+void neumaier(){
+    QuantityVector<Metre, double> v = cancelling();
+    NeumaierSum<Metre> s;
+    for (std::size_t i=0; i<v.size(); i++)
+        s += v[i];
+    check(s.value().value() == 6, "compensated sum of cancelling values");
+
+    s.reset();
+    s.add(v);
+    check(s.value().value() == 6, "compensated sum of array of cancelling values");
+
+    s.reset();
+    s.add(laneCancelling());
+    check(s.value().value() == 64 * MultiLaneSum<Metre>::lanes, "compensated sum of ones after large values");
+
+    NeumaierSum<Metre> converted;
+    converted += Quantity<Kilo<Metre>, double>(1e13);
+    converted += Quantity<Mili<Metre>, double>(1000);
+    converted += Quantity<Kilo<Metre>, double>(-1e13);
+    check(converted.value().value() == 1, "compensated sum of converted quantities");
+}
+
+void pairwise(){
+    // Naive float sum of ones stops growing at 2^24.
+    constexpr std::size_t count = std::size_t(1) << 25;
+    PairwiseSum<Metre, float> s;
+    for (std::size_t i=0; i<count; i++)
+        s += Quantity<Metre, float>(1.0f);
+    check(s.value().value() == float(count), "pairwise sum of ones beyond float precision");
+
+    QuantityVector<Metre, float> ones(4000, Quantity<Metre, float>(1.0f));
+    s.reset();
+    s += Quantity<Metre, float>(1.0f);
+    for (std::size_t i=0; i<count / 4000; i++)
+        s.add(ones);
+    check(s.value().value() == float(count / 4000 * 4000 + 1), "pairwise sum of arrays of ones beyond float precision");
+
+    QuantityVector<Kilo<Metre>, float> kilometres(300, Quantity<Kilo<Metre>, float>(0.5f));
+    PairwiseSum<Metre, float> converted;
+    converted.add(kilometres);
+    converted += Quantity<Kilo<Metre>, float>(2);
+    check(converted.value().value() == 152000, "pairwise sum of converted quantities");
+}
+
+void multiLane(){
+    QuantityVector<Metre, double> v = laneCancelling();
+    MultiLaneSum<Metre> s;
+    s.add(v);
+    check(s.value().value() == 64 * MultiLaneSum<Metre>::lanes, "multi-lane sum of ones after large values");
+
+    s.reset();
+    for (std::size_t i=0; i<v.size(); i++)
+        s += v[i];
+    check(s.value().value() == 64 * MultiLaneSum<Metre>::lanes, "multi-lane sum of quantities after large values");
+
+    s.reset();
+    s.add(cancelling());
+    check(s.value().value() == 6, "multi-lane sum of cancelling values");
+
+    QuantityVector<Kilo<Metre>, double> kilometres;
+    kilometres.push_back(Quantity<Kilo<Metre>, double>(1e13));
+    kilometres.push_back(Quantity<Kilo<Metre>, double>(-1e13));
+    for (int i=0; i<20; i++)
+        kilometres.push_back(Quantity<Kilo<Metre>, double>(0.5));
+    MultiLaneSum<Metre> converted;
+    converted.add(kilometres);
+    check(converted.value().value() == 10000, "multi-lane sum of converted quantities");
+}
+
+typedef MultiUnitSum<Watt, double, Watt, Kilo<Watt>, Mega<Watt>> PowerSum;
+
+void multiUnit(){
+    PowerSum s;
+    s += Quantity<Kilo<Watt>, double>(2);
+    s += Quantity<Watt, double>(500);
+    s += Quantity<Kilo<Mili<Watt>>, double>(250);
+    check(s.lane<Kilo<Watt>>().value() == 2, "lane of unit");
+    check(s.lane<Watt>().value() == 750, "lane of equal units");
+    check(s.lane<Mega<Watt>>().value() == 0, "empty lane");
+    check(s.value().value() == 2750, "sum of lanes converted to unit of the sum");
+
+    QuantityVector<Mega<Watt>, double> megawatts(4, Quantity<Mega<Watt>, double>(0.25));
+    s.add(megawatts);
+    check(s.lane<Mega<Watt>>().value() == 1, "array added to lane of its unit");
+
+    MultiUnitSum<Kilo<Watt>, double, Watt, Kilo<Watt>, Mega<Watt>> other;
+    other += Quantity<Watt, double>(250);
+    other += Quantity<Mega<Watt>, double>(1);
+    s += other;
+    check(s.lane<Watt>().value() == 1000 && s.lane<Mega<Watt>>().value() == 2, "lanes merged without conversion");
+    check(s.value().value() == 2003000, "sum of merged accumulators");
+    check(other.value().value() == 1000.25, "sum in other unit");
+
+    s.reset();
+    check(s.value().value() == 0 && s.lane<Kilo<Watt>>().value() == 0, "reset of all lanes");
+
+    // Naive float sum in metres loses the metres beyond 2^24.
+    MultiUnitSum<Metre, float, Metre, Kilo<Metre>> distance;
+    for (int i=0; i<100000; i++){
+        distance += Quantity<Kilo<Metre>, float>(1);
+        distance += Quantity<Metre, float>(1);
+    }
+    check(distance.value().value() == 100100000.0f, "lanes of different magnitude");
+
+    MultiUnitSum<Mili<Second>, std::int64_t, Second, Mili<Second>> integral;
+    integral += Quantity<Second, std::int64_t>(3);
+    integral += Quantity<Mili<Second>, std::int64_t>(7);
+    check(integral.value().value() == 3007, "integral sum");
+}
+
+}
+
+int main(){
+    neumaier();
+    pairwise();
+    multiLane();
+    multiUnit();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file algorithm-test.cpp
+ *
+ * Checks units and values of results of algorithms over quantity arrays,
+ * conversions to units of output arrays, and errors, with sequential and
+ * parallel execution policies.
+ */
+
+#include "quantityalgorithm.h"
+#include "units/SI.h"
+
+#include <execution>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Metre, Power<Second, -1>> MetrePerSecond;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+// Large enough to be split between threads by parallel policies; values are
+// small integers, so sums are exact in any order.
+constexpr std::size_t n = 10000;
+
+template <typename Unit>
+QuantityVector<Unit> iota(std::size_t count){
+    QuantityVector<Unit> v;
+    for (std::size_t i=0; i<count; i++)
+        v.push_back(Quantity<Unit>(double(i)));
+    return v;
+}
+
+template <typename Policy>
+void transforms(const Policy& policy){
+    QuantityVector<Metre> m = iota<Metre>(n);
+    QuantityVector<Second> s(n, Quantity<Second>(2));
+
+    QuantityVector<Kilo<Metre>> km(n);
+    transform(policy, m, km, [](Quantity<Metre> q){ return q * 4.0; });
+    check(km[n - 1].value() == (n - 1) * 0.004 && km[250].value() == 1, "results converted to unit of output");
+
+    auto area = transform(policy, m.span(), [](Quantity<Metre> q){ return q * q; });
+    static_assert(std::is_same_v<typename decltype(area)::UnitType, UnitOf<decltype(Quantity<Metre>() * Quantity<Metre>())>>);
+    check(area.size() == n && area[30].value() == 900, "unit of results deduced like by operator*");
+
+    auto ratio = transform(policy, m, m, [](Quantity<Metre> a, Quantity<Metre> b){ return a / (b + Quantity<Metre>(1)); });
+    static_assert(std::is_same_v<typename decltype(ratio)::UnitType, Compound<>>);
+    check(ratio[0].value() == 0, "dimensionless results");
+
+    QuantityVector<MetrePerSecond> speed(n);
+    transform(policy, km, s, speed, [](Quantity<Kilo<Metre>> d, Quantity<Second> t){ return d / t; });
+    check(speed[500].value() == 1000, "binary transform converted to unit of output");
+
+    check(throws<std::invalid_argument>([&]{ transform(policy, m, iota<Second>(3), speed, [](Quantity<Metre> d, Quantity<Second> t){ return d / t; }); }),
+          "binary transform of different sizes");
+    check(throws<std::invalid_argument>([&]{ transform(policy, m, iota<Metre>(3), [](Quantity<Metre> q){ return q; }); }),
+          "transform into output of different size");
+}
+
+template <typename Policy>
+void reductions(const Policy& policy){
+    QuantityVector<Metre> m = iota<Metre>(n);
+    QuantityVector<Kilo<Gram>> kg(n, Quantity<Kilo<Gram>>(2));
+
+    Quantity<Metre> sum = reduce(policy, m);
+    check(sum.value() == n * (n - 1) / 2.0, "sum in unit of array");
+    check(reduce(policy, QuantityVector<Metre>()).value() == 0, "sum of empty array");
+
+    auto moment = transformReduce(policy, kg, m);
+    static_assert(std::is_same_v<UnitOf<decltype(moment)>, UnitOf<decltype(Quantity<Kilo<Gram>>() * Quantity<Metre>())>>);
+    check(moment.value() == n * (n - 1.0), "sum of products in unit of product");
+    check(throws<std::invalid_argument>([&]{ transformReduce(policy, kg, iota<Metre>(3)); }), "sum of products of different sizes");
+
+    Quantity<Kilo<Metre>> longest = transformReduce(policy, m, Quantity<Kilo<Metre>>(0),
+        [](Quantity<Kilo<Metre>> a, Quantity<Kilo<Metre>> b){ return a > b ? a : b; },
+        [](Quantity<Metre> q){ return q * 2.0; });
+    check(longest.value() == (n - 1) * 0.002, "reduction converted to unit of initial value");
+
+    auto [min, max] = minmax(policy, m.span().subspan(1, 100));
+    check(min.value() == 1 && max.value() == 100, "smallest and largest quantity");
+    check(throws<std::invalid_argument>([&]{ minmax(policy, QuantityVector<Metre>()); }), "extremes of empty array");
+}
+
+template <typename Policy>
+void scans(const Policy& policy){
+    QuantityVector<Metre> m = iota<Metre>(n);
+    QuantityVector<Kilo<Metre>> km(n);
+    inclusiveScan(policy, m, km);
+    check(km[999].value() == 499.5 && km[n - 1].value() == n * (n - 1) / 2000.0, "running sums in unit of output");
+
+    inclusiveScan(policy, m, m);
+    check(m[3].value() == 6 && m[n - 1].value() == n * (n - 1) / 2.0, "running sums in place");
+
+    QuantityVector<Metre> peaks(n);
+    QuantityVector<Kilo<Metre>> wave;
+    for (std::size_t i=0; i<n; i++)
+        wave.push_back(Quantity<Kilo<Metre>>(double(i % 7)));
+    inclusiveScan(policy, wave, peaks, [](Quantity<Metre> a, Quantity<Metre> b){ return a > b ? a : b; });
+    check(peaks[0].value() == 0 && peaks[5].value() == 5000 && peaks[n - 1].value() == 6000, "running maximum");
+
+    check(throws<std::invalid_argument>([&]{ inclusiveScan(policy, wave, iota<Metre>(3)); }), "running sums into output of different size");
+}
+
+template <typename Policy>
+void algorithms(const Policy& policy){
+    transforms(policy);
+    reductions(policy);
+    scans(policy);
+}
+
+}
+
+int main(){
+    algorithms(std::execution::seq);
+    algorithms(std::execution::par);
+    algorithms(std::execution::par_unseq);
+    return failures == 0 ? 0 : 1;
+}
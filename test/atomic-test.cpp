@@ -0,0 +1,145 @@
+/**
+ * @file atomic-test.cpp
+ *
+ * Checks atomic quantities: conversion of operands, compare-and-exchange,
+ * waiting and notification, and totals of updates made by many threads.
+ * Also checks that sums of sharded quantities include all updates, also of
+ * threads sharing a slot.
+ */
+
+#include "atomicquantity.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+constexpr int threads = 4;
+constexpr int updates = 100000;
+
+template <typename F>
+void run(F f){
+    std::vector<std::thread> pool;
+    for (int i=0; i<threads; i++)
+        pool.emplace_back(f, i);
+    for (std::thread& t: pool)
+        t.join();
+}
+
+void operations(){
+    static_assert(std::is_base_of_v<AtomicQuantity<Metre, std::int64_t>, std::atomic<Quantity<Metre, std::int64_t>>>);
+    static_assert(AtomicQuantity<Metre, std::int64_t>::is_always_lock_free == std::atomic<std::int64_t>::is_always_lock_free);
+
+    std::atomic<Quantity<Metre, std::int64_t>> a(Quantity<Kilo<Metre>, std::int64_t>(2));
+    check(a.load().value() == 2000 && a.is_lock_free() == std::atomic<std::int64_t>().is_lock_free(), "constructed from converted quantity");
+    check(a.fetch_add(Quantity<Kilo<Metre>, std::int64_t>(1)).value() == 2000 && a.load().value() == 3000, "fetch_add of converted quantity");
+    check(a.fetch_sub(Quantity<Metre, std::int64_t>(500)).value() == 3000, "fetch_sub returns previous quantity");
+    check((a += Quantity<Kilo<Metre>, std::int32_t>(1)).value() == 3500, "operator+= returns new quantity");
+    check((a -= Quantity<Metre, std::int64_t>(1500)).value() == 2000, "operator-= returns new quantity");
+    check(a.exchange(Quantity<Kilo<Metre>, std::int64_t>(7)).value() == 2000 && a.load().value() == 7000, "exchange");
+    a = Quantity<Metre, std::int64_t>(5);
+    check(Quantity<Metre, std::int64_t>(a).value() == 5, "assignment and conversion to quantity");
+
+    Quantity<Metre, std::int64_t> expected(4);
+    check(!a.compare_exchange_strong(expected, Quantity<Kilo<Metre>, std::int64_t>(1)) && expected.value() == 5,
+          "failed compare-and-exchange updates expected quantity");
+    check(a.compare_exchange_strong(expected, Quantity<Kilo<Metre>, std::int64_t>(1)) && a.load().value() == 1000,
+          "compare-and-exchange stores converted quantity");
+
+    AtomicQuantity<Gram> g;
+    g.fetch_add(Quantity<Kilo<Gram>, double>(0.5));
+    g.store(g.load() + Quantity<Gram>(1));
+    check(g.load().value() == 501, "floating point atomic quantity");
+}
+
+void concurrentUpdates(){
+    AtomicQuantity<Metre, std::int64_t> distance;
+    AtomicQuantity<Gram> mass;
+    run([&](int){
+        for (int i=0; i<updates; i++){
+            distance.fetch_add(Quantity<Kilo<Metre>, std::int64_t>(1), std::memory_order_relaxed);
+            distance -= Quantity<Metre, std::int64_t>(1);
+            mass += Quantity<Kilo<Gram>, double>(0.5);
+        }
+    });
+    check(distance.load().value() == std::int64_t(threads) * updates * 999, "integral updates of many threads");
+    check(mass.load().value() == double(threads) * updates * 500, "floating point updates of many threads");
+
+    // Maximum kept by compare-and-exchange loops.
+    AtomicQuantity<Metre> longest;
+    run([&](int n){
+        for (int i=0; i<updates; i++){
+            Quantity<Kilo<Metre>> candidate(0.001 * (i * threads + n));
+            Quantity<Metre> current = longest.load();
+            while (current < candidate && !longest.compare_exchange_weak(current, candidate)){
+            }
+        }
+    });
+    check(longest.load().value() == double(updates * threads - 1), "maximum kept by compare-and-exchange");
+}
+
+void waiting(){
+    AtomicQuantity<Second, std::int32_t> ready;
+    Quantity<Second, std::int32_t> seen(0);
+    std::thread waiter([&]{
+        ready.wait(Quantity<Second, std::int32_t>(0));
+        seen = ready.load();
+    });
+    ready.store(Quantity<Kilo<Second>, std::int32_t>(1));
+    ready.notify_all();
+    waiter.join();
+    check(seen.value() == 1000, "waiting thread woken by store");
+
+    // Returns at once if the quantity already differs from converted old one.
+    ready.wait(Quantity<Second, std::int32_t>(0));
+    ready.wait(Quantity<Mili<Second>, std::int32_t>(1000));
+}
+
+void sharded(){
+    static ShardedQuantity<Metre, std::int64_t> distance;
+    distance += Quantity<Kilo<Metre>, std::int64_t>(1);
+    distance -= Quantity<Metre, std::int64_t>(1);
+    check(distance.load().value() == 999, "sharded quantity of converted quantities");
+    run([&](int){
+        for (int i=0; i<updates; i++){
+            distance.add(Quantity<Kilo<Metre>, std::int64_t>(2));
+            distance.sub(Quantity<Metre, std::int64_t>(1));
+        }
+    });
+    check(Quantity<Metre, std::int64_t>(distance).value() == 999 + std::int64_t(threads) * updates * 1999, "sum of slots of many threads");
+    distance.reset();
+    check(distance.load().value() == 0, "reset of all slots");
+
+    // Fewer slots than threads; updates of threads sharing a slot are not lost.
+    static ShardedQuantity<Gram, double, 2> mass;
+    run([&](int){
+        for (int i=0; i<updates; i++)
+            mass += Quantity<Kilo<Gram>, double>(0.25);
+    });
+    check(mass.load(std::memory_order_acquire).value() == double(threads) * updates * 250, "sum of slots shared by threads");
+}
+
+}
+
+int main(){
+    operations();
+    concurrentUpdates();
+    waiting();
+    sharded();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file cache-test.cpp
+ *
+ * Checks conversion plans, interning of units, counts of cache hits and
+ * misses, behavior of full tables, rejection of units of different
+ * dimensions, and lookups made by many threads.
+ */
+
+#include "conversioncache.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+void plans(){
+    constexpr ConversionPlan km = ConversionPlan::of<Kilo<Metre>, Metre>();
+    static_assert(km.factor == 1000 && km.offset == 0);
+    static_assert(ConversionPlan::of<Metre, Metre>().isIdentity());
+
+    ConversionPlan dynamic = ConversionPlan::between(DynamicUnit::of<Kilo<Metre>>(), DynamicUnit::of<Metre>());
+    check(dynamic == km, "plan between dynamic units equals plan between static ones");
+    check(ConversionPlan::between(DynamicUnit::of<Kilo<Mili<Metre>>>(), DynamicUnit::of<Metre>()).isIdentity(), "plan between equal units");
+    check(throws<DimensionError>([]{ ConversionPlan::between(DynamicUnit::of<Metre>(), DynamicUnit::of<Second>()); }),
+          "plan between different dimensions");
+
+    check(km.apply(2.5) == 2500, "plan applied to a value");
+    double in[] = {1, 2, 3};
+    double out[3];
+    check(km.apply(in, in + 3, out) == out + 3 && out[0] == 1000 && out[2] == 3000, "plan applied to a range");
+}
+
+void lookups(){
+    static ConversionCache<> cache;
+    UnitId metre = cache.intern<Metre>();
+    UnitId kilometre = cache.intern<Kilo<Metre>>();
+    UnitId second = cache.intern(DynamicUnit::of<Second>());
+    check(metre != 0 && metre != kilometre && metre != second && kilometre != second, "distinct units get distinct identifiers");
+    check(cache.intern(DynamicUnit::of<Metre>()) == metre && cache.intern<Kilo<Mili<Metre>>>() == metre, "equal units get the same identifier");
+    check(cache.unit(kilometre) == DynamicUnit::of<Kilo<Metre>>(), "unit of identifier");
+
+    check(cache.plan(kilometre, metre).factor == 1000 && cache.hits() == 0 && cache.misses() == 1, "first lookup is a miss");
+    check(cache.plan(kilometre, metre).factor == 1000 && cache.hits() == 1 && cache.misses() == 1, "next lookup is a hit");
+    check(cache.plan(metre, kilometre).factor == 0.001 && cache.misses() == 2, "reversed pair is a different entry");
+    check(cache.plan(DynamicUnit::of<Metre>(), DynamicUnit::of<Kilo<Metre>>()).factor == 0.001 && cache.hits() == 2,
+          "lookup by units");
+
+    check(throws<DimensionError>([&]{ cache.plan(metre, second); }), "plan between different dimensions");
+    check(throws<DimensionError>([&]{ cache.plan(metre, second); }), "failed plan is not cached");
+    check(cache.hits() == 2, "failed plans are not hits");
+}
+
+void fullTables(){
+    static ConversionCache<4, 2> cache;
+    UnitId metre = cache.intern<Metre>();
+    UnitId kilometre = cache.intern<Kilo<Metre>>();
+    UnitId millimetre = cache.intern<Mili<Metre>>();
+    cache.intern<Second>();
+    check(throws<std::length_error>([&]{ cache.intern<Kilo<Second>>(); }), "full unit table");
+    check(cache.intern<Metre>() == metre, "interned unit is found in full table");
+
+    cache.plan(metre, kilometre);
+    cache.plan(kilometre, metre);
+    check(cache.plan(millimetre, metre).factor == 0.001 && cache.plan(millimetre, metre).factor == 0.001, "plan computed when table is full");
+    check(cache.misses() == 4 && cache.hits() == 0, "lookups missing full table");
+    cache.plan(metre, kilometre);
+    cache.plan(kilometre, metre);
+    check(cache.hits() == 2, "cached plans are found in full table");
+}
+
+void threads(){
+    static ConversionCache<> cache;
+    std::vector<UnitId> ids = {cache.intern<Metre>(), cache.intern<Kilo<Metre>>(), cache.intern<Mili<Metre>>(), cache.intern<Mega<Metre>>()};
+    constexpr int count = 4;
+    constexpr int lookups = 10000;
+    std::atomic<int> wrong{0};
+    std::vector<std::thread> pool;
+    for (int t=0; t<count; t++)
+        pool.emplace_back([&]{
+            for (int i=0; i<lookups; i++){
+                UnitId from = ids[i % 4];
+                UnitId to = ids[i / 4 % 4];
+                ConversionPlan expected = ConversionPlan::between(cache.unit(from), cache.unit(to));
+                if (!(cache.plan(from, to) == expected))
+                    wrong++;
+            }
+        });
+    for (std::thread& t: pool)
+        t.join();
+    check(wrong == 0, "plans looked up by many threads");
+    check(cache.hits() + cache.misses() == std::uint64_t(count) * lookups && cache.misses() >= 16, "every lookup counted once");
+}
+
+}
+
+int main(){
+    plans();
+    lookups();
+    fullTables();
+    threads();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file constexpr-test.cpp
+ *
+ * Checks at compile time that quantities are usable in constant expressions
+ * (tables, conversions, `quantityCast` and cmath overloads), and that
+ * operations on arithmetic underlying types are noexcept.
+ */
+
+#include "cmath.h"
+#include "units/SI.h"
+
+#include <array>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Power<Kilo<Metre>, 1>, Power<Hour, -1>> KilometrePerHour;
+typedef Compound<Power<Metre, 1>, Power<Second, -1>> MetrePerSecond;
+
+// Tables of quantities built at compile time.
+constexpr std::array<Quantity<Metre>, 4> lengths = [](){
+    std::array<Quantity<Metre>, 4> result = {};
+    for (std::size_t i=0; i<result.size(); i++)
+        result[i] = Quantity<Kilo<Metre>>(double(i));
+    return result;
+}();
+
+static_assert(lengths[3].value() == 3000);
+
+constexpr Quantity<Second> sum(){
+    Quantity<Second> total(0);
+    for (Quantity<Minute> m: {Quantity<Minute>(1), Quantity<Minute>(2)})
+        total += m;
+    ++total;
+    return total;
+}
+
+static_assert(sum().value() == 181);
+
+// Conversions.
+static_assert(Quantity<Metre>(Quantity<Kilo<Metre>>(1.5)).value() == 1500);
+static_assert(Quantity<MetrePerSecond>(Quantity<KilometrePerHour>(36.0)).value() == 10);
+static_assert(Quantity<Second, int>(Quantity<Hour, int>(2)).value() == 7200);
+static_assert(Convert<Kilo<Metre>, Metre>::value(2.0) == 2000);
+static_assert(ConvertIntegral<Metre, Kilo<Metre>, RoundToNearest>::value<int>(1500) == 2);
+static_assert(ConvertIntegral<Metre, Kilo<Metre>, RoundDown>::value<int>(-1) == -1);
+static_assert(ConvertIntegral<Minute, Second>::value<long long>(std::numeric_limits<int>::max()) == 60ll * std::numeric_limits<int>::max());
+static_assert(ConvertIntegral<Mili<Metre>, Kilo<Metre>, RoundToNearest>::value<long long>(std::numeric_limits<long long>::min()) == -9223372036855);
+
+// Arithmetic, comparisons and helper variables.
+static_assert((Quantity<Metre>(3) + Quantity<Kilo<Metre>>(1)).value() == 1003);
+static_assert((Quantity<Metre>(6) / Quantity<Second>(2)).value() == 3);
+static_assert((2.0 * metre * second).value() == 2);
+static_assert(Quantity<Metre>(1) < Quantity<Kilo<Metre>>(1));
+static_assert(Quantity<Metre>(1000) == Quantity<Kilo<Metre>>(1));
+static_assert((Quantity<Metre, int>(7) % Quantity<Metre, int>(4)).value() == 3);
+
+// quantityCast
+static_assert(quantityCast<Metre>(Quantity<Mili<Metre>, int>(1999)).value() == 1);
+static_assert(quantityCast<Metre, RoundToNearest>(Quantity<Mili<Metre>, int>(1999)).value() == 2);
+static_assert(quantityCast<Metre>(Quantity<Kilo<Metre>>(0.25)).value() == 250);
+
+// cmath overloads. Functions of <cmath> are constexpr only as an extension of
+// libstdc++ until C++23.
+#if defined(__GLIBCXX__)
+static_assert(fabs(Quantity<Metre>(-2)).value() == 2);
+static_assert(floor(Quantity<Metre>(2.5)).value() == 2);
+static_assert(ceil(Quantity<Metre>(2.5)).value() == 3);
+static_assert(trunc(Quantity<Metre>(-2.5)).value() == -2);
+static_assert(round(Quantity<Metre>(2.5)).value() == 3);
+static_assert(fmax(Quantity<Metre>(2), Quantity<Kilo<Metre>>(1)).value() == 1000);
+static_assert(fmin(Quantity<Metre>(2), Quantity<Kilo<Metre>>(1)).value() == 2);
+static_assert(copysign(Quantity<Metre>(2), Quantity<Kilo<Metre>>(-1)).value() == -2);
+static_assert(fmod(Quantity<Metre>(2500), Quantity<Kilo<Metre>>(1)).value() == 500);
+static_assert(fdim(Quantity<Metre>(2500), Quantity<Kilo<Metre>>(1)).value() == 1500);
+static_assert(isfinite(Quantity<Metre>(1)));
+static_assert(!signbit(Quantity<Metre>(1)));
+#endif
+
+// noexcept
+static_assert(std::is_nothrow_default_constructible_v<Quantity<Metre>>);
+static_assert(std::is_nothrow_move_constructible_v<Quantity<Metre>>);
+static_assert(std::is_nothrow_move_constructible_v<Quantity<KilometrePerHour, int>>);
+static_assert(std::is_nothrow_copy_assignable_v<Quantity<Metre>>);
+static_assert(std::is_nothrow_constructible_v<Quantity<Metre>, Quantity<Kilo<Metre>>>);
+static_assert(std::is_nothrow_constructible_v<Quantity<Metre, int>, Quantity<Kilo<Metre>, int>>);
+static_assert(std::is_nothrow_assignable_v<Quantity<Metre>&, Quantity<Kilo<Metre>>>);
+static_assert(std::is_trivially_default_constructible_v<Quantity<Metre>>);
+
+constexpr Quantity<Metre> m(1);
+constexpr Quantity<Kilo<Metre>> km(1);
+static_assert(noexcept(m + km) && noexcept(m - km) && noexcept(-m) && noexcept(m < km) && noexcept(m == km));
+static_assert(noexcept(m * km) && noexcept(m / km) && noexcept(m * 2.0) && noexcept(2.0 / m));
+static_assert(noexcept(m.value()) && noexcept(quantityCast<Kilo<Metre>>(m)));
+static_assert(noexcept(std::declval<Quantity<Metre>&>() += km) && noexcept(std::declval<Quantity<Metre>&>() *= 2.0));
+static_assert(noexcept(fabs(m)) && noexcept(floor(m)) && noexcept(fmod(m, km)) && noexcept(fma(m, km, m)));
+static_assert(noexcept(Convert<Kilo<Metre>, Metre>::value(2.0)));
+static_assert(noexcept(ConvertIntegral<Kilo<Metre>, Metre>::value<int>(2)));
+
+}
+
+int main(){
+    return 0;
+}
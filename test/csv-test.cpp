@@ -0,0 +1,135 @@
+/**
+ * @file csv-test.cpp
+ *
+ * Checks that CSV reader binds columns by position and by name, converts
+ * values to units of bound quantities, reads integral columns exactly,
+ * accepts CRLF line endings and empty lines, and rejects invalid headers and
+ * values.
+ */
+
+#include "quantitycsv.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Metre, Power<Second, -1>> MetrePerSecond;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+void lineEndings(){
+    std::istringstream in("\xEF\xBB\xBFspeed [km/h], count\r\n"
+                          "36, 1\r\n"
+                          "\r\n"
+                          "\n"
+                          " 72 ,2 \r\n"
+                          "\r\n"
+                          "108,3");
+    QuantityCsvReader<Quantity<MetrePerSecond>, Quantity<Compound<>, int>> reader(in, {}, 2);
+    check(reader.unit(0) == DynamicUnit::of<Compound<Kilo<Metre>, Power<Hour, -1>>>(), "unit of column");
+
+    check(reader.read() == 2, "first chunk without empty lines");
+    check(reader.column<0>()[0].value() == 10 && reader.column<0>()[1].value() == 20, "values converted to unit of quantity");
+    check(reader.column<1>()[0].value() == 1 && reader.column<1>()[1].value() == 2, "values of integral column");
+    check(reader.read() == 1 && reader.column<0>()[0].value() == 30 && reader.column<1>()[0].value() == 3,
+          "last line without line ending");
+    check(reader.read() == 0, "end of input");
+}
+
+void names(){
+    std::istringstream in("time[ms],ignored,distance[km],id\n"
+                          "1500,x,2,9007199254740993\n");
+    QuantityCsvReader<Quantity<Metre>, Quantity<Second, std::int64_t>, Quantity<Compound<>, std::int64_t>>
+        reader(in, {"distance", "time", "id"});
+    check(reader.read() == 1, "row of named columns");
+    check(reader.column<0>()[0].value() == 2000, "value of named column");
+    check(reader.column<1>()[0].value() == 1, "integral value converted and truncated");
+    check(reader.column<2>()[0].value() == 9007199254740993, "integral value read exactly");
+}
+
+void rejectedHeaders(){
+    check(throws<std::runtime_error>([]{
+        std::istringstream in("");
+        QuantityCsvReader<Quantity<Metre>> reader(in);
+    }), "CSV without header");
+    check(throws<DimensionError>([]{
+        std::istringstream in("time[s]\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in);
+    }), "column of other dimension");
+    check(throws<DimensionError>([]{
+        std::istringstream in("length\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in);
+    }), "dimensionless column read as length");
+    check(throws<std::invalid_argument>([]{
+        std::istringstream in("length[apples]\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in);
+    }), "unknown unit");
+    check(throws<std::invalid_argument>([]{
+        std::istringstream in("length[m\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in);
+    }), "unterminated unit");
+    check(throws<std::invalid_argument>([]{
+        std::istringstream in("length[m]\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in, {"width"});
+    }), "missing named column");
+    check(throws<std::invalid_argument>([]{
+        std::istringstream in("length[m]\n1\n");
+        QuantityCsvReader<Quantity<Metre>, Quantity<Metre>> reader(in);
+    }), "too few columns");
+}
+
+template <typename Q>
+bool rejectsValue(const char* csv){
+    return throws<std::runtime_error>([&]{
+        std::istringstream in(csv);
+        QuantityCsvReader<Q> reader(in);
+        reader.read();
+    });
+}
+
+void rejectedValues(){
+    check(rejectsValue<Quantity<Metre>>("length[m]\nabc\n"), "value that is not a number");
+    check(rejectsValue<Quantity<Metre>>("length[m]\n1 2\n"), "value followed by other characters");
+    check(throws<std::runtime_error>([]{
+        std::istringstream in("length[m],width[m]\n1\n");
+        QuantityCsvReader<Quantity<Metre>> reader(in, {"width"});
+        reader.read();
+    }), "line without bound field");
+    check(rejectsValue<Quantity<Metre, std::int32_t>>("length[m]\n1.5\n"), "fraction in integral column");
+    check(rejectsValue<Quantity<Metre, std::int32_t>>("length[m]\n2147483648\n"), "integral value out of range");
+    check(rejectsValue<Quantity<Mili<Metre>, std::int32_t>>("length[km]\n3000\n"), "converted integral value out of range");
+}
+
+}
+
+int main(){
+    lineEndings();
+    names();
+    rejectedHeaders();
+    rejectedValues();
+    return failures == 0 ? 0 : 1;
+}
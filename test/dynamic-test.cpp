@@ -0,0 +1,115 @@
+/**
+ * @file dynamic-test.cpp
+ *
+ * Checks arithmetic on packed exponents of `DynamicDimension`, including
+ * exponents at the limits of their range, and operators mixing
+ * `DynamicQuantity` with static quantities.
+ */
+
+#include "dynamicquantity.h"
+#include "units/SI.h"
+
+#include <iostream>
+#include <random>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename F>
+bool throwsDimensionError(F f){
+    try{
+        f();
+    } catch (const DimensionError&){
+        return true;
+    }
+    return false;
+}
+
+DimensionVector single(int index, int exponent){
+    DimensionVector v;
+    v.exponents[index] = exponent;
+    return v;
+}
+
+/*
+ * Exponents are added and subtracted in all slots at once; compare with
+ * adding them one by one, for exponents whose results stay in range.
+ */
+void packedArithmetic(){
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> exponent(-64, 63);
+    bool products = true;
+    bool quotients = true;
+    for (int n=0; n<10000; n++){
+        DimensionVector a, b;
+        for (int i=0; i<DimensionVector::size; i++){
+            a.exponents[i] = exponent(random);
+            b.exponents[i] = exponent(random);
+        }
+        products = products && (DynamicDimension(a) * DynamicDimension(b)).vector() == a + b;
+        quotients = quotients && (DynamicDimension(a) / DynamicDimension(b)).vector() == a - b;
+    }
+    check(products, "products of random dimensions");
+    check(quotients, "quotients of random dimensions");
+}
+
+void limits(){
+    for (int i=0; i<DimensionVector::size; i++){
+        DynamicDimension max(single(i, 127));
+        DynamicDimension min(single(i, -128));
+        DynamicDimension one(single(i, 1));
+        check((max * min).vector() == single(i, -1), "sum of limits");
+        check((min * one).vector() == single(i, -127), "sum above lower limit");
+        check((max / one).vector() == single(i, 126), "difference below upper limit");
+        check((min / min).isDimensionless(), "difference of lower limits");
+        check((max / max).isDimensionless(), "difference of upper limits");
+        check(throwsDimensionError([&]{ return max * one; }), "sum over upper limit");
+        check(throwsDimensionError([&]{ return min * DynamicDimension(single(i, -1)); }), "sum under lower limit");
+        check(throwsDimensionError([&]{ return min / one; }), "difference under lower limit");
+        check(throwsDimensionError([&]{ return DynamicDimension() / min; }), "inverse of lower limit");
+        check(throwsDimensionError([&]{ return max / DynamicDimension(single(i, -1)); }), "difference over upper limit");
+        check(min.pow(1) == min && one.pow(-128) == min && one.pow(127) == max, "powers at limits");
+        check(throwsDimensionError([&]{ return min.pow(-1); }), "power over upper limit");
+        check(throwsDimensionError([&]{ return one.pow(128); }), "power over upper limit");
+        check(throwsDimensionError([&]{ return max.pow(1 << 30); }), "large power");
+    }
+    check(throwsDimensionError([]{ return 1.0 / DynamicQuantity<double>(1, DynamicUnit(DynamicDimension(single(0, -128)))); }),
+          "inverse of quantity of lower limit");
+}
+
+void mixedOperators(){
+    DynamicQuantity<double> d = Quantity<Kilo<Metre>, double>(2);
+    Quantity<Metre, double> m(500);
+    check((d + m).value() == 2.5 && (d - m).value() == 1.5, "static quantity added to dynamic one");
+    check((m + d).value() == 2500 && (m - d).value() == -1500, "dynamic quantity added to static one");
+    check(m < d && d > m && m != d && !(d == m) && d >= m && m <= d, "comparison of dynamic and static quantities");
+    check(d == Quantity<Metre, double>(2000) && Quantity<Metre, double>(2000) == d, "equal dynamic and static quantities");
+
+    DynamicQuantity<double> inverse = 4.0 / d;
+    check(inverse.value() == 2 && inverse.unit() == DynamicUnit::of<Power<Kilo<Metre>, -1>>(), "value divided by dynamic quantity");
+
+    d += m;
+    d -= Quantity<Metre, double>(250);
+    check(d.value() == 2.25, "compound assignment of static quantity");
+    check(throwsDimensionError([&]{ return d + Quantity<Second, double>(1); }), "addition of different dimensions");
+    check(throwsDimensionError([&]{ return d < Quantity<Second, double>(1); }), "comparison of different dimensions");
+}
+
+}
+
+int main(){
+    packedArithmetic();
+    limits();
+    mixedOperators();
+    return failures == 0 ? 0 : 1;
+}
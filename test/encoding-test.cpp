@@ -0,0 +1,122 @@
+/**
+ * @file encoding-test.cpp
+ *
+ * Checks that encoded arrays of quantities decode to the same quantities in
+ * units of the decoder, and that invalid and truncated buffers, and arrays
+ * of other dimensions or value types, are rejected before anything is
+ * written.
+ */
+
+#include "quantityencoding.h"
+#include "units/SI.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+template <typename Unit, typename T>
+QuantityVector<Unit, T> iota(std::size_t n){
+    QuantityVector<Unit, T> v;
+    for (std::size_t i=0; i<n; i++)
+        v.push_back(Quantity<Unit, T>(T(i)));
+    return v;
+}
+
+void roundTrip(){
+    static_assert(unitTag<Metre>() == unitTag<Kilo<Mili<Metre>>>());
+    static_assert(unitTag<Metre>() != unitTag<Kilo<Metre>>());
+
+    QuantityVector<Metre> metres = iota<Metre, double>(100);
+    std::vector<std::byte> buffer = encode(metres);
+    check(buffer.size() == encodedSize(100) && encodedCount(buffer.data(), buffer.size()) == 100, "size of encoded array");
+
+    QuantityVector<Metre> same = decode<Metre>(buffer.data(), buffer.size());
+    bool equal = same.size() == 100;
+    for (std::size_t i=0; i<same.size() && equal; i++)
+        equal = same[i].value() == metres[i].value();
+    check(equal, "values decoded in the same unit");
+
+    QuantityVector<Kilo<Mili<Metre>>> equivalent = decode<Kilo<Mili<Metre>>>(buffer.data(), buffer.size());
+    check(equivalent[42].value() == 42, "values decoded in unit of the same signature");
+}
+
+void conversion(){
+    std::vector<std::byte> buffer = encode(iota<Kilo<Metre>, double>(10));
+    QuantityVector<Metre> metres = decode<Metre>(buffer.data(), buffer.size());
+    check(metres[7].value() == 7000, "values converted on decoding");
+
+    std::vector<std::byte> integral = encode(iota<Second, std::int32_t>(10));
+    QuantityVector<Mili<Second>, std::int32_t> milliseconds = decode<Mili<Second>, std::int32_t>(integral.data(), integral.size());
+    check(milliseconds[9].value() == 9000, "integral values converted on decoding");
+    check(throws<std::out_of_range>([&]{ decode<Nano<Second>, std::int32_t>(integral.data(), integral.size()); }),
+          "converted integral value out of range");
+
+    // Values following a header at an odd offset are not aligned.
+    std::vector<std::byte> unaligned(buffer.size() + 1);
+    std::memcpy(unaligned.data() + 1, buffer.data(), buffer.size());
+    QuantityVector<Metre> fromUnaligned = decode<Metre>(unaligned.data() + 1, buffer.size());
+    check(fromUnaligned[9].value() == 9000, "values converted from unaligned buffer");
+}
+
+void rejected(){
+    std::vector<std::byte> buffer = encode(iota<Metre, double>(10));
+    QuantityVector<Second> seconds(10, Quantity<Second>(-1));
+    check(throws<DimensionError>([&]{ decode(buffer.data(), buffer.size(), QuantitySpan<Second, double>(seconds)); }),
+          "array of other dimension");
+    check(seconds[0].value() == -1, "output unchanged by rejected array");
+    check(throws<std::invalid_argument>([&]{ decode<Metre, float>(buffer.data(), buffer.size()); }), "array of other value type");
+    QuantityVector<Metre> shorter(9);
+    check(throws<std::invalid_argument>([&]{ decode(buffer.data(), buffer.size(), QuantitySpan<Metre, double>(shorter)); }),
+          "array of other size");
+}
+
+void invalid(){
+    std::vector<std::byte> buffer = encode(iota<Metre, double>(10));
+    check(throws<std::runtime_error>([&]{ decode<Metre>(buffer.data(), encodedHeaderSize - 1); }), "truncated header");
+    check(throws<std::runtime_error>([&]{ decode<Metre>(buffer.data(), buffer.size() - 1); }), "truncated values");
+
+    std::vector<std::byte> magic = buffer;
+    magic[0] = std::byte(0);
+    check(throws<std::runtime_error>([&]{ decode<Metre>(magic.data(), magic.size()); }), "wrong magic number");
+
+    std::vector<std::byte> signature = buffer;
+    std::int64_t zero = 0;
+    std::memcpy(signature.data() + offsetof(Helper::EncodedHeader, unit) + offsetof(UnitSignature, denominator), &zero, sizeof(zero));
+    check(throws<std::runtime_error>([&]{ decode<Metre>(signature.data(), signature.size()); }), "invalid unit signature");
+}
+
+}
+
+int main(){
+    roundTrip();
+    conversion();
+    rejected();
+    invalid();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file expression-test.cpp
+ *
+ * Checks units and values of fused expressions over quantity arrays mixing
+ * arrays, spans, quantities and plain values of different units, and
+ * evaluation of expressions into arrays they read.
+ */
+
+#include "quantityvector.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Metre, Power<Second, -1>> MetrePerSecond;
+typedef Compound<Metre, Power<Second, -2>> MetrePerSecondSquared;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename Unit, typename T = double>
+QuantityVector<Unit, T> iota(std::size_t n, T first = 0){
+    QuantityVector<Unit, T> v;
+    for (std::size_t i=0; i<n; i++)
+        v.push_back(Quantity<Unit, T>(first + T(i)));
+    return v;
+}
+
+void energy(){
+    // Size not divisible by block size, to cover the remainder loop.
+    constexpr std::size_t n = 21;
+    QuantityVector<Kilo<Gram>> m = iota<Kilo<Gram>>(n, 1.0);
+    QuantityVector<MetrePerSecond> v(n, Quantity<MetrePerSecond>(4));
+    QuantityVector<Kilo<Metre>> h(n, Quantity<Kilo<Metre>>(0.5));
+    Quantity<MetrePerSecondSquared> g(10);
+
+    auto e = 0.5*m*v*v + m*g*h;
+    static_assert(IsEqualDimension<decltype(e)::UnitType, Joule>::value);
+    static_assert(std::is_same_v<decltype(e)::UnitType, decltype(0.5*m*v*v)::UnitType>);
+    check(e.size() == n, "size of expression");
+    check(e[2].value() == 24 + 15000, "element of unevaluated expression");
+
+    QuantityVector<Joule> joules = e;
+    bool ok = true;
+    for (std::size_t i=0; i<n; i++)
+        ok &= joules[i].value() == (i + 1.0) * 8 + (i + 1.0) * 5000;
+    check(joules.size() == n && ok, "expression evaluated in unit of vector");
+
+    QuantityVector<Kilo<Joule>> kilojoules(n);
+    kilojoules = e;
+    check(kilojoules[9].value() == 50.08, "expression converted to prefixed unit");
+
+    auto same = evaluate(e);
+    static_assert(std::is_same_v<decltype(same)::UnitType, decltype(e)::UnitType>);
+    check(same[20].value() == 21 * 8 + 21 * 5000, "evaluate() keeps unit of expression");
+}
+
+void operands(){
+    QuantityVector<Metre> m = iota<Metre>(10);
+    QuantityVector<Kilo<Metre>> km(10, Quantity<Kilo<Metre>>(2));
+    QuantityVector<Second> s(10, Quantity<Second>(4));
+
+    // Right operands of sums are converted to unit of the left operand,
+    // also when they are subexpressions or quantities.
+    QuantityVector<Metre> mixed = m + (km - Quantity<Metre>(500)) + Quantity<Kilo<Metre>>(1);
+    check(mixed[3].value() == 3 + 1500 + 1000, "sum of converted subexpression and quantity");
+    QuantityVector<Kilo<Metre>> left = Quantity<Kilo<Metre>>(1) - m;
+    check(left[5].value() == 0.995, "quantity as left operand");
+
+    auto speed = m.span().subspan(2, 4) / s.span().subspan(0, 4);
+    static_assert(std::is_same_v<decltype(speed)::UnitType, Simplify<Join<Metre, Invert<Second>>>>);
+    QuantityVector<MetrePerSecond> speeds = speed;
+    check(speeds.size() == 4 && speeds[3].value() == 1.25, "quotient of spans");
+
+    QuantityVector<Invert<Second>> frequency = 2.0 / s;
+    check(frequency[0].value() == 0.5, "value divided by array");
+
+    QuantityVector<Metre, std::int32_t> integral = iota<Kilo<Metre>, std::int32_t>(10) * 3;
+    check(integral[7].value() == 21000, "integral expression converted exactly");
+}
+
+void aliasing(){
+    // Expressions reading the assigned array at the same positions are
+    // evaluated in place.
+    QuantityVector<Metre> v = iota<Metre>(20);
+    v = v * 3.0 - v;
+    check(v.size() == 20 && v[19].value() == 38, "expression of the assigned vector");
+
+    QuantityVector<Kilo<Metre>> k = iota<Kilo<Metre>>(20);
+    v = k + v;
+    k = k * 1000.0 + v;
+    check(k[10].value() == 10010.02, "expression of the assigned vector in other unit");
+
+    QuantitySpan<Metre> s = v.span();
+    s.assign(s * s / s + s);
+    check(v[13].value() == 2 * 13026, "expression assigned to a span it reads");
+
+    // Values are read ahead of stored ones, so shifting towards the front
+    // is safe.
+    QuantityVector<Metre> w = iota<Metre>(20);
+    QuantitySpan<Metre> ws = w.span();
+    ws.subspan(0, 19).assign(ws.subspan(1, 19) * 1.0);
+    bool shifted = true;
+    for (std::size_t i=0; i<19; i++)
+        shifted &= w[i].value() == double(i + 1);
+    check(shifted && w[19].value() == 19, "expression of a shifted span of the assigned one");
+
+    w += w;
+    w *= 0.5;
+    w -= w * 0.5;
+    check(w[0].value() == 0.5, "compound assignment of expression of the vector");
+}
+
+}
+
+int main(){
+    energy();
+    operands();
+    aliasing();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file file-test.cpp
+ *
+ * Checks that quantity files read back what was written, convert columns to
+ * requested units, migrate to other units, and reject columns of other
+ * dimensions or value types and damaged files.
+ */
+
+#include "quantityfile.h"
+#include "units/SI.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+const std::string path = "file-test.qf";
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+// Writes n rows: i kilometres and i seconds.
+void write(std::size_t n){
+    QuantityFileWriter<Quantity<Kilo<Metre>>, Quantity<Second, std::int32_t>> writer(path, 4);
+    for (std::size_t i=0; i<n; i++)
+        writer.append(Quantity<Metre>(1000.0 * i), Quantity<Second, std::int32_t>(i));
+    writer.close();
+}
+
+void overwrite(std::size_t offset, const void* bytes, std::size_t size){
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset);
+    f.write(static_cast<const char*>(bytes), size);
+}
+
+void roundTrip(){
+    write(1000);
+    QuantityFile file(path);
+    check(file.columns() == 2 && file.rows() == 1000, "size of file");
+    check(file.unit(0) == UnitSignature::of<Kilo<Metre>>() && file.unit(1) == UnitSignature::of<Second>(), "units of columns");
+
+    QuantitySpan<Kilo<Metre>, const double> distances = file.column<Kilo<Metre>>(0);
+    QuantitySpan<Second, const std::int32_t> times = file.column<Second, std::int32_t>(1);
+    bool same = true;
+    for (std::size_t i=0; i<1000; i++)
+        same = same && distances[i].value() == double(i) && times[i].value() == std::int32_t(i);
+    check(same, "values read in units of columns");
+}
+
+void conversion(){
+    write(100);
+    QuantityFile file(path);
+    QuantitySpan<Metre, const double> metres = file.column<Metre>(0);
+    QuantitySpan<Mili<Second>, const std::int32_t> milliseconds = file.column<Mili<Second>, std::int32_t>(1);
+    bool converted = true;
+    for (std::size_t i=0; i<100; i++)
+        converted = converted && metres[i].value() == 1000.0 * i && milliseconds[i].value() == std::int32_t(1000 * i);
+    check(converted, "values converted on read");
+    check(file.column<Metre>(0).data() == metres.data(), "converted column kept by file");
+    check(throws<std::out_of_range>([&]{ file.column<Nano<Second>, std::int32_t>(1); }), "converted integral value out of range");
+}
+
+void rejected(){
+    write(10);
+    QuantityFile file(path);
+    check(throws<DimensionError>([&]{ file.column<Second>(0); }), "column of other dimension");
+    check(throws<std::invalid_argument>([&]{ file.column<Metre, float>(0); }), "column of other value type");
+    check(throws<std::out_of_range>([&]{ file.column<Metre>(2); }), "column index out of range");
+}
+
+void damaged(){
+    write(10);
+    std::int64_t zero = 0;
+    overwrite(sizeof(Helper::FileHeader) + offsetof(Helper::ColumnHeader, unit) + offsetof(UnitSignature, denominator), &zero, sizeof(zero));
+    check(throws<std::runtime_error>([]{ QuantityFile file(path); }), "column with invalid unit");
+
+    write(10);
+    std::uint64_t rows = 11;
+    overwrite(offsetof(Helper::FileHeader, rows), &rows, sizeof(rows));
+    check(throws<std::runtime_error>([]{ QuantityFile file(path); }), "more rows than capacity");
+
+    std::ofstream(path, std::ios::binary) << "LIBUNITQ";
+    check(throws<std::runtime_error>([]{ QuantityFile file(path); }), "truncated file");
+    check(throws<std::system_error>([]{ QuantityFile file("file-test.missing"); }), "missing file");
+}
+
+// Checks that no temporary files of migration are left next to the file.
+bool noTemporaryFiles(){
+    for (const std::filesystem::directory_entry& e: std::filesystem::directory_iterator("."))
+        if (e.path().filename().string().starts_with(path + "."))
+            return false;
+    return true;
+}
+
+void migration(){
+    write(100);
+    {
+        QuantityFile old(path);
+        QuantitySpan<Kilo<Metre>, const double> before = old.column<Kilo<Metre>>(0);
+        QuantityFile::migrate<Quantity<Metre>, Quantity<Mili<Second>, std::int32_t>>(path);
+        check(before[99].value() == 99, "old mapping unchanged by migration");
+    }
+    check(noTemporaryFiles(), "temporary file removed after migration");
+    {
+        QuantityFile file(path);
+        check(file.unit(0) == UnitSignature::of<Metre>() && file.unit(1) == UnitSignature::of<Mili<Second>>(), "units of migrated columns");
+        QuantitySpan<Metre, const double> metres = file.column<Metre>(0);
+        check(metres[99].value() == 99000, "values of migrated column");
+        check(file.column<Mili<Second>, std::int32_t>(1)[99].value() == 99000, "values of migrated integral column");
+    }
+
+    std::filesystem::file_time_type modified = std::filesystem::last_write_time(path);
+    QuantityFile::migrate<Quantity<Metre>, Quantity<Mili<Second>, std::int32_t>>(path);
+    check(std::filesystem::last_write_time(path) == modified, "file in requested units left untouched");
+
+    check(throws<DimensionError>([]{ QuantityFile::migrate<Quantity<Second>, Quantity<Second, std::int32_t>>(path); }),
+          "migration to other dimension");
+    check(throws<std::invalid_argument>([]{ QuantityFile::migrate<Quantity<Metre>, Quantity<Second, std::int64_t>>(path); }),
+          "migration to other value type");
+    check(throws<std::invalid_argument>([]{ QuantityFile::migrate<Quantity<Metre>>(path); }), "migration of other number of columns");
+    check(QuantityFile(path).unit(0) == UnitSignature::of<Metre>() && noTemporaryFiles(), "file unchanged by rejected migration");
+}
+
+}
+
+int main(){
+    roundTrip();
+    conversion();
+    rejected();
+    migration();
+    damaged();
+    std::remove(path.c_str());
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file metrics-test.cpp
+ *
+ * Checks text exposition of metrics: names with unit suffixes, values
+ * converted to coherent SI units, cumulative histogram buckets, and spelling
+ * of infinite and NaN values.
+ */
+
+#include "metrics.h"
+
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+void checkText(const MetricsRegistry& registry, const std::string& expected, const char* what){
+    std::ostringstream s;
+    registry.write(s);
+    if (s.str() != expected)
+        std::cerr << "got:\n" << s.str() << "expected:\n" << expected;
+    check(s.str() == expected, what);
+}
+
+void counter(){
+    MetricsRegistry registry;
+    Counter<Mili<Second>, std::uint64_t>& c = registry.counter<Mili<Second>, std::uint64_t>("request_time", "Time spent on \"requests\".\n");
+    c.add(Quantity<Mili<Second>, std::uint64_t>(1500));
+    c.add(Quantity<Second, std::uint64_t>(2));
+    checkText(registry,
+              "# HELP request_time_seconds_total Time spent on \"requests\".\\n\n"
+              "# TYPE request_time_seconds_total counter\n"
+              "request_time_seconds_total 3.5\n",
+              "counter in milliseconds");
+}
+
+void histogram(){
+    MetricsRegistry registry;
+    Histogram<Mili<Second>>& h = registry.histogram<Mili<Second>>("latency", "Latency.",
+                                                                  {Quantity<Mili<Second>>(1), Quantity<Mili<Second>>(10)});
+    h.observe(Quantity<Mili<Second>>(0.5));
+    h.observe(Quantity<Mili<Second>>(1));
+    h.observe(Quantity<Micro<Second>>(5000));
+    h.observe(Quantity<Second>(1));
+    check(h.count(0) == 2 && h.count(1) == 1 && h.count(2) == 1, "histogram buckets");
+    checkText(registry,
+              "# HELP latency_seconds Latency.\n"
+              "# TYPE latency_seconds histogram\n"
+              "latency_seconds_bucket{le=\"0.001\"} 2\n"
+              "latency_seconds_bucket{le=\"0.01\"} 3\n"
+              "latency_seconds_bucket{le=\"+Inf\"} 4\n"
+              "latency_seconds_sum 1.0065\n"
+              "latency_seconds_count 4\n",
+              "histogram in milliseconds");
+}
+
+void specialValues(){
+    MetricsRegistry registry;
+    registry.gauge<Metre>("nan").set(Quantity<Metre>(std::numeric_limits<double>::quiet_NaN()));
+    registry.gauge<Metre>("negative").set(Quantity<Metre>(-std::numeric_limits<double>::infinity()));
+    registry.gauge<Metre>("positive").set(Quantity<Metre>(std::numeric_limits<double>::infinity()));
+    checkText(registry,
+              "# TYPE nan_meters gauge\n"
+              "nan_meters NaN\n"
+              "# TYPE negative_meters gauge\n"
+              "negative_meters -Inf\n"
+              "# TYPE positive_meters gauge\n"
+              "positive_meters +Inf\n",
+              "infinite and NaN values");
+}
+
+}
+
+int main(){
+    counter();
+    histogram();
+    specialValues();
+    return failures == 0 ? 0 : 1;
+}
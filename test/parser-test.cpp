@@ -0,0 +1,94 @@
+/**
+ * @file parser-test.cpp
+ *
+ * Checks parsing of unit expressions by `parseUnit()` and of quantities by
+ * `fromChars()`, including rejection of expressions nested too deeply or
+ * with exponents out of range.
+ */
+
+#include "unitparser.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+bool parses(std::string_view s, const DynamicUnit& expected){
+    DynamicUnit unit;
+    std::from_chars_result r = parseUnit(s, unit);
+    return r.ec == std::errc() && r.ptr == s.data() + s.size() && unit == expected;
+}
+
+std::errc errorOf(std::string_view s){
+    DynamicUnit unit;
+    std::from_chars_result r = parseUnit(s, unit);
+    return r.ptr == s.data() ? r.ec : std::errc();
+}
+
+typedef Compound<Metre, Power<Second, -2>> Acceleration;
+
+void expressions(){
+    check(parses("m/s^2", DynamicUnit::of<Acceleration>()), "m/s^2");
+    check(parses("m·s⁻²", DynamicUnit::of<Acceleration>()), "m·s⁻²");
+    check(parses("((m))/(s*s)", DynamicUnit::of<Acceleration>()), "((m))/(s*s)");
+    check(parses("km/h", DynamicUnit::of<Compound<Kilo<Metre>, Power<Hour, -1>>>()), "km/h");
+    check(parses("m^127", DynamicUnit::of<Power<Metre, 127>>()), "m^127");
+    check(parses("1/m^127/m", DynamicUnit::of<Power<Metre, -128>>()), "1/m^127/m");
+    check(errorOf("apples") == std::errc::invalid_argument, "unknown symbol");
+    check(errorOf("m^128") == std::errc::result_out_of_range, "m^128");
+    check(errorOf("m^127*m") == std::errc::result_out_of_range, "m^127*m");
+    check(errorOf("(m^127)^2") == std::errc::result_out_of_range, "(m^127)^2");
+    check(errorOf("(((((m^127)^127)^127)^127)^127)") == std::errc::result_out_of_range, "nested powers");
+}
+
+std::errc errorOfNested(std::size_t depth){
+    std::string s = std::string(depth, '(') + "m" + std::string(depth, ')');
+    DynamicUnit unit;
+    return parseUnit(s, unit).ec;
+}
+
+void nesting(){
+    check(errorOfNested(Helper::UnitParser::maxDepth) == std::errc(), "parentheses nested up to the limit");
+    check(errorOfNested(Helper::UnitParser::maxDepth + 1) == std::errc::result_out_of_range, "parentheses nested over the limit");
+    check(errorOfNested(200000) == std::errc::result_out_of_range, "deeply nested parentheses");
+}
+
+template <typename Unit, typename T>
+bool endsAt(std::string_view s, std::size_t pos, std::errc ec, Quantity<Unit, T>& q){
+    std::from_chars_result r = fromChars(s, q);
+    return r.ec == ec && r.ptr == s.data() + pos;
+}
+
+void quantities(){
+    Quantity<Metre, double> d;
+    check(endsAt("12.5 km;", 7, std::errc(), d) && d.value() == 12500, "12.5 km");
+    check(endsAt("1e999 km;", 8, std::errc::result_out_of_range, d) && d.value() == 12500, "value overflowing double");
+    check(endsAt("5 s", 3, std::errc::argument_out_of_domain, d), "value in other dimension");
+    check(endsAt("5 apples", 0, std::errc::invalid_argument, d), "value followed by unknown word");
+
+    Quantity<Metre, std::int32_t> i;
+    check(endsAt("99999999999 mm", 14, std::errc(), i) && i.value() == 99999999, "integral value converted to fit");
+    check(endsAt("99999999999 m", 13, std::errc::result_out_of_range, i) && i.value() == 99999999, "integral value overflowing");
+}
+
+}
+
+int main(){
+    expressions();
+    nesting();
+    quantities();
+    return failures == 0 ? 0 : 1;
+}
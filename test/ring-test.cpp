@@ -0,0 +1,137 @@
+/**
+ * @file ring-test.cpp
+ *
+ * Checks that quantity rings return pushed quantities in order, in unit of
+ * the ring, also across the end of the buffer and with many producers, and
+ * that attaching checks unit, value type and producer mode of the ring.
+ */
+
+#include "quantityring.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace{
+
+using namespace LibUnit;
+
+const std::string name = "/libunit-ring-test-" + std::to_string(::getpid());
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename E, typename F>
+bool throws(F f){
+    try{
+        f();
+    } catch (const E&){
+        return true;
+    }
+    return false;
+}
+
+void singleProducer(){
+    QuantityRing<Metre, std::int32_t> ring(name, 6);
+    QuantityRing<Metre, std::int32_t> consumer(name);
+    check(ring.capacity() == 8, "capacity rounded up to a power of two");
+
+    check(ring.tryPush(Quantity<Metre, std::int32_t>(1)) && ring.tryPush(Quantity<Kilo<Metre>, std::int32_t>(2)), "pushed quantities");
+    std::optional<Quantity<Metre, std::int32_t>> first = consumer.tryPop();
+    std::optional<Quantity<Metre, std::int32_t>> second = consumer.tryPop();
+    check(first && first->value() == 1 && second && second->value() == 2000, "popped quantities in unit of the ring");
+    check(!consumer.tryPop(), "pop from empty ring");
+
+    // Positions are now at 2, so six values fill the ring up to its end and
+    // the next four wrap around.
+    QuantityVector<Metre, std::int32_t> values;
+    for (std::int32_t i=0; i<10; i++)
+        values.push_back(Quantity<Metre, std::int32_t>(i));
+    check(ring.push(values) == 8 && ring.size() == 8, "push of more values than fit");
+    check(!ring.tryPush(Quantity<Metre, std::int32_t>(0)), "push to full ring");
+
+    std::vector<std::size_t> parts;
+    std::int32_t expected = 0;
+    bool ordered = true;
+    std::size_t popped = consumer.consume([&](QuantitySpan<Metre, const std::int32_t> part){
+        parts.push_back(part.size());
+        for (std::size_t i=0; i<part.size(); i++)
+            ordered = ordered && part[i].value() == expected++;
+    });
+    check(popped == 8 && ordered, "consumed values in order");
+    check(parts == std::vector<std::size_t>{6, 2}, "consumed values wrapping around the end of the ring");
+
+    QuantityVector<Mili<Metre>, std::int32_t> millimetres(3, Quantity<Metre, std::int32_t>(3));
+    check(ring.push(millimetres) == 3, "push of values in other unit");
+    QuantityVector<Metre, std::int32_t> out(4, Quantity<Metre, std::int32_t>(0));
+    check(consumer.pop(QuantitySpan<Metre, std::int32_t>(out)) == 3 && out[2].value() == 3, "values converted on push");
+    check(consumer.pop(QuantitySpan<Metre, std::int32_t>(out)) == 0 && ring.size() == 0, "pop from empty ring into array");
+}
+
+void attaching(){
+    QuantityRing<Metre, double> ring(name, 16);
+    check(throws<std::system_error>([]{ QuantityRing<Metre, double> duplicate(name, 16); }), "creation of existing ring");
+    check(throws<DimensionError>([]{ QuantityRing<Second, double> other(name); }), "ring of other dimension");
+    check(throws<std::invalid_argument>([]{ QuantityRing<Kilo<Metre>, double> other(name); }), "ring of other unit");
+    check(throws<std::invalid_argument>([]{ QuantityRing<Metre, float> other(name); }), "ring of other value type");
+    check(throws<std::invalid_argument>([]{ QuantityRing<Metre, double, true> other(name); }), "ring of other producer mode");
+    check(QuantityRing<Kilo<Mili<Metre>>, double>(name).capacity() == 16, "ring of unit of the same signature");
+}
+
+void manyProducers(){
+    constexpr int producers = 4;
+    constexpr std::int64_t count = 20000;
+    QuantityRing<Second, std::int64_t, true> ring(name, 64);
+    std::vector<std::thread> threads;
+    for (int p=0; p<producers; p++)
+        threads.emplace_back([p, &ring]{
+            QuantityRing<Second, std::int64_t, true> producer(name);
+            for (std::int64_t i=0; i<count; i++)
+                while (!producer.tryPush(Quantity<Second, std::int64_t>(i * producers + p)))
+                    std::this_thread::yield();
+        });
+
+    std::vector<std::int64_t> next(producers, 0);
+    bool ordered = true;
+    for (std::int64_t popped = 0; popped < producers * count;){
+        std::optional<Quantity<Second, std::int64_t>> q = ring.tryPop();
+        if (!q){
+            std::this_thread::yield();
+            continue;
+        }
+        std::int64_t p = q->value() % producers;
+        ordered = ordered && q->value() / producers == next[p]++;
+        popped++;
+    }
+    for (std::thread& t: threads)
+        t.join();
+    check(ordered, "values of each producer popped in order");
+    check(!ring.tryPop(), "all values popped");
+}
+
+}
+
+int main(){
+    QuantityRing<Metre>::remove(name);
+    singleProducer();
+    QuantityRing<Metre>::remove(name);
+    attaching();
+    QuantityRing<Metre>::remove(name);
+    manyProducers();
+    QuantityRing<Metre>::remove(name);
+    check(throws<std::system_error>([]{ QuantityRing<Metre> missing(name); }), "attaching to removed ring");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+/**
+ * @file simd-test.cpp
+ *
+ * Checks quantities of `std::experimental::simd` values: loading and storing
+ * with conversion, broadcast conversion factors, comparisons returning
+ * masks, and functions of cmath.h. Skipped if the standard library has no
+ * `<experimental/simd>`.
+ */
+
+#include "simd.h"
+#include "cmath.h"
+#include "units/SI.h"
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+#if __has_include(<experimental/simd>)
+
+namespace{
+
+using namespace LibUnit;
+namespace stdx = std::experimental;
+
+typedef stdx::native_simd<double> V;
+typedef stdx::native_simd<std::int32_t> IV;
+typedef Compound<Metre, Power<Second, -1>> MetrePerSecond;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+template <typename Unit, typename T = double>
+QuantityVector<Unit, T> iota(std::size_t n, T first = 0){
+    QuantityVector<Unit, T> v;
+    for (std::size_t i=0; i<n; i++)
+        v.push_back(Quantity<Unit, T>(first + T(i)));
+    return v;
+}
+
+void loadStore(){
+    constexpr std::size_t n = 4 * V::size();
+    QuantityVector<Metre> distance = iota<Metre>(n, 1.0);
+    QuantityVector<Second> time(n, Quantity<Second>(2));
+    QuantityVector<Compound<Kilo<Metre>, Power<Second, -1>>> speed(n);
+    for (std::size_t i=0; i + V::size() <= n; i += V::size()){
+        Quantity<Metre, V> d = load(distance, i);
+        Quantity<Second, V> t = load(time.span(), i);
+        store(d / t, speed, i);
+    }
+    bool ok = true;
+    for (std::size_t i=0; i<n; i++)
+        ok &= speed[i].value() == (i + 1.0) / 2000;
+    check(ok, "vector quotient stored in other unit");
+
+    Quantity<Metre, V> d = load(distance, V::size());
+    check(reduce(d).value() == double(V::size() * (3 * V::size() + 1) / 2), "sum of elements");
+
+    QuantityVector<Metre, float> narrow = iota<Metre, float>(V::size());
+    Quantity<Metre, V> widened = load<V>(narrow, 0);
+    check(widened.value()[V::size() - 1] == double(V::size() - 1), "load into vector of other element type");
+}
+
+void conversions(){
+    Quantity<Kilo<Metre>, V> km(V([](int i){ return 0.5 * i; }));
+    Quantity<Metre, V> m = km;
+    bool ok = true;
+    for (std::size_t i=0; i<V::size(); i++)
+        ok &= m.value()[i] == 500.0 * i;
+    check(ok, "conversion factor broadcast to elements");
+
+    Quantity<Kilo<Metre>, IV> ikm(IV([](int i){ return i; }));
+    Quantity<Metre, IV> im = ikm;
+    ok = true;
+    for (std::size_t i=0; i<IV::size(); i++)
+        ok &= im.value()[i] == 1000 * std::int32_t(i);
+    check(ok, "integral conversion factor broadcast to elements");
+
+    Quantity<MetrePerSecond, V> v = Quantity<Metre, V>(V(6)) / Quantity<Second, V>(V(3)) + Quantity<Kilo<Metre>, double>(0.5) / Quantity<Second, double>(1);
+    check(stdx::all_of(v.value() == 502), "arithmetic of vector and scalar quantities");
+}
+
+void comparisons(){
+    Quantity<Metre, V> m(V([](int i){ return 1000.0 * i; }));
+    Quantity<Kilo<Metre>, V> km(V(1));
+
+    auto less = m < km;
+    static_assert(std::is_same_v<decltype(less), V::mask_type>);
+    check(less[0] && (V::size() < 2 || !less[1]), "comparison gives mask");
+    check(stdx::popcount(m == km) == (V::size() < 2 ? 0 : 1), "equality of converted elements");
+    check(stdx::all_of(m >= Quantity<Metre, V>(V(0))) && stdx::none_of(m != m), "masks of all elements");
+}
+
+void math(){
+    Quantity<Metre, V> m(V([](int i){ return i % 2 ? -1.25 * i : 1.25 * i; }));
+    Quantity<Metre, V> a = fabs(m);
+    Quantity<Metre, V> f = floor(a);
+    Quantity<Metre, V> c = fmax(a, Quantity<Kilo<Metre>, V>(V(0.002)));
+    bool ok = true;
+    for (std::size_t i=0; i<V::size(); i++){
+        ok &= a.value()[i] == 1.25 * i;
+        ok &= f.value()[i] == double(std::int64_t(1.25 * i));
+        ok &= c.value()[i] == (i < 2 ? 2 : 1.25 * i);
+    }
+    check(ok, "vector math of cmath.h");
+    static_assert(std::is_same_v<decltype(isnan(m)), V::mask_type>);
+    check(stdx::none_of(isnan(m)) && stdx::all_of(isfinite(m)), "classification gives mask");
+}
+
+}
+
+int main(){
+    loadStore();
+    conversions();
+    comparisons();
+    math();
+    return failures == 0 ? 0 : 1;
+}
+
+#else
+
+int main(){
+    // Skipped by automake test driver.
+    return 77;
+}
+
+#endif
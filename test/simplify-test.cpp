@@ -0,0 +1,132 @@
+/**
+ * @file simplify-test.cpp
+ *
+ * Checks results of type-list helpers at compile time: documented examples of
+ * `Join`, `Flatten` and `Simplify`, joining by `Helper::JoinAll`, canonical
+ * forms produced by `Simplify`, and dimensions and factors of units computed
+ * by `DimensionOf` and `FactorOf`.
+ */
+
+#include "unitmanip.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace{
+
+using namespace LibUnit;
+
+class A{};
+class B{};
+class C{};
+class D{};
+
+// Join
+static_assert(std::is_same_v<Join<Compound<A, B>, Compound<C, D>>, Compound<A, B, C, D>>);
+static_assert(std::is_same_v<Join<Compound<A, B>, Compound<>>, Compound<A, B>>);
+static_assert(std::is_same_v<Join<Compound<A, B>, C>, Compound<A, B, C>>);
+static_assert(std::is_same_v<Join<A, Compound<B, C>>, Compound<A, B, C>>);
+static_assert(std::is_same_v<Join<A, B>, Compound<A, B>>);
+static_assert(std::is_same_v<Join<A, Compound<>>, Compound<A>>);
+
+// JoinAll folds Join over its arguments, starting with Compound<>.
+static_assert(std::is_same_v<Helper::JoinAll<>::Type, Compound<>>);
+static_assert(std::is_same_v<Helper::JoinAll<A>::Type, Compound<A>>);
+static_assert(std::is_same_v<Helper::JoinAll<Compound<A, B>, C, Compound<>, Compound<D, A>>::Type, Compound<A, B, C, D, A>>);
+static_assert(std::is_same_v<Helper::JoinAll<Power<A, 2>, Compound<Power<B, -1>>>::Type, Compound<Power<A, 2>, Power<B, -1>>>);
+
+// Flatten
+static_assert(std::is_same_v<Flatten<Compound<Compound<A, B>, Compound<C, D>>>, Compound<A, B, C, D>>);
+static_assert(std::is_same_v<Flatten<Compound<Compound<A, B>, Compound<B, A>>>, Compound<A, B, B, A>>);
+static_assert(std::is_same_v<Flatten<Compound<Compound<A, B>, Compound<>>>, Compound<A, B>>);
+static_assert(std::is_same_v<Flatten<Compound<Compound<A, B>, C>>, Compound<A, B, C>>);
+static_assert(std::is_same_v<Flatten<Compound<A, Power<Compound<B, C>, 2>>>, Compound<A, Power<B, 2>, Power<C, 2>>>);
+static_assert(std::is_same_v<Flatten<Compound<A, Power<Compound<B, Power<C, 3>>, 2>>>, Compound<A, Power<B, 2>, Power<C, 6>>>);
+static_assert(std::is_same_v<Flatten<Compound<A, Power<Compound<B, Power<C, -1>>, 2>>>, Compound<A, Power<B, 2>, Power<C, -2>>>);
+
+// Simplify
+static_assert(std::is_same_v<Simplify<Compound<A, B, A>>, Compound<Power<A, 2>, B>>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 2>, B, A>>, Compound<Power<A, 3>, B>>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 2>, Compound<B, A>>>, Compound<Power<A, 3>, B>>);
+static_assert(std::is_same_v<Simplify<Power<Compound<Power<A, 2>, Compound<B, A>>, 3>>, Compound<Power<A, 9>, Power<B, 3>>>);
+static_assert(std::is_same_v<Simplify<Compound<A>>, A>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 5>>>, Power<A, 5>>);
+
+// Powers are summed at the first occurence of each type, and types of power
+// zero are removed.
+static_assert(std::is_same_v<Simplify<Compound<B, A, Power<B, -1>, C, Power<A, 2>>>, Compound<Power<A, 3>, C>>);
+static_assert(std::is_same_v<Simplify<Compound<A, B, Power<A, -1>, Power<B, -1>>>, Compound<>>);
+static_assert(std::is_same_v<Simplify<Compound<D, C, B, A, Power<C, 2>>>, Compound<D, Power<C, 3>, B, A>>);
+
+// A Compound simplified to a single member is unwrapped, and a merged power
+// of one is the plain type.
+static_assert(std::is_same_v<Simplify<Compound<A, B, Power<B, -1>>>, A>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 2>, Power<A, -1>>>, A>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 3>, B, Power<B, -1>>>, Power<A, 3>>);
+static_assert(std::is_same_v<Simplify<Compound<Power<A, 2>, Power<A, -1>, B>>, Compound<A, B>>);
+static_assert(std::is_same_v<Simplify<Compound<Compound<A>>>, A>);
+static_assert(std::is_same_v<Simplify<Power<A, 1>>, A>);
+static_assert(std::is_same_v<Simplify<Power<Compound<A>, 1>>, A>);
+static_assert(std::is_same_v<Simplify<Power<A, 0>>, Compound<>>);
+static_assert(std::is_same_v<Simplify<Power<Power<A, 2>, -1>>, Power<A, -2>>);
+static_assert(std::is_same_v<Simplify<Compound<>>, Compound<>>);
+static_assert(std::is_same_v<Simplify<A>, A>);
+
+// Raising a Compound to power one is not ambiguous.
+static_assert(std::is_same_v<Helper::Raise<Compound<A, Power<B, 2>>, 1>::Type, Compound<A, Power<B, 2>>>);
+static_assert(std::is_same_v<Helper::Raise<Compound<A, Power<B, 2>>, -2>::Type, Compound<Power<A, -2>, Power<B, -4>>>);
+
+static_assert(IsSimplified<Compound<Power<A, 2>, B>>::value);
+static_assert(!IsSimplified<Compound<A>>::value);
+static_assert(!IsSimplified<Power<A, 1>>::value);
+
+// Units of dimensions A and B.
+class UnA{
+public:
+    typedef A Dimension;
+    static constexpr int factor = 1;
+};
+
+class UnKiloA{
+public:
+    typedef A Dimension;
+    static constexpr ExactFactor factor = ExactFactor::decimal(1, 3);
+};
+
+class UnB{
+public:
+    typedef B Dimension;
+    static constexpr ExactFactor factor = ExactFactor(1, 60);
+};
+
+// DimensionOf keeps structure of a unit, replacing units with dimensions.
+static_assert(std::is_same_v<DimensionOf<UnA>, A>);
+static_assert(std::is_same_v<DimensionOf<Power<UnB, -2>>, Power<B, -2>>);
+static_assert(std::is_same_v<DimensionOf<Compound<UnA, Power<UnB, -1>>>, Compound<A, Power<B, -1>>>);
+static_assert(std::is_same_v<DimensionOf<Compound<UnKiloA, Compound<UnB, UnA>>>, Compound<A, B, A>>);
+static_assert(std::is_same_v<DimensionOf<Compound<>>, Compound<>>);
+static_assert(std::is_same_v<Simplify<DimensionOf<Compound<UnKiloA, Power<UnB, -1>, UnA>>>, Compound<Power<A, 2>, Power<B, -1>>>);
+
+// FactorOf multiplies factors of members raised to their powers.
+static_assert(FactorOf<UnA>::value.isOne());
+static_assert(FactorOf<Compound<>>::value.isOne());
+static_assert(FactorOf<UnKiloA>::value == ExactFactor(1000));
+static_assert(FactorOf<Power<UnKiloA, -2>>::value == ExactFactor::decimal(1, -6));
+static_assert(FactorOf<Compound<UnKiloA, Power<UnB, -1>>>::value == ExactFactor(60000));
+static_assert(FactorOf<Compound<UnKiloA, Power<UnKiloA, -1>, UnB, Power<UnB, -1>>>::value.isOne());
+static_assert(FactorOf<Power<Compound<UnKiloA, UnB>, 2>>::value == ExactFactor(2500, 9));
+
+// Factors equal in value have equal representation, also if their denominator
+// cannot be extended to a power of ten.
+static_assert(ExactFactor(5, 10) == ExactFactor(1, 2) && ExactFactor(1, 2).numerator == 5 && ExactFactor(1, 2).exponent == -1);
+static_assert(ExactFactor(5, std::intmax_t(1) << 62) == ExactFactor(25, std::intmax_t(1) << 61, -1));
+static_assert(ExactFactor(1, std::intmax_t(1) << 40) * ExactFactor(1, std::intmax_t(1) << 20) == ExactFactor(1, std::intmax_t(1) << 60));
+static_assert(ExactFactor(1, std::intmax_t(1) << 60).isRational() && ExactFactor(1, std::intmax_t(1) << 60).rationalDenominator() == std::intmax_t(1) << 60);
+static_assert((ExactFactor(3, std::intmax_t(1) << 62) / ExactFactor(3, std::intmax_t(1) << 62)).isOne());
+static_assert(ExactFactor(0, 7, 3) == ExactFactor(0));
+
+}
+
+int main(){
+    return 0;
+}
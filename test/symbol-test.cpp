@@ -0,0 +1,76 @@
+/**
+ * @file symbol-test.cpp
+ *
+ * Checks that unit symbols written by `SymbolOf` are parsed back as the same
+ * units: every symbol of the parser registry at compile time, and quantities
+ * of every registered unit and of some composed units written by `toString()`
+ * and read by `fromChars()` at run time.
+ */
+
+#include "unitparser.h"
+
+#include <iostream>
+#include <string>
+
+namespace{
+
+using namespace LibUnit;
+
+// Every registered symbol is parsed back as its unit, and no prefixed symbol
+// is spelled like another registered symbol.
+constexpr bool registryRoundTrips(){
+    for (const Helper::UnitSymbol& u: Helper::unitSymbols){
+        DynamicUnit parsed;
+        std::from_chars_result r = parseUnit(u.symbol, parsed);
+        if (r.ec != std::errc() || r.ptr != u.symbol.data() + u.symbol.size() || parsed != u.unit)
+            return false;
+        if (!u.prefixable)
+            continue;
+        for (const Helper::UnitPrefix& p: Helper::unitPrefixes)
+            for (const Helper::UnitSymbol& other: Helper::unitSymbols)
+                if (other.symbol.size() == p.symbol.size() + u.symbol.size() && other.symbol.starts_with(p.symbol)
+                        && other.symbol.ends_with(u.symbol))
+                    return false;
+    }
+    return true;
+}
+
+static_assert(registryRoundTrips(), "Unit symbols are not parsed back as their units.");
+
+int failures = 0;
+
+template <typename Unit>
+void roundTrip(){
+    Quantity<Unit> q(2.5);
+    std::string s = toString(q);
+    Quantity<Unit> parsed;
+    std::from_chars_result r = fromChars(s, parsed);
+    if (r.ec != std::errc() || r.ptr != s.data() + s.size() || parsed.value() != q.value()){
+        std::cerr << "round trip failed: " << s << " read as " << parsed.value() << std::endl;
+        failures++;
+    }
+}
+
+template <typename ...Units>
+void roundTrips(){
+    (roundTrip<Units>(), ...);
+}
+
+}
+
+int main(){
+    roundTrips<Metre, Gram, Second, Ampere, Kelvin, Mole, Candela,
+               Newton, Pascal, Joule, Watt, Coulomb, Volt, Farad, Ohm, Siemens, Weber, Tesla, Henry, Lux, Katal,
+               Minute, Hour, Day, PlaneDegree, PlaneMinute, PlaneSecond, Hectare, Litre, Tonne, ElectronVolt,
+               AtomicMass, AstronomicalUnit, Angstrom, Are, Barn, Bar, Atmosphere, MillimetreOfMercury, Torr>();
+    roundTrips<Imperial::Thou, Imperial::Inch, Imperial::Foot, Imperial::Yard, Imperial::Chain, Imperial::Furlong,
+               Imperial::Mile, Imperial::League, Imperial::Fathom, Imperial::Cable, Imperial::NauticalMile,
+               Imperial::Link, Imperial::Rod, Imperial::Perch, Imperial::Rood, Imperial::Acre, Imperial::FluidOunce,
+               Imperial::Gill, Imperial::Pint, Imperial::Quart, Imperial::Gallon, Imperial::Grain, Imperial::Drachm,
+               Imperial::Ounce, Imperial::Pound, Imperial::Stone, Imperial::Quarter,
+               Imperial::ImperialHundredweight, Imperial::ImperialTon>();
+    roundTrips<Kilo<Gram>, Kilo<Pascal>, Mili<Litre>, Mega<Watt>, Compound<Kilo<Metre>, Power<Hour, -1>>,
+               Compound<Second, Power<Kilo<Metre>, -1>>, Compound<Power<Newton, 1>, Metre>, Power<Kilo<Metre>, 2>,
+               Compound<Imperial::Mile, Power<Hour, -1>>>();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file vector-test.cpp
+ *
+ * Checks units and values of quantity array expressions, and assignment of
+ * expressions that read the assigned vector.
+ */
+
+#include "quantityvector.h"
+#include "units/SI.h"
+
+#include <iostream>
+#include <type_traits>
+
+namespace{
+
+using namespace LibUnit;
+
+typedef Compound<Metre, Power<Second, -1>> MetrePerSecond;
+
+int failures = 0;
+
+void check(bool ok, const char* what){
+    if (!ok){
+        std::cerr << "failed: " << what << std::endl;
+        failures++;
+    }
+}
+
+QuantityVector<Metre> iota(std::size_t n){
+    QuantityVector<Metre> v;
+    for (std::size_t i=0; i<n; i++)
+        v.push_back(Quantity<Metre>(double(i)));
+    return v;
+}
+
+void expressions(){
+    QuantityVector<Metre> m = iota(8);
+    QuantityVector<Kilo<Metre>> km(8, Quantity<Metre>(1000));
+    QuantityVector<Second> s(8, Quantity<Second>(2));
+
+    static_assert(std::is_same_v<decltype(m + km)::UnitType, Metre>);
+    static_assert(std::is_same_v<decltype(km - m)::UnitType, Kilo<Metre>>);
+    static_assert(std::is_same_v<decltype(m * 2.0)::UnitType, Metre>);
+    static_assert(std::is_same_v<decltype(m * s)::UnitType, Simplify<Join<Metre, Second>>>);
+    static_assert(std::is_same_v<decltype(m / s)::UnitType, Simplify<Join<Metre, Invert<Second>>>>);
+    static_assert(std::is_same_v<decltype(2.0 / s)::UnitType, Invert<Second>>);
+
+    QuantityVector sum = m + km;
+    check(sum.size() == 8 && sum[3].value() == 1003, "sum is scaled to unit of left operand");
+    QuantityVector<Kilo<Metre>> difference = km - m;
+    check(difference[4].value() == 0.996, "difference is scaled to unit of left operand");
+    QuantityVector<MetrePerSecond> speed = (m + km) / s;
+    check(speed[2].value() == 501, "quotient of sum");
+    QuantityVector<Kilo<Metre>> scaled = m * 2.0;
+    check(scaled[5].value() == 0.01, "assignment scales to unit of vector");
+
+    bool thrown = false;
+    try{
+        QuantityVector<Metre> bad = m + iota(3);
+    }
+    catch (std::invalid_argument&){
+        thrown = true;
+    }
+    check(thrown, "different sizes throw");
+}
+
+void aliasing(){
+    // Smaller expression reading this vector; evaluated before the buffer is
+    // replaced.
+    QuantityVector<Metre> v = iota(100);
+    v = v.span().subspan(0, 10) * 2.0;
+    check(v.size() == 10 && v[0].value() == 0 && v[9].value() == 18, "assignment of smaller expression of itself");
+
+    // Larger expression reading this vector.
+    QuantityVector<Metre> w = iota(4);
+    QuantityVector<Metre> x = iota(16);
+    w = x + x * 1.0;
+    check(w.size() == 16 && w[15].value() == 30, "assignment of larger expression");
+    w = w.span().subspan(8, 8) + w.span().subspan(0, 8);
+    check(w.size() == 8 && w[0].value() == 16 && w[7].value() == 44, "assignment of expression of two parts of itself");
+
+    // Same size; evaluated in place.
+    QuantityVector<Metre> y = iota(16);
+    y = y + y;
+    check(y[15].value() == 30, "assignment of equal size expression of itself");
+}
+
+}
+
+int main(){
+    expressions();
+    aliasing();
+    return failures == 0 ? 0 : 1;
+}